@@ -22,21 +22,38 @@ macro(face_recog_add_sources)
     set(FaceRecog_HEADER_FILES ${FaceRecog_HEADER_FILES} ${FaceRecog_HEADERS_DIRS}/Classifiers/ClassifierEnsembleTM.h)
     set(FaceRecog_HEADER_FILES ${FaceRecog_HEADER_FILES} ${FaceRecog_HEADERS_DIRS}/Classifiers/ClassifierFaceNet.h)
     set(FaceRecog_HEADER_FILES ${FaceRecog_HEADER_FILES} ${FaceRecog_HEADERS_DIRS}/Classifiers/ClassifierType.h)
+    set(FaceRecog_HEADER_FILES ${FaceRecog_HEADER_FILES} ${FaceRecog_HEADERS_DIRS}/Classifiers/GalleryIndex.h)
     set(FaceRecog_HEADER_FILES ${FaceRecog_HEADER_FILES} ${FaceRecog_HEADERS_DIRS}/Classifiers/IClassifier.h)
+    set(FaceRecog_HEADER_FILES ${FaceRecog_HEADER_FILES} ${FaceRecog_HEADERS_DIRS}/Classifiers/SharedCellHOG.h)
     set(FaceRecog_HEADER_FILES ${FaceRecog_HEADER_FILES} ${FaceRecog_HEADERS_DIRS}/Classifiers/TemplateMatcher.h)
     set(FaceRecog_HEADER_FILES ${FaceRecog_HEADER_FILES} ${FaceRecog_HEADERS_DIRS}/Configs/ConfigFile.h)
+    set(FaceRecog_HEADER_FILES ${FaceRecog_HEADER_FILES} ${FaceRecog_HEADERS_DIRS}/Configs/ConfigStore.h)
     set(FaceRecog_HEADER_FILES ${FaceRecog_HEADER_FILES} ${FaceRecog_HEADERS_DIRS}/Configs/ConsoleOptions.h)
     set(FaceRecog_HEADER_FILES ${FaceRecog_HEADER_FILES} ${FaceRecog_HEADERS_DIRS}/Configs/Platform.h)
     set(FaceRecog_HEADER_FILES ${FaceRecog_HEADER_FILES} ${FaceRecog_HEADERS_DIRS}/Configs/Version.h)
     set(FaceRecog_HEADER_FILES ${FaceRecog_HEADER_FILES} ${FaceRecog_HEADERS_DIRS}/Detectors/DetectorType.h)
     set(FaceRecog_HEADER_FILES ${FaceRecog_HEADER_FILES} ${FaceRecog_HEADERS_DIRS}/Detectors/EyeDetector.h)
+    set(FaceRecog_HEADER_FILES ${FaceRecog_HEADER_FILES} ${FaceRecog_HEADERS_DIRS}/Detectors/FaceDetectorDNN.h)
     set(FaceRecog_HEADER_FILES ${FaceRecog_HEADER_FILES} ${FaceRecog_HEADERS_DIRS}/Detectors/FaceDetectorFRCNN.h)
     set(FaceRecog_HEADER_FILES ${FaceRecog_HEADER_FILES} ${FaceRecog_HEADERS_DIRS}/Detectors/FaceDetectorSSD.h)
     set(FaceRecog_HEADER_FILES ${FaceRecog_HEADER_FILES} ${FaceRecog_HEADERS_DIRS}/Detectors/FaceDetectorVJ.h)
     set(FaceRecog_HEADER_FILES ${FaceRecog_HEADER_FILES} ${FaceRecog_HEADERS_DIRS}/Detectors/FaceDetectorYOLO.h)
     set(FaceRecog_HEADER_FILES ${FaceRecog_HEADER_FILES} ${FaceRecog_HEADERS_DIRS}/Detectors/IDetector.h)
+    set(FaceRecog_HEADER_FILES ${FaceRecog_HEADER_FILES} ${FaceRecog_HEADERS_DIRS}/Pipeline/DetectionScheduler.h)
+    set(FaceRecog_HEADER_FILES ${FaceRecog_HEADER_FILES} ${FaceRecog_HEADERS_DIRS}/Pipeline/FrameContext.h)
+    set(FaceRecog_HEADER_FILES ${FaceRecog_HEADER_FILES} ${FaceRecog_HEADERS_DIRS}/Pipeline/FrameSequenceReader.h)
+    set(FaceRecog_HEADER_FILES ${FaceRecog_HEADER_FILES} ${FaceRecog_HEADERS_DIRS}/Pipeline/LoadSheddingScheduler.h)
+    set(FaceRecog_HEADER_FILES ${FaceRecog_HEADER_FILES} ${FaceRecog_HEADERS_DIRS}/Pipeline/OutputWriter.h)
+    set(FaceRecog_HEADER_FILES ${FaceRecog_HEADER_FILES} ${FaceRecog_HEADERS_DIRS}/Pipeline/Pipeline.h)
+    set(FaceRecog_HEADER_FILES ${FaceRecog_HEADER_FILES} ${FaceRecog_HEADERS_DIRS}/Pipeline/ProbeExtractor.h)
+    set(FaceRecog_HEADER_FILES ${FaceRecog_HEADER_FILES} ${FaceRecog_HEADERS_DIRS}/Pipeline/RecognitionScheduler.h)
+    set(FaceRecog_HEADER_FILES ${FaceRecog_HEADER_FILES} ${FaceRecog_HEADERS_DIRS}/Pipeline/SequenceEvaluator.h)
+    set(FaceRecog_HEADER_FILES ${FaceRecog_HEADER_FILES} ${FaceRecog_HEADERS_DIRS}/Pipeline/StreamProcessor.h)
+    set(FaceRecog_HEADER_FILES ${FaceRecog_HEADER_FILES} ${FaceRecog_HEADERS_DIRS}/Pipeline/StreamScheduler.h)
+    set(FaceRecog_HEADER_FILES ${FaceRecog_HEADER_FILES} ${FaceRecog_HEADERS_DIRS}/Pipeline/StreamSource.h)
     set(FaceRecog_HEADER_FILES ${FaceRecog_HEADER_FILES} ${FaceRecog_HEADERS_DIRS}/Python/PyCvBoostConverter.h)
     set(FaceRecog_HEADER_FILES ${FaceRecog_HEADER_FILES} ${FaceRecog_HEADERS_DIRS}/Python/PythonInterop.h)
+    set(FaceRecog_HEADER_FILES ${FaceRecog_HEADER_FILES} ${FaceRecog_HEADERS_DIRS}/Python/PythonSession.h)
     set(FaceRecog_HEADER_FILES ${FaceRecog_HEADER_FILES} ${FaceRecog_HEADERS_DIRS}/Trackers/ITracker.h)
     set(FaceRecog_HEADER_FILES ${FaceRecog_HEADER_FILES} ${FaceRecog_HEADERS_DIRS}/Trackers/TrackerCamshift.h)
     set(FaceRecog_HEADER_FILES ${FaceRecog_HEADER_FILES} ${FaceRecog_HEADERS_DIRS}/Trackers/TrackerCompressive.h)
@@ -50,6 +67,7 @@ macro(face_recog_add_sources)
     set(FaceRecog_HEADER_FILES ${FaceRecog_HEADER_FILES} ${FaceRecog_HEADERS_DIRS}/Tracks/ImageRep.h)
     set(FaceRecog_HEADER_FILES ${FaceRecog_HEADER_FILES} ${FaceRecog_HEADERS_DIRS}/Tracks/Kernels.h)
     set(FaceRecog_HEADER_FILES ${FaceRecog_HEADER_FILES} ${FaceRecog_HEADERS_DIRS}/Tracks/LaRank.h)
+    set(FaceRecog_HEADER_FILES ${FaceRecog_HEADER_FILES} ${FaceRecog_HEADERS_DIRS}/Tracks/MotionPredictor.h)
     set(FaceRecog_HEADER_FILES ${FaceRecog_HEADER_FILES} ${FaceRecog_HEADERS_DIRS}/Tracks/Rect.h)
     set(FaceRecog_HEADER_FILES ${FaceRecog_HEADER_FILES} ${FaceRecog_HEADERS_DIRS}/Tracks/Sample.h)
     set(FaceRecog_HEADER_FILES ${FaceRecog_HEADER_FILES} ${FaceRecog_HEADERS_DIRS}/Tracks/Sampler.h)
@@ -60,6 +78,7 @@ macro(face_recog_add_sources)
     set(FaceRecog_HEADER_FILES ${FaceRecog_HEADER_FILES} ${FaceRecog_HEADERS_DIRS}/Utilities/Macros.h)
     set(FaceRecog_HEADER_FILES ${FaceRecog_HEADER_FILES} ${FaceRecog_HEADERS_DIRS}/Utilities/MatDefines.h)
     set(FaceRecog_HEADER_FILES ${FaceRecog_HEADER_FILES} ${FaceRecog_HEADERS_DIRS}/Utilities/MultiColorType.h)
+    set(FaceRecog_HEADER_FILES ${FaceRecog_HEADER_FILES} ${FaceRecog_HEADERS_DIRS}/Utilities/ThreadPool.h)
     set(FaceRecog_HEADER_FILES ${FaceRecog_HEADER_FILES} ${FaceRecog_HEADERS_DIRS}/Utilities/Utilities.h)
 
     # source files
@@ -70,19 +89,36 @@ macro(face_recog_add_sources)
     set(FaceRecog_SOURCE_FILES ${FaceRecog_SOURCE_FILES} ${FaceRecog_SOURCES_DIRS}/Classifiers/ClassifierEnsembleTM.cpp)
     set(FaceRecog_SOURCE_FILES ${FaceRecog_SOURCE_FILES} ${FaceRecog_SOURCES_DIRS}/Classifiers/ClassifierFaceNet.cpp)
     set(FaceRecog_SOURCE_FILES ${FaceRecog_SOURCE_FILES} ${FaceRecog_SOURCES_DIRS}/Classifiers/ClassifierType.cpp)
+    set(FaceRecog_SOURCE_FILES ${FaceRecog_SOURCE_FILES} ${FaceRecog_SOURCES_DIRS}/Classifiers/GalleryIndex.cpp)
     set(FaceRecog_SOURCE_FILES ${FaceRecog_SOURCE_FILES} ${FaceRecog_SOURCES_DIRS}/Classifiers/IClassifier.cpp)
+    set(FaceRecog_SOURCE_FILES ${FaceRecog_SOURCE_FILES} ${FaceRecog_SOURCES_DIRS}/Classifiers/SharedCellHOG.cpp)
     set(FaceRecog_SOURCE_FILES ${FaceRecog_SOURCE_FILES} ${FaceRecog_SOURCES_DIRS}/Classifiers/TemplateMatcher.cpp)
     set(FaceRecog_SOURCE_FILES ${FaceRecog_SOURCE_FILES} ${FaceRecog_SOURCES_DIRS}/Configs/ConfigFile.cpp)
+    set(FaceRecog_SOURCE_FILES ${FaceRecog_SOURCE_FILES} ${FaceRecog_SOURCES_DIRS}/Configs/ConfigStore.cpp)
     set(FaceRecog_SOURCE_FILES ${FaceRecog_SOURCE_FILES} ${FaceRecog_SOURCES_DIRS}/Detectors/DetectorType.cpp)
     set(FaceRecog_SOURCE_FILES ${FaceRecog_SOURCE_FILES} ${FaceRecog_SOURCES_DIRS}/Detectors/EyeDetector.cpp)
+    set(FaceRecog_SOURCE_FILES ${FaceRecog_SOURCE_FILES} ${FaceRecog_SOURCES_DIRS}/Detectors/FaceDetectorDNN.cpp)
     set(FaceRecog_SOURCE_FILES ${FaceRecog_SOURCE_FILES} ${FaceRecog_SOURCES_DIRS}/Detectors/FaceDetectorFRCNN.cpp)
     set(FaceRecog_SOURCE_FILES ${FaceRecog_SOURCE_FILES} ${FaceRecog_SOURCES_DIRS}/Detectors/FaceDetectorSSD.cpp)
     set(FaceRecog_SOURCE_FILES ${FaceRecog_SOURCE_FILES} ${FaceRecog_SOURCES_DIRS}/Detectors/FaceDetectorVJ.cpp)
     set(FaceRecog_SOURCE_FILES ${FaceRecog_SOURCE_FILES} ${FaceRecog_SOURCES_DIRS}/Detectors/FaceDetectorYOLO.cpp)
     set(FaceRecog_SOURCE_FILES ${FaceRecog_SOURCE_FILES} ${FaceRecog_SOURCES_DIRS}/Detectors/IDetector.cpp)
+    set(FaceRecog_SOURCE_FILES ${FaceRecog_SOURCE_FILES} ${FaceRecog_SOURCES_DIRS}/Pipeline/DetectionScheduler.cpp)
+    set(FaceRecog_SOURCE_FILES ${FaceRecog_SOURCE_FILES} ${FaceRecog_SOURCES_DIRS}/Pipeline/FrameContext.cpp)
+    set(FaceRecog_SOURCE_FILES ${FaceRecog_SOURCE_FILES} ${FaceRecog_SOURCES_DIRS}/Pipeline/FrameSequenceReader.cpp)
+    set(FaceRecog_SOURCE_FILES ${FaceRecog_SOURCE_FILES} ${FaceRecog_SOURCES_DIRS}/Pipeline/LoadSheddingScheduler.cpp)
+    set(FaceRecog_SOURCE_FILES ${FaceRecog_SOURCE_FILES} ${FaceRecog_SOURCES_DIRS}/Pipeline/OutputWriter.cpp)
+    set(FaceRecog_SOURCE_FILES ${FaceRecog_SOURCE_FILES} ${FaceRecog_SOURCES_DIRS}/Pipeline/Pipeline.cpp)
+    set(FaceRecog_SOURCE_FILES ${FaceRecog_SOURCE_FILES} ${FaceRecog_SOURCES_DIRS}/Pipeline/ProbeExtractor.cpp)
+    set(FaceRecog_SOURCE_FILES ${FaceRecog_SOURCE_FILES} ${FaceRecog_SOURCES_DIRS}/Pipeline/RecognitionScheduler.cpp)
+    set(FaceRecog_SOURCE_FILES ${FaceRecog_SOURCE_FILES} ${FaceRecog_SOURCES_DIRS}/Pipeline/SequenceEvaluator.cpp)
+    set(FaceRecog_SOURCE_FILES ${FaceRecog_SOURCE_FILES} ${FaceRecog_SOURCES_DIRS}/Pipeline/StreamProcessor.cpp)
+    set(FaceRecog_SOURCE_FILES ${FaceRecog_SOURCE_FILES} ${FaceRecog_SOURCES_DIRS}/Pipeline/StreamScheduler.cpp)
+    set(FaceRecog_SOURCE_FILES ${FaceRecog_SOURCE_FILES} ${FaceRecog_SOURCES_DIRS}/Pipeline/StreamSource.cpp)
     set(FaceRecog_SOURCE_FILES ${FaceRecog_SOURCE_FILES} ${FaceRecog_SOURCES_DIRS}/Python/PyCvBoostConverter.cpp)
     set(FaceRecog_SOURCE_FILES ${FaceRecog_SOURCE_FILES} ${FaceRecog_SOURCES_DIRS}/Python/PythonInterop.cpp)
     set(FaceRecog_SOURCE_FILES ${FaceRecog_SOURCE_FILES} ${FaceRecog_SOURCES_DIRS}/Python/PythonModule.cpp)
+    set(FaceRecog_SOURCE_FILES ${FaceRecog_SOURCE_FILES} ${FaceRecog_SOURCES_DIRS}/Python/PythonSession.cpp)
     set(FaceRecog_SOURCE_FILES ${FaceRecog_SOURCE_FILES} ${FaceRecog_SOURCES_DIRS}/Trackers/TrackerCamshift.cpp)
     set(FaceRecog_SOURCE_FILES ${FaceRecog_SOURCE_FILES} ${FaceRecog_SOURCES_DIRS}/Trackers/TrackerCompressive.cpp)
     set(FaceRecog_SOURCE_FILES ${FaceRecog_SOURCE_FILES} ${FaceRecog_SOURCES_DIRS}/Trackers/TrackerKCF.cpp)
@@ -94,10 +130,12 @@ macro(face_recog_add_sources)
     set(FaceRecog_SOURCE_FILES ${FaceRecog_SOURCE_FILES} ${FaceRecog_SOURCES_DIRS}/Tracks/Hungarian.cpp)
     set(FaceRecog_SOURCE_FILES ${FaceRecog_SOURCE_FILES} ${FaceRecog_SOURCES_DIRS}/Tracks/ImageRep.cpp)
     set(FaceRecog_SOURCE_FILES ${FaceRecog_SOURCE_FILES} ${FaceRecog_SOURCES_DIRS}/Tracks/LaRank.cpp)
+    set(FaceRecog_SOURCE_FILES ${FaceRecog_SOURCE_FILES} ${FaceRecog_SOURCES_DIRS}/Tracks/MotionPredictor.cpp)
     set(FaceRecog_SOURCE_FILES ${FaceRecog_SOURCE_FILES} ${FaceRecog_SOURCES_DIRS}/Tracks/Sampler.cpp)
     set(FaceRecog_SOURCE_FILES ${FaceRecog_SOURCE_FILES} ${FaceRecog_SOURCES_DIRS}/Tracks/Track.cpp)
     set(FaceRecog_SOURCE_FILES ${FaceRecog_SOURCE_FILES} ${FaceRecog_SOURCES_DIRS}/Tracks/TrackROI.cpp)
     set(FaceRecog_SOURCE_FILES ${FaceRecog_SOURCE_FILES} ${FaceRecog_SOURCES_DIRS}/Utilities/MultiColorType.cpp)
+    set(FaceRecog_SOURCE_FILES ${FaceRecog_SOURCE_FILES} ${FaceRecog_SOURCES_DIRS}/Utilities/ThreadPool.cpp)
     set(FaceRecog_SOURCE_FILES ${FaceRecog_SOURCE_FILES} ${FaceRecog_SOURCES_DIRS}/Utilities/Utilities.cpp)
 endmacro()
 
@@ -180,6 +218,13 @@ macro(face_recog_update_modules)
         remove_definitions(-DFACE_RECOG_HAS_VJ)
     endif()
 
+    # OpenCV DNN
+    if(${FaceRecog_ENABLE_DNN})
+        add_definitions(-DFACE_RECOG_HAS_DNN)
+    else()
+        remove_definitions(-DFACE_RECOG_HAS_DNN)
+    endif()
+
     # FRCNN
     if(${FaceRecog_ENABLE_FRCNN})
         if(NOT ${WITH_Python})
@@ -193,22 +238,9 @@ macro(face_recog_update_modules)
 
     # KCF
     if(${FaceRecog_ENABLE_KCF})
-        message("KCF selected, verify implementation to employ")
-        set(FaceRecog_KCF_IMPL)
-        set(FaceRecog_KCF_OPENCV    "OpenCV")
-        set(FaceRecog_KCF_JOAO_FARO "Joao Faro")
-        set(FaceRecog_KCF_IMPL ${FaceRecog_KCF_OPENCV} CACHE STRING "KCF implementation to employ")
-        set_property(CACHE FaceRecog_KCF_IMPL PROPERTY STRINGS ${FaceRecog_KCF_OPENCV} ${FaceRecog_KCF_JOAO_FARO})
         add_definitions(-DFACE_RECOG_HAS_KCF)
-    endif()
-    if  (${FaceRecog_ENABLE_KCF} AND ${FaceRecog_KCF_IMPL} STREQUAL ${FaceRecog_KCF_OPENCV})
-        add_definitions(-DFACE_RECOG_KCF_OPENCV)
-    elif(${FaceRecog_ENABLE_KCF} AND ${FaceRecog_KCF_IMPL} STREQUAL ${FaceRecog_KCF_JOAO_FARO})
-        add_definitions(-DFACE_RECOG_KCF_JOAO_FARO)
     else()
         remove_definitions(-DFACE_RECOG_HAS_KCF)
-        remove_definitions(-DFACE_RECOG_KCF_OPENCV)
-        remove_definitions(-DFACE_RECOG_KCF_JOAO_FARO)
     endif()
 
     # SSD
@@ -496,6 +528,7 @@ macro(face_recog_display_summary)
     status("FaceRecog Options:")
     status("    Enable Camshift:    ${FaceRecog_ENABLE_Camshift}")
     status("    Enable Compressive: ${FaceRecog_ENABLE_Compressive}")
+    status("    Enable DNN:         ${FaceRecog_ENABLE_DNN}")
     status("    Enable ESVM:        ${FaceRecog_ENABLE_ESVM}")
     status("    Enable FRCNN:       ${FaceRecog_ENABLE_FRCNN}")
     status("    Enable FaceNet:     ${FaceRecog_ENABLE_FaceNet}")
@@ -5,6 +5,7 @@
 #include "Utilities/MatDefines.h"
 #include "Classifiers/IClassifier.h"
 #include "esvmEnsemble.h"
+#include <mutex>
 //using namespace esvm;
 
 class ClassifierEnsembleESVM final : public IClassifier
@@ -17,9 +18,10 @@ public:
                            const std::vector<std::vector<FACE_RECOG_MAT> >& additionalNegativeROIs = {},
                            const std::string& modelsFileDir = "");
     inline virtual void initialise() override {}
-    std::vector<double> predict(const FACE_RECOG_MAT& roi) override;
+    std::vector<double> predict(const FACE_RECOG_MAT& roi) const override;
 private:
     std::shared_ptr<esvmEnsemble> EoESVM;
+    mutable std::mutex predictMutex;        // external ensemble not known to be reentrant
 };
 
 #endif /*CLASSIFIER_ENSEMBLE_ESVM_H*/
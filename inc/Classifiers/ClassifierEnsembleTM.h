@@ -12,10 +12,18 @@ public:
     ClassifierEnsembleTM();
     ClassifierEnsembleTM(const std::vector<std::vector<FACE_RECOG_MAT> >& positiveROIs, const std::string negativeFileDir,
                          const std::vector<std::string>& positiveIDs = {},
-                         const std::vector<std::vector<FACE_RECOG_MAT> >& additionalNegativeROIs = {});
+                         const std::vector<std::vector<FACE_RECOG_MAT> >& additionalNegativeROIs = {},
+                         bool useSharedCellHOG = false);
     ~ClassifierEnsembleTM() {}
     void initialise() override;
-    std::vector<double> predict(const FACE_RECOG_MAT& roi) override;
+    std::vector<double> predict(const FACE_RECOG_MAT& roi) const override;
+    std::vector<std::vector<double> > predictBatch(const std::vector<FACE_RECOG_MAT>& rois) const override;
+    cv::Size getProbeSize() const override;
+    void setGalleryIndex(size_t shortlistSize, int listCount, int probeCount, size_t exactMaxSize);
+    void setQuantization(TemplateMatcher::Quantization mode);
+    void releaseExactTemplates();
+    TemplateQuantizationReport evaluateQuantization(const std::vector<FACE_RECOG_MAT>& probes);
+    double evaluateBatchScoring(const std::vector<FACE_RECOG_MAT>& probes) const;
     std::string targetID;
 private:
     std::shared_ptr<TemplateMatcher> TM;
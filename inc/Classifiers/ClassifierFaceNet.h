@@ -12,12 +12,13 @@ public:
     ClassifierFaceNet(std::vector<cv::Mat> positiveROIs, std::string negativeFileDir, std::vector<std::string> positiveIDs = {}) {}
     ~ClassifierFaceNet();
     inline virtual void initialise() override {}
-    std::vector<double> predict(const FACE_RECOG_MAT& roi) override;
+    std::vector<double> predict(const FACE_RECOG_MAT& roi) const override;   // calls serialized by the python session
 private:
     std::string folderPath = "../python";
     std::string filePath = "../python";
     std::string pyFuncInit = "face_detect";
     std::string pyFuncPredict = "face_detect";
+    size_t pyFuncHandle;                // loaded and initialized once in the persistent python session
     std::vector<cv::Rect> m_faces;
 };
 
@@ -0,0 +1,38 @@
+﻿#ifndef FACE_RECOG_GALLERY_INDEX_H
+#define FACE_RECOG_GALLERY_INDEX_H
+
+#include "Utilities/Common.h"
+#include "Utilities/MatDefines.h"
+
+/*
+    Approximate nearest neighbour index over enrolled gallery descriptors (inverted file)
+
+    Descriptors are clustered with k-means into lists, and a probe only visits the descriptors of its
+    nearest lists. Search returns the labels (ex: positive indexes) of the nearest descriptors so that
+    exact scoring can be limited to that shortlist. Visiting more lists improves recall at the cost of speed.
+    Descriptors are only kept as int8 codes (single scale/offset) since the shortlist is rescored exactly.
+*/
+class GalleryIndex
+{
+public:
+    GalleryIndex() : probeCount(1) {}
+    void build(const std::vector<FeatureVector>& descriptors, const std::vector<size_t>& labels, int listCount = 0, int probeCount = 1);
+    std::vector<size_t> search(const FeatureVector& probe, size_t shortlistSize) const;     // labels of nearest descriptors, nearest first
+    inline bool empty() const       { return centroids.empty(); }
+    inline size_t size() const      { return (size_t)codes.rows; }
+    inline int getListCount() const { return centroids.rows; }
+
+private:
+    cv::Mat encode(const FeatureVector& descriptor) const;
+
+    cv::Mat codes;                          // one quantized descriptor per row (CV_8U)
+    double codeScale;                       // feature units per code step
+    double codeOffset;                      // feature value of code zero
+    std::vector<size_t> labels;             // label of each descriptor
+    size_t labelCount;
+    cv::Mat centroids;                      // one list centroid per row (CV_32F)
+    std::vector<std::vector<int> > lists;   // descriptor rows assigned to each list
+    int probeCount;                         // number of nearest lists visited by a search
+};
+
+#endif/*FACE_RECOG_GALLERY_INDEX_H*/
@@ -10,7 +10,10 @@ class IClassifier
 public:
     virtual ~IClassifier() {}
     virtual void initialise() = 0;
-    virtual std::vector<double> predict(const FACE_RECOG_MAT& roi) = 0;
+    // predictions must be reentrant, a single classifier is shared by all concurrent streams
+    virtual std::vector<double> predict(const FACE_RECOG_MAT& roi) const = 0;
+    virtual std::vector<std::vector<double> > predictBatch(const std::vector<FACE_RECOG_MAT>& rois) const;  // [roi][target]
+    virtual cv::Size getProbeSize() const { return cv::Size(); }   // normalized gray probe size if supported, otherwise original crop
 };
 
 std::shared_ptr<IClassifier> buildSpecializedClassifier(const ConfigFile& config,
@@ -0,0 +1,39 @@
+﻿#ifndef FACE_RECOG_SHARED_CELL_HOG_H
+#define FACE_RECOG_SHARED_CELL_HOG_H
+
+#include "Utilities/Common.h"
+#include "Utilities/MatDefines.h"
+
+/*
+    HOG descriptors of all patches of a normalized face computed from a single cell grid
+
+    Gradients and orientation histograms of cells are evaluated once over the whole image, and each patch
+    descriptor is obtained by concatenating its L2-Hys normalized blocks sliced out of the shared cell grid.
+    Block size and stride are specified in cells, cell size in pixels, and patches must align on cells.
+*/
+class SharedCellHOG
+{
+public:
+    SharedCellHOG() {}
+    void initialize(cv::Size imageSize, cv::Size patchCounts, cv::Size blockSize, cv::Size blockStride, cv::Size cellSize, int nBins);
+    std::vector<FeatureVector> compute(const cv::Mat& image) const;                                // [patch](FeatureVector)
+    std::vector<std::vector<FeatureVector> > compute(const std::vector<cv::Mat>& images) const;    // [image][patch](FeatureVector)
+    inline size_t getPatchCount() const     { return (size_t)patchCounts.area(); }
+    inline size_t getFeatureCount() const   { return featureCount; }                               // per patch
+
+private:
+    void computeCells(const cv::Mat& image, std::vector<float>& cells) const;
+
+    cv::Size imageSize;
+    cv::Size patchCounts;
+    cv::Size blockSize;         // cells per block
+    cv::Size blockStride;       // cells between blocks
+    cv::Size cellSize;          // pixels per cell
+    cv::Size cellCounts;        // cells in whole image
+    cv::Size patchCells;        // cells per patch
+    cv::Size patchBlocks;       // blocks per patch
+    int nBins = 0;
+    size_t featureCount = 0;
+};
+
+#endif/*FACE_RECOG_SHARED_CELL_HOG_H*/
@@ -3,17 +3,43 @@
 
 #include "Utilities/Common.h"
 #include "Utilities/MatDefines.h"
+#include "Classifiers/GalleryIndex.h"
+#include "Classifiers/SharedCellHOG.h"
 #include "feHOG.h"
 
+/* Scores differences between full precision and quantized templates */
+struct TemplateQuantizationReport
+{
+    size_t probeCount = 0;
+    double maxAbsError = 0;             // largest score difference for any probe and positive
+    double meanAbsError = 0;
+    double rankAgreement = 1;           // ratio of probes with identical best positive
+    size_t exactBytes = 0;              // memory of full precision templates
+    size_t quantizedBytes = 0;          // memory of quantized templates
+};
+
 class TemplateMatcher
 {
 public:
+    enum Quantization { NONE = 0, FP16 = 1, INT8 = 2 };
+
     TemplateMatcher() {};
     TemplateMatcher(const std::vector<std::vector<FACE_RECOG_MAT> >& positiveROIs, const std::string negativesDir,
-                    const std::vector<std::string>& positiveIDs = {}, const std::vector<std::vector<FACE_RECOG_MAT> >& additionalNegativeROIs = {});
-    std::vector<double> predict(const FACE_RECOG_MAT& roi);
-    inline size_t getPositiveCount() { return enrolledPositiveIDs.size(); }
-    inline size_t getPatchCount() { return patchCounts.area(); }
+                    const std::vector<std::string>& positiveIDs = {}, const std::vector<std::vector<FACE_RECOG_MAT> >& additionalNegativeROIs = {},
+                    bool useSharedCellHOG = false);
+    std::vector<double> predict(const FACE_RECOG_MAT& roi) const;
+    // [probe][positive] distances in double precision from packed templates (shortlisted and quantized galleries per probe)
+    std::vector<std::vector<double> > predict(const std::vector<FACE_RECOG_MAT>& rois) const;
+    // shortlist positives with approximate search before exact scoring when gallery is larger than 'exactMaxSize'
+    void buildGalleryIndex(size_t shortlistSize, int listCount, int probeCount, size_t exactMaxSize);
+    // quantized templates employed for scoring, full precision ones kept until released (gallery index, evaluation)
+    void setQuantization(Quantization mode);
+    void releaseExactTemplates();
+    TemplateQuantizationReport evaluateQuantization(const std::vector<FACE_RECOG_MAT>& probes);
+    double evaluateBatchScoring(const std::vector<FACE_RECOG_MAT>& probes) const;    // largest score difference of batch and per probe scoring
+    inline size_t getPositiveCount() const { return enrolledPositiveIDs.size(); }
+    inline size_t getPatchCount() const { return patchCounts.area(); }
+    inline cv::Size getImageSize() const { return imageSize; }
     inline std::string getPositiveID(int positiveIndex);
     virtual ~TemplateMatcher() {}
 
@@ -22,8 +48,18 @@ private:
     void updateNormFeatures(const xstd::mvector<3, FeatureVector>& positiveSamples,
                             const xstd::mvector<2, FeatureVector>& negativeSamples);
 
+    void packTemplates();
+    // predictions are reentrant (shared by concurrent streams), any scratch buffer is allocated per call
+    std::vector<FeatureVector> computeProbeFeatures(const FACE_RECOG_MAT& roi) const;
+    std::vector<std::vector<FeatureVector> > computeProbeFeatures(const std::vector<FACE_RECOG_MAT>& rois) const;
+    std::vector<double> scoreTemplates(const std::vector<FeatureVector>& probeSampleFeatures, bool useQuantized) const;
+    cv::Mat featuresToRow(const FeatureVector& features, int depth = CV_32F) const;
+    cv::Mat encodeFeatures(size_t patch, const FeatureVector& features) const;
+
     // distances
-    double similarityFromEuclideanDistance(const FeatureVector& probeSample, const FeatureVector& templateSample);
+    double similarityFromEuclideanDistance(const FeatureVector& probeSample, const FeatureVector& templateSample) const;
+    double similarityFromQuantizedDistance(size_t patch, const cv::Mat& probeEncoded, int templateRow) const;
+    FeatureVector concatPatchFeatures(const std::vector<FeatureVector>& patchFeatures) const;
 
     // constants
     cv::Size imageSize;
@@ -33,11 +69,25 @@ private:
     cv::Size cellSize;
     int nBins;
     FeatureExtractorHOG hog;
+    SharedCellHOG sharedHog;                                        // all patches from a single cell grid if enabled
+    bool useSharedHOG = false;
     std::string sampleFileExt;
     FileFormat sampleFileFormat;
 
     std::vector<std::string> enrolledPositiveIDs;
     xstd::mvector<3, FeatureVector> patchTemplates;                 // [patch][positive][representation](FeatureVector)
+    GalleryIndex galleryIndex;                                      // concatenated patch templates, labeled by positive
+    size_t galleryShortlistSize = 0;                                // exhaustive scoring if zero
+    std::vector<size_t> templateRowStarts = std::vector<size_t>(1, 0);  // [positive] first representation row, total at end
+    bool hasExactTemplates = true;
+    std::vector<cv::Mat> packedTemplates;                           // [patch](representation x feature) double precision copy
+    std::vector<cv::Mat> packedSquaredNorms;                        // [patch](1 x representation)
+
+    // quantized templates with per-patch int8 scale/offset, or fp16 stored as CV_16S
+    Quantization quantization = NONE;
+    std::vector<cv::Mat> quantizedTemplates;                        // [patch](representation x feature)
+    std::vector<double> quantizedScales;                            // [patch] int8 step
+    std::vector<double> quantizedOffsets;                           // [patch] int8 zero value
 
     // found min/max values from negative samples files + trained positives
     std::vector<FeatureVector> hogPatchFeaturesMin;                 // [patch](FeatureVector) <min>
@@ -55,6 +55,19 @@ public:
     // detector parameters
     DetectorParameters face;
     DetectorParameters eyes;
+    int faceTileSize;
+    // DNN face detector
+    std::string dnnModelFile;
+    std::string dnnWeightsFile;
+    int dnnInputSize;
+    double dnnConfidenceThreshold;
+    double dnnInputScale;
+    cv::Scalar dnnInputMean;                // subtracted before scaling (B G R, or R G B if 'dnnSwapRB')
+    bool dnnSwapRB;
+    int dnnBatchSize;
+    int dnnBatchWait;
+    int dnnThreads;
+
     bool useEyesDetection;
     bool useEyeLocalizedPosition;
 
@@ -65,8 +78,12 @@ public:
     int cameraIndex;
     CameraType cameraType;
     bool useCameraTrigger;
+    int frameDecodeThreads;
+    int frameReadAhead;
+    int frameDecodeReduction;
 
     // face detection
+    bool DNN;
     bool FRCNN;
     bool HaarCascadeFrontal;
     bool HaarCascadeProfile;
@@ -107,6 +124,29 @@ public:
     bool modelsFileLoad;
     std::string modelsFileDir;
 
+    // recognition probes scheduling
+    bool recognitionScheduling;
+    double recognitionMinQuality;
+    int recognitionWindowSize;
+    int recognitionProbesPerWindow;
+    int recognitionFrameBudget;
+    double recognitionStableDelta;
+    int recognitionStableInterval;
+
+    // gallery index
+    bool galleryIndex;
+    int galleryShortlistSize;
+    int galleryIndexLists;
+    int galleryIndexProbes;
+    int galleryExactMaxSize;
+
+    // template quantization
+    int templateQuantization;
+    bool templateQuantizationCheck;
+
+    // shared cell HOG
+    bool useSharedCellHOG;
+
     // tracker association parameters
     bool useHungarianMatching;
     int associationTrackThreshold;
@@ -122,6 +162,26 @@ public:
     int detectionAugmentationOffset;
     int detectionFrameInterval;
 
+    // motion gated detection scheduling
+    bool detectionMotionGating;
+    int detectionMaxFrameInterval;
+    int detectionFullSweepInterval;
+    int motionThreshold;
+    double motionLearningRate;
+    double motionDownscale;
+    double motionFullFrameRatio;
+
+    // KCF tracker
+    bool kcfUseHOG;
+    int kcfTemplateSize;
+    double kcfPadding;
+    double kcfScaleStep;
+
+    // STRUCK tracker search
+    bool struckMotionPrediction;
+    int struckMinSearchRadius;
+    bool struckCoarseToFine;
+
     // localized ROI search
     bool useLocalSearchROI;
     bool use3CascadesLocalSearch;
@@ -137,6 +197,10 @@ public:
     bool outputLocalROI;
     int roiOutputSize;
     bool outputDirsClearOnStart;
+    int outputWriterThreads;
+    int outputQueueSize;
+    bool outputFramesVideo;
+    double outputVideoFPS;
     bool flipFrames;
     bool displayFrames;
     bool displayFrameRate;
@@ -161,18 +225,34 @@ public:
     int plotMaxPOI;
     bool plotResetOnTrackLost;
 
+    // multiple streams processing
+    int multiStreamWorkers;
+    int multiStreamOmpThreads;
+    int testSequenceWorkers;
+
+    // load shedding
+    double loadSheddingBudget;              // frame processing time budget (ms, 0 = disabled)
+    double loadSheddingRecoverRatio;
+    int loadSheddingHoldFrames;
+
+    // configuration reload
+    bool configHotReload;
+
     /* ============
         methods
     ============ */
 
     ConfigFile() { setDefaults(); }
     ConfigFile(const std::string& path);
+    bool setValue(const std::string& name, const std::string& value);  // single parameter update, false if unknown ('feature' replaces all)
+    bool setValues(const std::vector<std::pair<std::string, std::string> >& values);   // validated once after all updates
     std::string display() const;
     ClassifierType getClassifierType() const;
     bool requireAnyCascade() const;
     friend std::ostream& operator<<(std::ostream& out, const ConfigFile& conf);
 
 private:
+    bool parseLine(const std::string& line);
     void setDefaults();
     void validateValues();
     static std::string FeatureName(FeatureType f);
@@ -0,0 +1,44 @@
+﻿#ifndef FACE_RECOG_CONFIG_STORE_H
+#define FACE_RECOG_CONFIG_STORE_H
+
+#include "Utilities/Common.h"
+#include "Configs/ConfigFile.h"
+#include <atomic>
+
+/* Immutable configuration published by a 'ConfigStore' */
+typedef std::shared_ptr<const ConfigFile> ConfigSnapshot;
+
+/*
+    Versioned immutable configuration snapshots reloaded from the config file without restarting
+
+    A reload is triggered by a modification of the config file or by a reload request (SIGHUP under Linux)
+    and is only applied when 'poll' is called between processed frames. Runtime parameters of the reloaded
+    file are applied to a copy of the current snapshot which is then published atomically (readers keep the
+    snapshot they obtained). Other parameters are only employed when models, detectors and streams are built:
+    their changes are reported and kept at their current values until a restart.
+
+    Components holding raw pointers to a snapshot must also hold the snapshot itself (ex: each 'Track' holds the one
+    its tracker was created with), retired snapshots are released once the store is their last owner.
+*/
+class ConfigStore
+{
+public:
+    ConfigStore(const std::string& path);
+    ConfigSnapshot current() const;                         // latest published snapshot (safe from any thread)
+    bool poll(logstream& log);                              // reload if requested or file modified, true if a new snapshot was published
+    static void requestReload();                            // async-signal safe
+    static void installReloadSignal();                      // SIGHUP requests reload (Linux only)
+    static bool isRuntimeParameter(const std::string& name);// applied on reload without rebuilding models/detectors
+    inline size_t getVersion() const                        { return version.load(); }
+
+private:
+    bool readValues(std::vector<std::pair<std::string, std::string> >& values) const;
+
+    std::string path;
+    ConfigSnapshot snapshot;
+    std::vector<ConfigSnapshot> retired;
+    std::atomic<size_t> version;
+    std::time_t lastWriteTime;
+};
+
+#endif/*FACE_RECOG_CONFIG_STORE_H*/
@@ -0,0 +1,92 @@
+﻿#ifndef FACE_RECOG_FACE_DETECTOR_DNN_H
+#define FACE_RECOG_FACE_DETECTOR_DNN_H
+#ifdef  FACE_RECOG_HAS_DNN
+
+#include "Utilities/Common.h"
+#include "Utilities/MatDefines.h"
+#include "Detectors/IDetector.h"
+#include "Tracks/Track.h"
+#include <opencv2/dnn.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <map>
+#include <mutex>
+
+/*
+    CNN face detection network on the OpenCV 'dnn' CPU backend shared by all detector instances
+
+    Loads Caffe (prototxt/caffemodel) or ONNX models producing SSD 'DetectionOutput' rows
+    [image, label, confidence, x1, y1, x2, y2] with coordinates normalized to the input image.
+    Images submitted concurrently (streams, tiles) are gathered into a single forward pass:
+    the first caller waits at most 'batchWaitMs' for other requests and forwards all pending
+    images (up to 'maxBatchSize' per blob), other callers wait for their results meanwhile.
+    Input blobs are scaled by 'inputScale' after subtracting 'inputMean', with R/B swapped if requested.
+*/
+class FaceDetectionNetwork
+{
+public:
+    FaceDetectionNetwork(const std::string& modelPath, const std::string& weightsPath, cv::Size inputSize,
+                         int maxBatchSize, int batchWaitMs, double inputScale, cv::Scalar inputMean, bool swapRB);
+    // networks loaded once per model files and input/batching parameters, shared between detectors
+    static std::shared_ptr<FaceDetectionNetwork> getShared(const std::string& modelPath, const std::string& weightsPath, cv::Size inputSize,
+                                                           int maxBatchSize, int batchWaitMs, double inputScale, cv::Scalar inputMean, bool swapRB);
+    // thread-safe, confidence and bbox in image coordinates of each detection per image
+    void detect(const std::vector<cv::Mat>& images, std::vector<std::vector<cv::Rect> >& bboxes,
+                std::vector<std::vector<float> >& confidences);
+    inline const std::string& getWeightsPath() const { return weightsPath; }
+
+private:
+    struct Request
+    {
+        const std::vector<cv::Mat>* images;
+        std::vector<std::vector<cv::Rect> >* bboxes;
+        std::vector<std::vector<float> >* confidences;
+        bool done = false;
+        std::exception_ptr error;       // failure of the forward pass that contained the request
+    };
+    void forward(const std::vector<Request*>& batch);
+
+    cv::dnn::Net net;
+    std::string weightsPath;
+    cv::Size inputSize;
+    int maxBatchSize;
+    int batchWaitMs;
+    double inputScale;
+    cv::Scalar inputMean;
+    bool swapRB;
+
+    std::mutex queueMutex;
+    std::condition_variable queueChanged;
+    std::deque<Request*> pending;
+    size_t pendingImages;
+    bool forwarding;
+    // buffers reused between forward passes (only accessed by the forwarding thread)
+    std::vector<cv::Mat> colorImages;
+    cv::Mat resizedImage, inputBlob;
+};
+
+class FaceDetectorDNN final : public IDetector
+{
+public:
+    FaceDetectorDNN(std::shared_ptr<FaceDetectionNetwork> network, double confidenceThreshold,
+                    cv::Size minSize, cv::Size maxSize, int tileSize, double overlapThreshold);
+    inline ~FaceDetectorDNN() {}
+    // specialized overrides
+    void assignImage(const FACE_RECOG_MAT& frame) override;
+    void assignImage(const FrameContext& context) override;                // colour frame, network input is BGR
+    bool detect(std::vector<std::vector<cv::Rect> >& bboxes) override;
+    double evaluateConfidence(const Track& track, const FACE_RECOG_MAT& image) override;
+
+private:
+    std::vector<cv::Rect> computeTiles(cv::Size frameSize) const;
+
+    std::shared_ptr<FaceDetectionNetwork> network;
+    double confidenceThreshold;
+    cv::Size minSize;
+    cv::Size maxSize;
+    int tileSize;       // 0 to detect over the whole frame only
+};
+
+#endif/*FACE_RECOG_HAS_DNN*/
+#endif/*FACE_RECOG_FACE_DETECTOR_DNN_H*/
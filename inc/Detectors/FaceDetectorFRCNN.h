@@ -15,7 +15,7 @@ public:
     FaceDetectorFRCNN(std::string basePath);
     ~FaceDetectorFRCNN() {}
     // specific to specialized class
-    void pyObjList2VecRect(PyObject* list);
+    void valuesToRects(const cv::Mat& values);
     // specialized overrides
     int detect(std::vector<std::vector<cv::Rect> >& bboxes) override;
     std::vector<cv::Rect> mergeDetections(std::vector<std::vector<cv::Rect> >& faces) override { return m_faces; }
@@ -28,6 +28,7 @@ private:
     std::string folderPath = "../python";
     std::string filePath = "../python";
     std::string pyFunc = "face_detect";
+    size_t pyFuncHandle;                // loaded once in the persistent python session
     std::vector<cv::Rect> m_faces;
 };
 
@@ -33,24 +33,32 @@ public:
     FaceDetectorVJ(double scaleFactor, int nmsThreshold, cv::Size minSize, cv::Size maxSize,
                    cv::Size evalSize, int minNeighbours, double overlapThreshold);
     void setDefaults();
+    inline void setTileSize(int size) { tileSize = size; }  // 0 to disable tiled detection
     bool loadDetector(std::string modelPath, FlipMode faceFlipMode = NONE);
     // specialized overrides
     void assignImage(const FACE_RECOG_MAT& frame) override;
+    void assignImage(const FrameContext& context) override;
     bool detect(std::vector<std::vector<cv::Rect> >& bboxes) override;
     double evaluateConfidence(const Track& track, const FACE_RECOG_MAT& image) override;
     void flipDetections(size_t index, vector<vector<Rect> >& bboxes) override;
     vector<Rect> mergeDetections(vector<vector<Rect> >& bboxes) override;
+    bool isFrontalDetection(size_t index) override;
 
 private:
+    bool detectTiled(std::vector<std::vector<cv::Rect> >& bboxes);
+    std::vector<cv::Rect> computeTiles(cv::Size frameSize, int tileDim, int overlap, std::vector<cv::Rect>& cores) const;
+
     #if FACE_RECOG_USE_CUDA
     vector<Ptr<FACE_RECOG_NAMESPACE::CascadeClassifier>> faceFinder;
     FACE_RECOG_MAT foundObjects_gpu;        // Buffer to transfer gpu objects found with 'detectMultiScale' to 'vector<Rect>'
     #else
     std::vector<FACE_RECOG_NAMESPACE::CascadeClassifier> faceFinder;
+    std::vector<std::vector<cv::CascadeClassifier> > tileFinders;  // [thread][model] copies for concurrent tile detections
     #endif
 
     std::vector<FlipMode> faceFlipModes;    // flip operation applied before processing bboxes for corresponding loaded CascadeClassifier / frames
     std::vector<int> stageCount;            // stage counts of loaded CascadeClassifiers
+    std::vector<bool> frontalDetections;    // merged detections originating from the frontal (first) model
 
     cv::Size evalSize;  // classifier training window for detector confidence evaluation
     cv::Size minSize;
@@ -58,6 +66,7 @@ private:
     double scaleFactor;
     int nmsThreshold;
     int minNeighbours;
+    int tileSize;
 };
 
 #endif/*FACE_RECOG_HAS_VJ*/
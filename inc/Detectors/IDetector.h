@@ -5,6 +5,7 @@
 #include "Utilities/MatDefines.h"
 #include "Configs/ConfigFile.h"
 #include "Detectors/DetectorType.h"
+#include "Pipeline/FrameContext.h"
 #include "Tracks/Track.h"
 
 class IDetector
@@ -17,6 +18,8 @@ public:
     virtual std::vector<cv::Rect> mergeDetections(std::vector<std::vector<cv::Rect>> &bboxes);
     virtual void flipDetections(size_t index, std::vector<std::vector<cv::Rect>>& bboxes);
     virtual void cleanImages() { frames.clear(); }
+    virtual bool isFrontalDetection(size_t index) { return true; }  // origin of merged detection at index from last merge
+    virtual void assignImage(const FrameContext& context) { assignImage(context.getGray()); }     // whole frame from shared representations
     // pure virtual methods (mandatory overrides by derived classes)
     virtual void assignImage(const FACE_RECOG_MAT& frame) = 0;
     virtual bool detect(std::vector<std::vector<cv::Rect>>& bboxes) = 0;
@@ -8,11 +8,13 @@
 #include "Utilities/ForwardDeclares.h"
 #include "Utilities/MatDefines.h"
 #include "Utilities/MultiColorType.h"
+#include "Utilities/ThreadPool.h"
 #include "Utilities/Utilities.h"
 
 // FaceRecog Configs
 #include "Configs/Platform.h"
 #include "Configs/ConfigFile.h"
+#include "Configs/ConfigStore.h"
 #include "Configs/ConsoleOptions.h"
 #include "Configs/Version.h"
 
@@ -29,6 +31,7 @@
 #include "Tracks/ImageRep.h"
 #include "Tracks/Kernels.h"
 #include "Tracks/LaRank.h"
+#include "Tracks/MotionPredictor.h"
 #include "Tracks/Rect.h"
 #include "Tracks/Sample.h"
 #include "Tracks/Sampler.h"
@@ -42,6 +45,9 @@
 #include "Detectors/EyeDetector.h"
 #include "Detectors/FaceDetectorVJ.h"
 #endif/*FACE_RECOG_HAS_VJ*/
+#ifdef FACE_RECOG_HAS_DNN
+#include "Detectors/FaceDetectorDNN.h"
+#endif/*FACE_RECOG_HAS_DNN*/
 #ifdef FACE_RECOG_HAS_FRCNN
     #ifndef FACE_RECOG_HAS_PYTHON
     #error Python is required to employ FRCNN
@@ -73,6 +79,8 @@
 // FaceRecog Classifiers
 #include "Classifiers/ClassifierType.h"
 #include "Classifiers/IClassifier.h"
+#include "Classifiers/GalleryIndex.h"
+#include "Classifiers/SharedCellHOG.h"
 #ifdef FACE_RECOG_HAS_ESVM
 #include "Classifiers/ClassifierEnsembleESVM.h"
 #endif/*FACE_RECOG_HAS_ESVM*/
@@ -86,4 +94,18 @@
 #include "Classifiers/ClassifierEnsembleTM.h"
 #endif/*FACE_RECOG_HAS_TM*/
 
+// FaceRecog Pipeline
+#include "Pipeline/DetectionScheduler.h"
+#include "Pipeline/FrameContext.h"
+#include "Pipeline/FrameSequenceReader.h"
+#include "Pipeline/LoadSheddingScheduler.h"
+#include "Pipeline/OutputWriter.h"
+#include "Pipeline/Pipeline.h"
+#include "Pipeline/ProbeExtractor.h"
+#include "Pipeline/RecognitionScheduler.h"
+#include "Pipeline/StreamSource.h"
+#include "Pipeline/StreamProcessor.h"
+#include "Pipeline/StreamScheduler.h"
+#include "Pipeline/SequenceEvaluator.h"
+
 #endif/*FACE_RECOG_H*/
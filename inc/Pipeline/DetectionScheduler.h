@@ -0,0 +1,54 @@
+﻿#ifndef FACE_RECOG_DETECTION_SCHEDULER_H
+#define FACE_RECOG_DETECTION_SCHEDULER_H
+
+#include "Utilities/Common.h"
+#include "Utilities/MatDefines.h"
+#include "Configs/ConfigFile.h"
+#include "Pipeline/FrameContext.h"
+
+/*
+    Decides on which frames and regions the global face detection is applied
+
+    Without motion gating, full frame detection is applied every 'detectionFrameInterval' frames.
+    With motion gating, a change mask obtained against a running background model limits detection
+    to the moving regions, detection frequency is reduced down to 'detectionMaxFrameInterval' while
+    the scene is static and tracks are stable, and a full frame sweep is still guaranteed at least
+    every 'detectionFullSweepInterval' frames to find faces that entered without noticeable motion.
+*/
+class DetectionScheduler
+{
+public:
+    DetectionScheduler(const ConfigFile& config);
+    void configure(const ConfigFile& config);               // update parameters, motion background is preserved
+    void reset();
+    bool schedule(const FrameContext& context, bool requireFrequent);      // true if detection must be applied on this frame
+    inline bool isFullSweep() const                         { return fullSweep; }
+    inline const std::vector<cv::Rect>& getRegions() const  { return regions; }     // detection regions when not a full sweep
+    inline double getActivity() const                       { return activity; }    // ratio of changed pixels in last frame
+    inline void setIntervalScale(int scale)                 { intervalScale = std::max(scale, 1); }  // multiplies all detection intervals
+
+private:
+    void updateMotion(const FrameContext& context);
+
+    bool useMotionGating;
+    int minInterval;
+    int maxInterval;
+    int fullSweepInterval;
+    int motionThreshold;
+    double motionLearningRate;
+    double motionDownscale;
+    double motionFullFrameRatio;
+    cv::Size regionMinSize;
+    int intervalScale;
+
+    size_t frameIndex;
+    int framesSinceDetection;
+    int framesSinceFullSweep;
+    bool fullSweep;
+    double activity;
+    std::vector<cv::Rect> regions;
+    cv::Mat background;                 // running average of downscaled frames
+    cv::Mat smallFrame, diffFrame, motionMask;    // 'smallFrame' is the blurred downscaled frame
+};
+
+#endif/*FACE_RECOG_DETECTION_SCHEDULER_H*/
@@ -0,0 +1,47 @@
+﻿#ifndef FACE_RECOG_FRAME_CONTEXT_H
+#define FACE_RECOG_FRAME_CONTEXT_H
+
+#include "Utilities/Common.h"
+#include "Utilities/MatDefines.h"
+#include <map>
+#include <mutex>
+
+/*
+    Image representations of a single frame shared by detectors, trackers and classifiers
+
+    Each representation (gray, flipped gray, integral, squared integral, HSV, downscaled gray) is
+    computed on its first request and memoized, so that it is computed at most once per frame whatever
+    the number of consumers. Requests are thread-safe (once-only initialization), representations must
+    not be modified by consumers. A context is only valid for the frame it was created with.
+*/
+class FrameContext
+{
+public:
+    FrameContext(const FACE_RECOG_MAT& frame);                  // BGR or gray frame (not copied)
+    inline const FACE_RECOG_MAT& getFrame() const { return frame; }
+    inline cv::Size getSize() const { return frame.size(); }
+    const FACE_RECOG_MAT& getGray() const;
+    const cv::Mat& getGrayMat() const;                          // host memory view of 'getGray'
+    const FACE_RECOG_MAT& getFlipped(FlipMode flipMode) const;  // flipped gray
+    const cv::Mat& getIntegral() const;                         // CV_32S (rows+1 x cols+1) of gray
+    const cv::Mat& getSquaredIntegral() const;                  // CV_64F (rows+1 x cols+1) of gray
+    const cv::Mat& getHSV() const;                              // colour conversion of BGR frame (zeros if gray)
+    const cv::Mat& getDownscaled(double scale) const;           // gray resized with area interpolation
+    // trackers gray converted with swapped R/B weights as they always were (changing it alters their features)
+    const cv::Mat& getTrackerGray() const;
+    const cv::Mat& getTrackerIntegral() const;                  // CV_32S (rows+1 x cols+1) of tracker gray
+
+private:
+    FACE_RECOG_MAT frame;
+
+    mutable std::once_flag grayOnce, grayMatOnce, integralOnce, squaredIntegralOnce, hsvOnce, trackerGrayOnce, trackerIntegralOnce;
+    mutable FACE_RECOG_MAT gray;
+    mutable cv::Mat grayMat, integral, squaredIntegral, hsv, trackerGray, trackerIntegral;
+
+    // representations with parameters, few per frame
+    mutable std::mutex cacheMutex;
+    mutable std::map<int, FACE_RECOG_MAT> flipped;
+    mutable std::map<double, cv::Mat> downscaled;
+};
+
+#endif/*FACE_RECOG_FRAME_CONTEXT_H*/
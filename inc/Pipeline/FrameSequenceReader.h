@@ -0,0 +1,48 @@
+﻿#ifndef FACE_RECOG_FRAME_SEQUENCE_READER_H
+#define FACE_RECOG_FRAME_SEQUENCE_READER_H
+
+#include "Utilities/Common.h"
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+/*
+    Read-ahead decoding of an image files sequence
+
+    Frame file names are known beforehand, decoder threads claim the next frames in sequence order and
+    store them in a bounded ring of slots ('readAhead' frames at most), reading returns them in order.
+    Decoding is suspended while the ring is full so that memory stays bounded whatever the processing rate.
+    Reduced decoding (IMREAD_REDUCED_COLOR_<n>) scales JPEG images down during decompression.
+*/
+class FrameSequenceReader
+{
+public:
+    FrameSequenceReader(size_t threadCount, size_t readAhead, int reduction = 1);
+    ~FrameSequenceReader();
+    void open(const std::vector<std::string>& filePaths);   // starts decoding immediately
+    bool read(cv::Mat& frame);                              // next frame in order, false at end or on decoding failure
+    void close();
+    inline size_t frameCount() const { return paths.size(); }
+
+private:
+    struct Slot
+    {
+        cv::Mat image;
+        bool ready = false;
+    };
+    void decode();
+
+    size_t nThreads;
+    int readFlags;
+    std::vector<std::string> paths;
+    std::vector<Slot> slots;
+    std::vector<std::thread> decoders;
+    std::mutex mutex;
+    std::condition_variable frameReady;
+    std::condition_variable slotAvailable;
+    size_t nextDecode;
+    size_t nextRead;
+    bool stopping;
+};
+
+#endif/*FACE_RECOG_FRAME_SEQUENCE_READER_H*/
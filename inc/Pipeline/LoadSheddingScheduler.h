@@ -0,0 +1,57 @@
+﻿#ifndef FACE_RECOG_LOAD_SHEDDING_SCHEDULER_H
+#define FACE_RECOG_LOAD_SHEDDING_SCHEDULER_H
+
+#include "Utilities/Common.h"
+#include "Configs/ConfigFile.h"
+#include <array>
+
+/*
+    Degrades processing step by step to preserve real-time rates when frames exceed their time budget
+
+    Frame processing times are smoothed with an exponential moving average. While the average exceeds
+    'loadSheddingBudget', the next level of the ladder is applied (each level includes the previous ones).
+    Levels are reverted one at a time once the average drops below the budget scaled by 'loadSheddingRecoverRatio'.
+    At least 'loadSheddingHoldFrames' frames are processed between level changes to let the average settle.
+*/
+class LoadSheddingScheduler
+{
+public:
+    enum Level
+    {
+        NONE,                       // complete processing
+        SKIP_OUTPUTS,               // skip plots, output frames and ROI outputs
+        STALE_LOCAL_SEARCH,         // local search only applied to tracks without a matched detection
+        SKIP_EYES,                  // skip eyes validation
+        THROTTLE_RECOGNITION,       // recognition applied every other frame
+        REDUCE_DETECTION,           // detection frame intervals doubled
+        LEVEL_COUNT
+    };
+
+    LoadSheddingScheduler(const ConfigFile& config);
+    void configure(const ConfigFile& config);               // update parameters, current level and metrics are preserved
+    void reset();
+    bool update(double frameTime);                          // frame processing time (ms), true if level changed
+    static std::string levelName(int level);
+    // getters
+    inline bool isEnabled() const                           { return budget > 0; }
+    inline bool isShedding(Level step) const                { return level >= step; }
+    inline int getLevel() const                             { return level; }
+    inline double getAverageTime() const                    { return averageTime; }
+    inline size_t getLevelFrames(int lvl) const             { return levelFrames[lvl]; }    // frames processed at each level
+    inline size_t getEscalations() const                    { return escalations; }
+    inline size_t getRecoveries() const                     { return recoveries; }
+
+private:
+    double budget;
+    double recoverRatio;
+    int holdFrames;
+
+    int level;
+    int framesSinceChange;
+    double averageTime;
+    std::array<size_t, LEVEL_COUNT> levelFrames;
+    size_t escalations;
+    size_t recoveries;
+};
+
+#endif/*FACE_RECOG_LOAD_SHEDDING_SCHEDULER_H*/
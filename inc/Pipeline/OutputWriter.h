@@ -0,0 +1,65 @@
+﻿#ifndef FACE_RECOG_OUTPUT_WRITER_H
+#define FACE_RECOG_OUTPUT_WRITER_H
+
+#include "Utilities/Common.h"
+#include "Configs/ConfigFile.h"
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+
+/*
+    Asynchronous writing of output frames and track ROIs
+
+    Images are copied into a bounded queue and encoded to disk by a few writer threads, an image
+    submitted while the queue is full is dropped (and counted) so that output never delays processing.
+    Created directories are memorized to avoid checking them again for every written image. Video
+    frames are appended in submission order to their file by a dedicated thread.
+    Without writer threads, images are written synchronously by the calling thread.
+*/
+class OutputWriter
+{
+public:
+    OutputWriter(const ConfigFile& config);
+    ~OutputWriter();
+    bool writeImage(const std::string& filePath, const cv::Mat& image);        // false if dropped
+    bool writeTrackROI(const cv::Mat& roi, const std::string& label, int trackNumber, const std::string& dirPath);
+    bool writeVideoFrame(const std::string& videoPath, const cv::Mat& frame);  // false if dropped
+    void flush();                                                               // block until all queued outputs are written
+    inline size_t getDroppedCount() const { return dropped; }
+    inline size_t getWrittenCount() const { return written; }
+
+private:
+    struct Output
+    {
+        std::string path;
+        cv::Mat image;
+    };
+    bool submit(std::deque<Output>& queue, const std::string& path, const cv::Mat& image);
+    void writeImages();
+    void writeVideos();
+    void ensureDirectory(const std::string& dirPath);
+    void appendVideoFrame(const Output& output);
+
+    size_t capacity;
+    double videoFPS;
+    std::vector<std::thread> imageThreads;
+    std::thread videoThread;
+    std::deque<Output> imageQueue, videoQueue;
+    size_t activeWrites;
+    std::mutex mutex;
+    std::condition_variable outputAvailable;
+    std::condition_variable outputsWritten;
+    bool stopping;
+    std::atomic<size_t> dropped;
+    std::atomic<size_t> written;
+
+    std::mutex directoryMutex;
+    std::set<std::string> directories;                          // already created or existing directories
+    std::map<std::string, cv::VideoWriter> videoWriters;        // [path] only accessed by the video thread
+    std::map<std::string, cv::Size> videoSizes;                 // [path] frame size fixed by the first written frame
+};
+
+#endif/*FACE_RECOG_OUTPUT_WRITER_H*/
@@ -0,0 +1,43 @@
+﻿#ifndef FACE_RECOG_PIPELINE_H
+#define FACE_RECOG_PIPELINE_H
+
+#include "Utilities/Common.h"
+#include "Utilities/MatDefines.h"
+#include "Configs/ConfigFile.h"
+#include "Classifiers/IClassifier.h"
+#include "Detectors/IDetector.h"
+#include "Tracks/ImageRep.h"
+#include "Tracks/Track.h"
+
+/* Per-frame stages of the stream processing that call detectors, trackers and classifiers */
+class IPipeline
+{
+public:
+    virtual ~IPipeline() {}
+    virtual int detectMerge(IDetector& detector, std::vector<cv::Rect>& bboxes) = 0;
+    virtual void trackFaces(std::vector<Track>& tracks, const ImageRep& image) = 0;
+    virtual std::vector<std::vector<double> > predictBatch(const IClassifier& classifier, const std::vector<FACE_RECOG_MAT>& rois) = 0;
+};
+
+/*
+    Stages specialized for concrete detector, tracker and classifier types
+
+    The specialized pipeline is selected once for the stream, so that a single virtual call is
+    made per stage and frame. Within stages, calls to the concrete ('final') types are resolved
+    statically and the compiler sees through the per-track hot path (tracker, features, kernel).
+    Explicit instantiations are provided for the common combinations, 'Pipeline<IDetector, ITracker,
+    IClassifier>' is the dynamic fallback employed for any other combination.
+*/
+template <class Detector, class Tracker, class Classifier>
+class Pipeline final : public IPipeline
+{
+public:
+    int detectMerge(IDetector& detector, std::vector<cv::Rect>& bboxes) override;
+    void trackFaces(std::vector<Track>& tracks, const ImageRep& image) override;
+    std::vector<std::vector<double> > predictBatch(const IClassifier& classifier, const std::vector<FACE_RECOG_MAT>& rois) override;
+};
+
+// specialized pipeline matching the configured detector and tracker types and the classifier instance (if any)
+std::shared_ptr<IPipeline> buildPipeline(const ConfigFile& config, const IClassifier* classifier);
+
+#endif/*FACE_RECOG_PIPELINE_H*/
@@ -0,0 +1,33 @@
+﻿#ifndef FACE_RECOG_PROBE_EXTRACTOR_H
+#define FACE_RECOG_PROBE_EXTRACTOR_H
+
+#include "Utilities/Common.h"
+#include "Utilities/MatDefines.h"
+
+/*
+    Extracts normalized gray probes of many ROIs directly from the source frame
+
+    Each probe is resized from the frame ROI (or warped with replicated borders for ROIs crossing the frame
+    boundaries) straight into its row of a preallocated contiguous batch buffer, avoiding intermediate crops.
+    Probes remain valid until the next extraction, and the buffer only grows when more ROIs are requested.
+*/
+class ProbeExtractor
+{
+public:
+    ProbeExtractor(cv::Size probeSize = cv::Size());
+    void setProbeSize(cv::Size size);
+    size_t extract(const FACE_RECOG_MAT& frameGray, const std::vector<cv::Rect>& rois);
+    inline bool isEnabled() const                       { return probeSize.area() > 0; }
+    inline cv::Size getProbeSize() const                { return probeSize; }
+    inline size_t getProbeCount() const                 { return probeCount; }
+    inline const cv::Mat& getProbe(size_t index) const  { return probes[index]; }   // probe image view in batch buffer
+    inline cv::Mat getBatch() const                     { return batch.rowRange(0, (int)probeCount); }  // one flattened probe per row
+
+private:
+    cv::Size probeSize;
+    cv::Mat batch;
+    std::vector<cv::Mat> probes;
+    size_t probeCount;
+};
+
+#endif/*FACE_RECOG_PROBE_EXTRACTOR_H*/
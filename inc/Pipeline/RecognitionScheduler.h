@@ -0,0 +1,58 @@
+﻿#ifndef FACE_RECOG_RECOGNITION_SCHEDULER_H
+#define FACE_RECOG_RECOGNITION_SCHEDULER_H
+
+#include "Utilities/Common.h"
+#include "Utilities/MatDefines.h"
+#include "Configs/ConfigFile.h"
+#include "Tracks/Track.h"
+
+/*
+    Decides which tracks submit their current face crop as recognition probe
+
+    Without scheduling, every validated track is probed on every frame.
+    With scheduling, each crop is given a cheap quality score (sharpness, size, eyes validation and
+    frontal/profile detection origin). Crops under 'recognitionMinQuality' are never probed, and only
+    crops of at least the running quality of the track are probed, up to 'recognitionProbesPerWindow'
+    per window of 'recognitionWindowSize' frames. Recognized tracks with an accumulated score that remains
+    within 'recognitionStableDelta' are only refreshed every 'recognitionStableInterval' frames.
+    Remaining probes are limited to 'recognitionFrameBudget' per frame, unrecognized tracks first.
+*/
+class RecognitionScheduler
+{
+public:
+    RecognitionScheduler(const ConfigFile& config);
+    void configure(const ConfigFile& config);               // update parameters, scheduling states are preserved
+    void reset();
+    // indexes of tracks among candidates to probe on this frame
+    std::vector<size_t> schedule(std::vector<Track>& tracks, const std::vector<size_t>& candidates, const FACE_RECOG_MAT& frameGray);
+    void update(int trackNumber, double accumulatedScore);  // accumulated score following a submitted probe
+    double probeQuality(Track& track, const FACE_RECOG_MAT& frameGray);
+
+private:
+    struct TrackState
+    {
+        size_t windowStart = 0;
+        int windowProbes = 0;
+        double quality = -1;        // running quality of track crops (negative if none evaluated yet)
+        double lastScore = 0;
+        int stableCount = 0;        // consecutive probes with accumulated score variation within delta
+        size_t lastProbe = 0;
+    };
+
+    bool useScheduling;
+    bool useEyesDetection;
+    double minQuality;
+    int windowSize;
+    int probesPerWindow;
+    int frameBudget;
+    double stableDelta;
+    int stableInterval;
+    cv::Size qualitySize;
+    int minFaceWidth;
+
+    size_t frameIndex;
+    std::map<int, TrackState> states;   // by track number
+    cv::Mat crop, laplacian;
+};
+
+#endif/*FACE_RECOG_RECOGNITION_SCHEDULER_H*/
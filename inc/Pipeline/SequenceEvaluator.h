@@ -0,0 +1,51 @@
+﻿#ifndef FACE_RECOG_SEQUENCE_EVALUATOR_H
+#define FACE_RECOG_SEQUENCE_EVALUATOR_H
+
+#include "Utilities/Common.h"
+#include "Utilities/MatDefines.h"
+#include "Utilities/ThreadPool.h"
+#include "Configs/ConfigFile.h"
+#include "Pipeline/StreamProcessor.h"
+
+/*
+    Offline evaluation of independent test sequences processed concurrently
+
+    Each sequence is a single task processed from start to end by a pool worker with its own tracking
+    state (StreamProcessor) and the worker's detectors, classifier models are shared by all sequences.
+    Results of every sequence are written to a separate file, then merged in test file order so that
+    the final result file is identical to the one obtained by processing sequences one after another.
+    Track numbers of each sequence start at zero and are offset when merged by the count of those
+    assigned in previous sequences, as they would have been numbered by a single sequential processor.
+*/
+class SequenceEvaluator
+{
+public:
+    SequenceEvaluator(const ConfigFile* config, const SharedModels& models, const std::string& modelBasePath);
+    void addSequence(const std::string& regexPath, const std::vector<std::string>& frameNames, const std::string& resultFilePath);
+    void run(logstream& logResult);                                 // block until all sequences are processed and merged in 'logResult'
+    inline size_t sequenceCount() const                             { return sequences.size(); }
+    inline size_t getFrameCount(size_t index) const                 { return sequences[index].frameCounter; }
+    inline const std::string& getSequenceID(size_t index) const     { return sequences[index].sequenceID; }
+    inline const std::string& getResultPath(size_t index) const     { return sequences[index].resultFilePath; }
+
+private:
+    struct Sequence
+    {
+        std::string sequenceID;
+        std::string regexPath;
+        std::vector<std::string> frameNames;
+        std::string resultFilePath;
+        size_t frameCounter = 0;
+        int trackNumberCount = 0;           // track numbers assigned while processing the sequence
+    };
+    void process(size_t sequenceIndex);
+    void mergeResults(logstream& logResult);
+
+    const ConfigFile* conf;
+    SharedModels models;
+    std::unique_ptr<ThreadPool> pool;
+    std::vector<DetectorSet> detectorSets;  // [worker]
+    std::vector<Sequence> sequences;
+};
+
+#endif/*FACE_RECOG_SEQUENCE_EVALUATOR_H*/
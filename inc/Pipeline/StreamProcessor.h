@@ -0,0 +1,120 @@
+﻿#ifndef FACE_RECOG_STREAM_PROCESSOR_H
+#define FACE_RECOG_STREAM_PROCESSOR_H
+
+#include "Utilities/Common.h"
+#include "Utilities/MatDefines.h"
+#include "Utilities/MultiColorType.h"
+#include "Configs/ConfigFile.h"
+#include "Configs/ConfigStore.h"
+#include "Classifiers/IClassifier.h"
+#include "Detectors/IDetector.h"
+#include "Pipeline/DetectionScheduler.h"
+#include "Pipeline/FrameContext.h"
+#include "Pipeline/LoadSheddingScheduler.h"
+#include "Pipeline/OutputWriter.h"
+#include "Pipeline/Pipeline.h"
+#include "Pipeline/ProbeExtractor.h"
+#include "Pipeline/RecognitionScheduler.h"
+#include "Tracks/Association.h"
+#include "Tracks/CircularBuffer.h"
+#include "Tracks/ImageRep.h"
+#include "Tracks/Track.h"
+
+/* Detectors employed for processing a frame, instances hold the assigned images and cannot be shared between threads */
+struct DetectorSet
+{
+    std::shared_ptr<IDetector> face;        // main (global) face detector
+    std::shared_ptr<IDetector> localFace;   // localized search face detector
+    std::shared_ptr<IDetector> eyes;        // left-right eye detectors
+};
+
+DetectorSet buildDetectorSet(const ConfigFile& config, const std::string& modelBasePath);
+
+/* Immutable models shared by all processing streams (classifier only employed for predictions, reentrant) */
+struct SharedModels
+{
+    std::shared_ptr<IClassifier> classifier;
+    std::vector<std::string> targetIDs;     // POI identifiers matching the classifier scores
+};
+
+/* Processing times and counters */
+struct StreamStatistics
+{
+    double sumTimeDetect = 0;
+    double sumTimeTrack = 0;
+    double sumTimeDetectLocal = 0;
+    int totalFrames = 0;
+    int totalFramesDetect = 0;
+    int totalFramesDetectRegions = 0;       // detections limited to moving regions (included in 'totalFramesDetect')
+    int totalFramesDetectLocal = 0;
+    int totalProbes = 0;                    // recognition probes predicted by the classifier
+    int totalProbesSkipped = 0;             // validated probes skipped by recognition scheduling
+    int totalFramesShed = 0;                // frames processed with at least one load shedding level applied
+};
+
+/* Face detection, tracking and recognition state of a single input stream */
+class StreamProcessor
+{
+public:
+    StreamProcessor(const ConfigFile* config, const SharedModels& models);
+    void reset();                                                           // restart tracking (ex: new test sequence)
+    void updateConfig(const ConfigSnapshot& config);                       // reloaded runtime parameters, applied between frames
+    void process(const FACE_RECOG_MAT& frame, DetectorSet& detectors);     // apply the complete pipeline on the next frame
+    void drawTracks(cv::Mat& image, const MultiColorType& colors);
+    void writeResults(logstream& logResult, const std::string& sequenceID, size_t sequenceNumber, const std::string& frameLabel);
+    static void writeResultsHeader(logstream& logResult, size_t targetCount);
+    void saveTrackROIs(const std::string& frameLabel, const std::string& roiDir, const std::string& localRoiDir);
+    // getters
+    inline std::vector<Track>& getTracks()                  { return currentTracks; }
+    inline CircularBuffer& getScores()                      { return accScores; }
+    inline const StreamStatistics& getStatistics() const    { return stats; }
+    inline const FACE_RECOG_MAT& getFrameGray() const       { return frameGray; }
+    inline size_t getFrameIndex() const                     { return frameIndex; }
+    inline int getTrackNumberCount() const                  { return trackNumber; }      // track numbers assigned (kept across resets)
+    inline const LoadSheddingScheduler& getLoadShedding() const { return loadShedding; }
+    // setters
+    inline void setDebugLog(logstream* log)                 { logDebug = log; }
+    inline void setOutputWriter(OutputWriter* writer)       { outputWriter = writer; }    // asynchronous ROI outputs (synchronous if null)
+    inline void addOutputTime(double ms)                    { outputTime += ms; }         // caller outputs time of last frame (load shedding)
+
+private:
+    void detectFaces(const FrameContext& context, DetectorSet& detectors);
+    void trackFaces(const ImageRep& image);
+    void matchDetections(const ImageRep& image, DetectorSet& detectors);
+    void createTracks(const ImageRep& image, DetectorSet& detectors);
+    void searchLocalROI(const ImageRep& image, DetectorSet& detectors);
+    void detectEyes(DetectorSet& detectors);
+    void recognizeFaces();
+    void saveTrackROI(const cv::Mat& roi, const std::string& frameLabel, int trackNumber, const std::string& dirPath);
+
+    const ConfigFile* conf;
+    ConfigSnapshot confSnapshot;                            // shared with new tracks (non-owning until updated from a reload)
+    SharedModels models;
+    CircularBuffer accScores;
+    Association association;
+    DetectionScheduler detectionScheduler;
+    RecognitionScheduler recognitionScheduler;
+    LoadSheddingScheduler loadShedding;
+    ProbeExtractor probeExtractor;                          // classifier normalized probes (disabled if unsupported)
+    ProbeExtractor roiExtractor;                            // track ROIs output to disk
+    StreamStatistics stats;
+    logstream* logDebug;
+    OutputWriter* outputWriter;
+    std::shared_ptr<IPipeline> pipeline;                    // stages specialized for detector/tracker/classifier types
+
+    size_t frameIndex;                                      // frame count since last reset
+    bool isNewDetection;
+    double outputTime;                                      // time reported by the caller for outputs of last frame (ms)
+    int trackNumber;                                        // kept across resets for unique numbers between sequences
+    std::vector<Track> currentTracks, initCandidates, newCandidates;
+    std::vector<cv::Rect> mergedDet, notMatchedDets;
+    std::vector<bool> mergedDetFrontal;                     // detector model origin of 'mergedDet'
+    std::vector<size_t> usedDetectorIndexes;
+    FACE_RECOG_MAT frame, frameGray;
+
+    // recognition score limits (debug)
+    std::vector<double> minScores;
+    std::vector<double> maxScores;
+};
+
+#endif/*FACE_RECOG_STREAM_PROCESSOR_H*/
@@ -0,0 +1,63 @@
+﻿#ifndef FACE_RECOG_STREAM_SCHEDULER_H
+#define FACE_RECOG_STREAM_SCHEDULER_H
+
+#include "Utilities/Common.h"
+#include "Utilities/MatDefines.h"
+#include "Utilities/ThreadPool.h"
+#include "Configs/ConfigFile.h"
+#include "Pipeline/StreamProcessor.h"
+#include "Pipeline/StreamSource.h"
+
+/*
+    Concurrent processing of multiple input streams over a common pool of workers
+
+    Classifier models are loaded once and shared by all streams while each worker owns its detectors.
+    Every stream has at most one frame task in flight, requeued after completion behind the other
+    streams' tasks so that each stream progresses in turn regardless of its frame rate. Live-feed
+    streams are captured on a dedicated thread keeping only the latest frame (older ones are dropped),
+    which submits the stream task when a frame arrives while none is in flight so that workers never
+    wait for a frame.
+*/
+class StreamScheduler
+{
+public:
+    StreamScheduler(const ConfigFile* config, const SharedModels& models, const std::string& modelBasePath);
+    ~StreamScheduler();
+    bool addStream(const std::string& source, const std::string& resultFilePath);  // camera index or file/regex path
+    void run();                                                                     // block until all streams are exhausted or stopped
+    void stop();
+    inline size_t streamCount() const                               { return streams.size(); }
+    inline const StreamProcessor& getProcessor(size_t index) const  { return *streams[index]->processor; }
+    inline const std::string& getSourceID(size_t index) const       { return streams[index]->sourceID; }
+    inline size_t getFrameCount(size_t index) const                 { return streams[index]->frameCounter; }
+    inline size_t getDroppedFrames(size_t index) const              { return streams[index]->droppedFrames; }
+
+private:
+    struct Stream
+    {
+        std::string sourceID;
+        std::unique_ptr<StreamSource> source;
+        std::unique_ptr<StreamProcessor> processor;
+        std::unique_ptr<logstream> logResult;
+        size_t frameCounter = 0;
+        // live-feed capture with single slot for latest frame
+        std::thread captureThread;
+        std::mutex frameMutex;
+        FACE_RECOG_MAT latestFrame;
+        bool hasFrame = false;
+        bool taskQueued = false;            // frame task submitted or running
+        size_t droppedFrames = 0;
+    };
+    void capture(size_t streamIndex);
+    bool nextFrame(Stream& stream, FACE_RECOG_MAT& frame);
+    void processNext(size_t streamIndex);
+
+    const ConfigFile* conf;
+    SharedModels models;
+    std::unique_ptr<ThreadPool> pool;
+    std::vector<DetectorSet> detectorSets;  // [worker]
+    std::vector<std::unique_ptr<Stream> > streams;
+    std::atomic<bool> stopping;
+};
+
+#endif/*FACE_RECOG_STREAM_SCHEDULER_H*/
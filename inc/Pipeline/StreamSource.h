@@ -0,0 +1,48 @@
+﻿#ifndef FACE_RECOG_STREAM_SOURCE_H
+#define FACE_RECOG_STREAM_SOURCE_H
+
+#include "Utilities/Common.h"
+#include "Utilities/MatDefines.h"
+#include "Configs/ConfigFile.h"
+#include "Camera/CameraDefines.h"
+#include "Camera/CameraType.h"
+#include "Pipeline/FrameSequenceReader.h"
+
+/* Input frames of a processing stream (image files sequence, video file or camera live-feed) */
+class StreamSource
+{
+public:
+    StreamSource(const ConfigFile& config);
+    ~StreamSource();
+    bool open(const std::string& path);                     // image files sequence (regex path) or video file
+    bool open(const std::string& path, const std::vector<std::string>& frameNames);    // image files sequence with known file names
+    bool open(const CameraType& type, int cameraIndex);     // camera live-feed
+    bool read(FACE_RECOG_MAT& frame);                       // false when no more frame can be obtained
+    void release();
+    inline bool isOpened() const { return opened; }
+    inline bool isLive() const { return cameraType != CameraType::FILE_STREAM; }
+    inline const std::string& getPath() const { return sourcePath; }
+
+private:
+    CameraType cameraType;
+    std::string sourcePath;
+    bool opened;
+    bool useCameraTrigger;
+    bool flipFrames;
+    bool verbose;
+    cv::Size frameSize;
+    cv::VideoCapture capture;
+    std::unique_ptr<FrameSequenceReader> reader;    // read-ahead decoding of known image files (if enabled)
+    size_t decodeThreads;
+    size_t readAhead;
+    int decodeReduction;
+    cv::Mat frameDecoded;
+    FACE_RECOG_MAT frameVideo;
+    #if FACE_RECOG_HAS_FLYCAPTURE2
+    std::unique_ptr<FlyCapture2::Camera> camera;
+    FlyCapture2::Image pgrRawImage;         // Buffer for reading the raw PGR Image
+    FACE_RECOG_MAT frameRaw;                // Buffer for the non-resized converted image
+    #endif/*FACE_RECOG_HAS_FLYCAPTURE2*/
+};
+
+#endif/*FACE_RECOG_STREAM_SOURCE_H*/
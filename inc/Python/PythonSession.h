@@ -0,0 +1,71 @@
+﻿#ifndef FACE_RECOG_PYTHON_SESSION_H
+#define FACE_RECOG_PYTHON_SESSION_H
+
+#include <boost/python.hpp>
+#include <opencv2/core/core.hpp>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace bp = boost::python;
+
+/*
+    Persistent embedded Python interpreter with all calls executed on a dedicated session thread
+
+    Scripts are executed once when their functions are loaded and callable handles are kept for
+    the whole session. Images are passed as read-only NumPy views over the matrix data (no copy,
+    valid only during the call) and results are returned as a single float64 matrix. The GIL is
+    acquired once by the session thread for all the calls gathered meanwhile from every caller.
+*/
+class PythonSession
+{
+public:
+    static void initialize();                   // interpreter initialization, GIL released for the session thread
+    static void finalize();
+    static PythonSession& instance();
+    ~PythonSession();
+    // script executed on first load, 'initFunc' called once after its execution if specified
+    size_t loadFunction(const std::string& filePath, const std::string& funcName,
+                        const std::string& initFunc = "");
+    cv::Mat call(size_t function, const cv::Mat& input);   // blocks until executed by the session thread
+
+private:
+    struct Task
+    {
+        size_t function = 0;
+        const cv::Mat* input = nullptr;
+        std::function<void()> job;              // executed instead of a function call if specified
+        cv::Mat output;
+        std::string error;
+        bool done = false;
+    };
+    PythonSession();
+    void submit(Task& task);
+    void run();
+    void execute(const std::vector<Task*>& batch);
+    bp::object wrapMat(const cv::Mat& mat);
+    cv::Mat toMat(const bp::object& result);
+    static std::string fetchError();
+
+    std::thread thread;
+    std::mutex queueMutex;
+    std::condition_variable queueChanged;
+    std::deque<Task*> pending;
+    bool stopping;
+    // only accessed by the session thread with the GIL
+    bp::object numpy;
+    std::map<std::string, bp::object> scripts;  // [file path] script namespace
+    std::vector<bp::object> functions;
+
+    static std::unique_ptr<PythonSession> session;
+    static std::mutex sessionMutex;
+    static PyThreadState* mainThreadState;
+};
+
+#endif/*FACE_RECOG_PYTHON_SESSION_H*/
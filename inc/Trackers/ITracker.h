@@ -67,8 +67,8 @@ public:
     virtual void reset() = 0;
     virtual cv::Rect track(const ImageRep& frame) = 0;
     // shared config
-    void updateConfig(ConfigFile* configFile) { m_config = configFile; }
-    ConfigFile *m_config;
+    void updateConfig(const ConfigFile* configFile) { m_config = configFile; }
+    const ConfigFile* m_config;
     inline const FloatRect& getBB() { return m_bb; }
     inline bool isInitialized() { return m_initialized; }
 protected:
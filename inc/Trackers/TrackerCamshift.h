@@ -12,7 +12,7 @@
 class TrackerCamshift final : public ITracker
 {
 public:
-    TrackerCamshift(ConfigFile* configFile);
+    TrackerCamshift(const ConfigFile* configFile);
     virtual ~TrackerCamshift();
     TrackerCamshift(const TrackerCamshift& obj);            // copy constructor
     TrackerCamshift & operator=(const TrackerCamshift& T);  // assignment operator
@@ -23,6 +23,9 @@ private:
     cv::Rect rectInsideFrame(const FACE_RECOG_MAT& frame, cv::Rect rect);
     cv::TermCriteria term_crit;
     cv::MatND roi_hist;
+    cv::Mat backProjWindow;                 // back-projection of the search window, reused across frames
+    // search window around the track bbox (relative to its size) where back-projection is computed
+    const float searchWindowScale = 3.0f;
     // we compute the histogram for all 3 channels channels
     const int channels[3] = { 0, 1, 2 };
     // Quantize the hue to 30 levels
@@ -8,10 +8,19 @@
 #include "Tracks/ImageRep.h"
 #include "Trackers/ITracker.h"
 
+/*
+    Compressive tracking with flat precomputed sampling grids and feature rectangles
+
+    Sampling grids (detection disk, positive disk and negative annulus) are row spans of offsets relative
+    to the object box computed once, so that samples of a span are contiguous in the integral image.
+    Feature rectangles are stored as flat arrays and converted to corner offsets of the integral image,
+    feature responses of a span are then accumulated with SIMD over consecutive samples. The integral
+    image of the frame is shared by all trackers through the frame representation.
+*/
 class TrackerCompressive final : public ITracker
 {
 public:
-    TrackerCompressive(ConfigFile* configFile);
+    TrackerCompressive(const ConfigFile* configFile);
     virtual ~TrackerCompressive();
     TrackerCompressive(const TrackerCompressive& obj);              // copy constructor
     TrackerCompressive & operator=(const TrackerCompressive& T);    // assignment operator
@@ -19,39 +28,57 @@ public:
     virtual void reset() override;
     virtual cv::Rect track(const ImageRep& frame) override;
 private:
-    // FloatRect m_bb;
+    struct SampleSpan       // offsets [dxMin,dxMax] of row 'dy' relative to the object box
+    {
+        int dy, dxMin, dxMax;
+    };
+    struct SampleSegment    // consecutive samples in a row of the frame
+    {
+        int x, y, count, start;
+    };
+
+    void computeHaarFeature(const cv::Rect& objectBox, int numFeature);
+    void copyState(const TrackerCompressive& obj);
+    static void buildDiskGrid(float rInner, float rOuter, int step, std::vector<SampleSpan>& grid);
+    int sampleRect(const cv::Rect& objectBox, const cv::Size& imageSize, const std::vector<SampleSpan>& grid,
+                   std::vector<SampleSegment>& segments);
+    void getFeatureValue(const cv::Mat& imageIntegral, const std::vector<SampleSegment>& segments, int sampleCount, cv::Mat& sampleFeatureValue);
+    void classifierUpdate(const cv::Mat& sampleFeatureValue, std::vector<float>& mu, std::vector<float>& sigma, float learnRate);
+    int radioClassifier(const cv::Mat& sampleFeatureValue);
+    void updateClassifier(const cv::Mat& imageIntegral, const cv::Size& imageSize);
+    const cv::Mat& getIntegral(const ImageRep& image);
+    cv::Point samplePosition(const std::vector<SampleSegment>& segments, int index) const;
+
     cv::Rect bbox;
-    bool m_initialized;
     int featureMinNumRect;
     int featureMaxNumRect;
     int featureNum;
-    std::vector<std::vector<cv::Rect>> features;
-    std::vector<std::vector<float>> featuresWeight;
     int rOuterPositive;
-    std::vector<cv::Rect> samplePositiveBox;
-    std::vector<cv::Rect> sampleNegativeBox;
     int rSearchWindow;
-    cv::Mat imageIntegral;
-    cv::Mat samplePositiveFeatureValue;
-    cv::Mat sampleNegativeFeatureValue;
+    float learnRate;
+    cv::RNG rng;
+
+    // flat feature rectangles, rectangles of feature 'i' in [featureRectStart[i], featureRectStart[i+1])
+    std::vector<cv::Rect> featureRects;
+    std::vector<float> featureRectWeights;
+    std::vector<int> featureRectStart;
+    std::vector<int> cornerOffsets;             // [tl,tr,bl,br] per rectangle for integral step 'cornerStep'
+    size_t cornerStep;
+
+    // sampling grids relative to the object box
+    std::vector<SampleSpan> detectGrid, positiveGrid, negativeGrid;
+    std::vector<SampleSegment> detectSegments, positiveSegments, negativeSegments;
+
+    // gaussian classifiers and buffers reused across frames
     std::vector<float> muPositive;
     std::vector<float> sigmaPositive;
     std::vector<float> muNegative;
     std::vector<float> sigmaNegative;
-    float learnRate;
-    std::vector<cv::Rect> detectBox;
+    cv::Mat samplePositiveFeatureValue;
+    cv::Mat sampleNegativeFeatureValue;
     cv::Mat detectFeatureValue;
-    cv::RNG rng;
-
-private:
-    void computeHaarFeature(cv::Rect& _objectBox, int _numFeature);
-    void sampleRect(const cv::Mat& _image, cv::Rect& _objectBox, float _rInner, float _rOuter, int _maxSampleNum, std::vector<cv::Rect>& _sampleBox);
-    void sampleRect(const cv::Mat& _image, cv::Rect& _objectBox, float _srw, std::vector<cv::Rect>& _sampleBox);
-    void getFeatureValue(cv::Mat& _imageIntegral, std::vector<cv::Rect>& _sampleBox, cv::Mat& _sampleFeatureValue);
-    void classifierUpdate(cv::Mat& _sampleFeatureValue, std::vector<float>& _mu, std::vector<float>& _sigma, float _learnRate);
-    void radioClassifier(std::vector<float>& _muPos, std::vector<float>& _sigmaPos, std::vector<float>& _muNeg, std::vector<float>& _sigmaNeg,
-                         cv::Mat& _sampleFeatureValue, float& _radioMax, int& _radioMaxIndex);
-
+    cv::Mat sampleScores;
+    cv::Mat imageIntegral;                      // only computed if not provided by the frame representation
 };
 
 #endif/*FACE_RECOG_HAS_COMPRESSIVE*/
@@ -95,10 +95,18 @@
 #include "Tracks/ImageRep.h"
 #include "Trackers/ITracker.h"
 
+/* Precomputed data of a feature window size, shared by all trackers using the same size (read-only once created) */
+struct KCFWindowPlan
+{
+    cv::Size size;                  // feature channels size, optimal DFT size
+    cv::Mat hann;                   // cosine window applied to feature channels
+    cv::Mat labelSpectrum;          // DFT of the gaussian shaped regression target (complex)
+};
+
 class TrackerKCF final : public ITracker
 {
 public:
-    TrackerKCF(ConfigFile* configFile);
+    TrackerKCF(const ConfigFile* configFile);
     virtual ~TrackerKCF();
     TrackerKCF(const TrackerKCF& obj);              // copy constructor
     TrackerKCF & operator=(const TrackerKCF& T);    // assignment operator
@@ -106,7 +114,44 @@ public:
     virtual void reset() override;
     virtual cv::Rect track(const ImageRep& frame) override;
 private:
-    bool isInitialized;
+    static std::shared_ptr<const KCFWindowPlan> getPlan(const cv::Size& size, double outputSigma);
+    void updateLearner(const ImageRep& image, double rate);
+    void extractFeatures(const cv::Mat& image, double scale, std::vector<cv::Mat>& features);
+    void computeSpectra(const std::vector<cv::Mat>& features, std::vector<cv::Mat>& spectra, double& norm);
+    void gaussianCorrelation(const std::vector<cv::Mat>& spectraX, double normX,
+                             const std::vector<cv::Mat>& spectraZ, double normZ, cv::Mat& kernelSpectrum);
+    double detect(const ImageRep& image, double scale, cv::Point2f& displacement);
+    void copyModel(const TrackerKCF& obj);
+
+    // parameters
+    bool useHOG;
+    int cellSize;
+    int templateSize;
+    double padding;
+    double scaleStep;
+    double interpFactor;
+    double sigma;
+    double lambda;
+    double outputSigmaFactor;
+
+    // target state
+    cv::Point2f center;
+    cv::Size2f targetSize;          // size of target at initialization
+    double currentScale;            // scale of target relative to initialization
+    double templateScale;           // window pixels per template pixel at initialization scale
+    cv::Size templateSz;            // window size in template pixels
+    std::shared_ptr<const KCFWindowPlan> plan;
+
+    // learned model
+    std::vector<cv::Mat> modelFeatures;
+    std::vector<cv::Mat> modelSpectra;
+    double modelNorm;
+    cv::Mat alphaf;
+
+    // buffers reused across frames (sizes fixed by the plan)
+    cv::Mat patch, resizedPatch, floatPatch, gradX, gradY, magnitude, angle;
+    std::vector<cv::Mat> features, spectra;
+    cv::Mat crossSpectrum, productSpectrum, correlation, kernel, kernelSpectrum, responseSpectrum, response;
 };
 
 #endif/*FACE_RECOG_HAS_KCF*/
@@ -61,12 +61,13 @@
 #include "Tracks/LaRank.h"
 #include "Tracks/Kernels.h"
 #include "Tracks/HaarFeatures.h"
+#include "Tracks/MotionPredictor.h"
 #include "Trackers/ITracker.h"
 
 class TrackerSTRUCK final : public ITracker
 {
 public:
-    TrackerSTRUCK(ConfigFile* configFile);
+    TrackerSTRUCK(const ConfigFile* configFile);
     virtual ~TrackerSTRUCK();
     TrackerSTRUCK(const TrackerSTRUCK& obj);           // copy constructor
     TrackerSTRUCK &operator=(const TrackerSTRUCK& T);  // assignment operator
@@ -79,7 +80,10 @@ private:
     LaRank* m_pLearner;
     bool m_needsIntegralImage;
     bool m_needsIntegralHist;
+    MotionPredictor m_motion;       // search centre and radius prediction (if enabled)
+    std::vector<FloatRect> m_searchRects, m_updateRects;    // sample buffers reused across frames
     void updateLearner(const ImageRep& image);
+    bool searchBest(const ImageRep& image, const std::vector<FloatRect>& rects, FloatRect& best);
 };
 
 #endif/*FACE_RECOG_HAS_STRUCK*/
@@ -3,6 +3,7 @@
 
 #include "Utilities/Common.h"
 #include "Configs/ConfigFile.h"
+#include "Configs/ConfigStore.h"
 #include "Tracks/ImageRep.h"
 #include "Tracks/Track.h"
 
@@ -10,8 +11,9 @@ class Association
 {
 public:
 
-    Association(ConfigFile* config);
+    Association(const ConfigSnapshot& config);
     ~Association();
+    void configure(const ConfigSnapshot& config);   // new tracks share the snapshot
 
     void extendSet(std::vector<Track>& tracks, std::vector<cv::Rect>& detections);
     int computeCost(std::vector<Track>& tracks, std::vector<cv::Rect>& detections);
@@ -21,7 +23,7 @@ public:
                          std::vector<Track>& unmatched);
     void reduceSet(std::vector<Track>& tracks);
 private:
-    ConfigFile* _config;
+    ConfigSnapshot _config;
     int **costMatrix;
     int detTrackThresh;
     size_t m;
@@ -55,11 +55,14 @@
 
 #include "Utilities/Common.h"
 #include "Tracks/Rect.h"
+#include "Pipeline/FrameContext.h"
+#include <mutex>
 
 class ImageRep
 {
 public:
     ImageRep(const cv::Mat& rImage, bool computeIntegral, bool computeIntegralHists, bool colour = false);
+    ImageRep(const FrameContext& context);     // gray and integral images shared with the frame context (no copy)
 
     int Sum(const IntRect& rRect, int channel = 0) const;
     void Hist(const IntRect& rRect, Eigen::VectorXd& h) const;
@@ -67,6 +70,12 @@ public:
     inline const cv::Mat& getImage(int channel = 0) const { return m_images[channel]; }
     inline const cv::Mat& getColourImage() const { return colour_image; }
     inline const IntRect& getRect() const { return m_rect; }
+    inline bool hasIntegralImage() const { return !m_integralImages.empty(); }
+    inline const cv::Mat& getIntegralImage(int channel = 0) const { return m_integralImages[channel]; }   // CV_32S (rows+1 x cols+1)
+    // colour representations converted once per frame on first request, shared by all trackers (thread-safe)
+    // provided by the frame context when available
+    const cv::Mat& getHSVImage() const;
+    void backProject(const cv::Rect& window, const int* channels, const cv::Mat& hist, const float** ranges, cv::Mat& backProj) const;
 
 private:
     std::vector<cv::Mat> m_images;
@@ -75,6 +84,9 @@ private:
     std::vector<cv::Mat> m_integralHistImages;
     int m_channels;
     IntRect m_rect;
+    const FrameContext* m_context;
+    mutable std::once_flag m_hsvOnce;
+    mutable cv::Mat m_hsvImage;
 };
 
 #endif /*FACE_RECOG_IMAGE_REP_H*/
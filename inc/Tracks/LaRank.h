@@ -63,7 +63,7 @@ class LaRank
 {
 public:
 
-    LaRank(ConfigFile *conf, HaarFeatures features, Kernel kernel);
+    LaRank(const ConfigFile* conf, HaarFeatures features, Kernel kernel);
     ~LaRank();
     LaRank(const LaRank &obj);  // copy constructor
     LaRank & operator=(const LaRank &T); // assignment operator
@@ -93,7 +93,7 @@ private:
         cv::Mat image;
     };
 
-    ConfigFile *m_config;
+    const ConfigFile* m_config;
     HaarFeatures m_features;
     Kernel m_kernel;
 
@@ -0,0 +1,33 @@
+﻿#ifndef FACE_RECOG_MOTION_PREDICTOR_H
+#define FACE_RECOG_MOTION_PREDICTOR_H
+
+#include "Utilities/Common.h"
+
+/*
+    Constant velocity motion model of a track position (alpha-beta filter, steady state Kalman filter)
+
+    Predicts the next position from the filtered position and velocity, and keeps a running average of
+    the prediction errors to evaluate how predictable the motion is. The search radius derived from
+    that error shrinks while predictions are accurate and grows back as soon as they miss.
+*/
+class MotionPredictor
+{
+public:
+    MotionPredictor(float alpha = 0.75f, float beta = 0.25f);
+    void reset();
+    void initialize(const cv::Point2f& position);
+    cv::Point2f predict() const;                            // expected position on next frame
+    void update(const cv::Point2f& position);               // correct state with the found position
+    int getSearchRadius(int minRadius, int maxRadius) const;
+    inline bool isInitialized() const { return updates > 0; }
+
+private:
+    float alpha;                // position gain
+    float beta;                 // velocity gain
+    cv::Point2f position;
+    cv::Point2f velocity;
+    float meanError;            // running average of prediction error distances (pixels)
+    int updates;
+};
+
+#endif/*FACE_RECOG_MOTION_PREDICTOR_H*/
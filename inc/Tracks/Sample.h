@@ -89,7 +89,7 @@ public:
 
 private:
     const ImageRep& m_image;
-    std::vector<FloatRect> m_rects;
+    const std::vector<FloatRect>& m_rects;  // not copied, must outlive the sample
 };
 
 #endif /*FACE_RECOG_SAMPLE_H*/
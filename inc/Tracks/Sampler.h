@@ -55,11 +55,28 @@
 
 #include "Tracks/Rect.h"
 
+/*
+    Samples are generated from immutable offset tables computed once per parameters and shared by all tracks.
+    Pixel offsets are grouped in rows of equal 'dy' sorted by 'dx', so that samples inside the frame bounds
+    are obtained by clipping the spans of each row instead of testing every sample.
+*/
 class Sampler
 {
 public:
+    struct OffsetTable
+    {
+        struct Row { float dy; int begin, end; };   // offsets [begin,end[ of the row
+        std::vector<cv::Point2f> offsets;           // relative to centre sample (excluded)
+        std::vector<Row> rows;                      // only for pixel offsets
+    };
+
     static std::vector<FloatRect> RadialSamples(FloatRect centre, int radius, int nr, int nt);
     static std::vector<FloatRect> PixelSamples(FloatRect centre, int radius, bool halfSample = false);
+    // samples completely within bounds written to a reused buffer, centre sample first (always kept for radial samples)
+    static void RadialSamples(FloatRect centre, int radius, int nr, int nt, const IntRect& bounds, std::vector<FloatRect>& samples);
+    static void PixelSamples(FloatRect centre, int radius, bool halfSample, const IntRect& bounds, std::vector<FloatRect>& samples);
+    static const OffsetTable& RadialOffsets(int radius, int nr, int nt);
+    static const OffsetTable& PixelOffsets(int radius, bool halfSample);
 };
 
 #endif /*FACE_RECOG_SAMPLER_H*/
@@ -41,6 +41,7 @@
 
 #include "Utilities/Common.h"
 #include "Configs/ConfigFile.h"
+#include "Configs/ConfigStore.h"
 #include "Tracks/ImageRep.h"
 #include "Tracks/TrackROI.h"
 #include "Trackers/ITracker.h"
@@ -48,8 +49,8 @@
 class Track
 {
 public:
-    Track(ConfigFile* configFile);
-    Track(ConfigFile* configFile, const cv::Rect& rect, int trackNumber = -1);
+    Track(const ConfigSnapshot& configFile);
+    Track(const ConfigSnapshot& configFile, const cv::Rect& rect, int trackNumber = -1);
     Track(const Track&);
     Track& operator= (const Track& track);
     ~Track();
@@ -57,8 +58,8 @@ public:
     enum RecognizedState { UNKWOWN, CONSIDERED, RECOGNIZED };
 
     // getters
-    inline cv::Rect bbox() const                            { return getROI().getRect(); }
-    inline ROI getROI(size_t pos = 0) const                 { return _bboxes.getROI(pos); }
+    inline const cv::Rect& bbox() const                     { return _bboxes.getRect(); }     // empty if no ROI
+    inline const ROI& getROI(size_t pos = 0) const          { return _bboxes.getROI(pos); }
     inline int getTrackNumber() const                       { return _trackNumber; }
     inline int getCreateCount() const                       { return _createCount; }
     inline int getRemoveCount() const                       { return _removeCount; }
@@ -67,8 +68,8 @@ public:
     inline void setTrackNumber(int number)                  { _trackNumber = number; }
     inline void markMatched()                               { _isMatched = true; _removeCount = 0; } // if matched to detections, reset removal count
     inline void markNotMatched()                            { _isMatched = false; }
-    inline void insertROI(const ROI roi, size_t pos = 0)    { _bboxes.addROI(roi, pos); }   // add the ROI to the cumulated list at position or front
-    inline void updateROI(const ROI roi, size_t pos = 0)    { _bboxes.setROI(roi, pos); }   // modify the specified ROI (replace, not insert)
+    inline void insertROI(const ROI& roi, size_t pos = 0)   { _bboxes.addROI(roi, pos); }   // add the ROI to the cumulated list at position or front
+    inline void updateROI(const ROI& roi, size_t pos = 0)   { _bboxes.setROI(roi, pos); }   // modify the specified ROI (replace, not insert)
     inline void setTrackSize(int trackSize)                 { _bboxes.setTrackSize(trackSize); }
     inline void setCreateCount(const int count)             { _createCount = count; }
     inline void setRemoveCount(const int count)             { _removeCount = count; }
@@ -84,14 +85,18 @@ public:
     inline std::string getName()                            { return _recognizedPOIName; }
     inline void setValidateEyeDetection(bool valid = true)  { _isValidatedWithEyeDetection = valid; }
     inline bool isValidatedEyeDetection()                   { return _isValidatedWithEyeDetection; }
+    inline void setFrontalDetection(bool frontal = true)    { _isFrontalDetection = frontal; }
+    inline bool isFrontalDetection()                        { return _isFrontalDetection; }
     // operations
     void reInitTracking(const ImageRep& frame);
-    void track(const ImageRep& frame);
+    inline void track(const ImageRep& frame)                { trackWith<ITracker>(frame); }
+    template <class TrackerType>
+    void trackWith(const ImageRep& frame);                  // tracker known to be of the specified type (resolved statically if 'final')
     // shared config
-    void configCheckAndSet(ConfigFile* configFile);
+    void configCheckAndSet(const ConfigSnapshot& configFile);
 
 private:
-    ConfigFile* _config;
+    ConfigSnapshot _config;     // kept alive for the tracker as long as any copy of the track exists
     void resetTracker();
     int _trackNumber = -1;
     std::string _recognizedPOIName;
@@ -99,9 +104,27 @@ private:
     int _createCount;
     RecognizedState _recognizedState = UNKWOWN;
     bool _isValidatedWithEyeDetection;
+    bool _isFrontalDetection;   // last matched detection obtained from a frontal face model
     int _removeCount;
     std::shared_ptr<ITracker> _tracker;
     bool _isMatched;    // tells if matched to detection
 };
 
+template <class TrackerType>
+void Track::trackWith(const ImageRep& frame)
+{
+    const cv::Rect& b = bbox();
+    if ((b.width == 0) && (b.height == 0))
+    {
+        cout << "Error in track, the track has no bbox assigned" << endl;
+        return;
+    }
+    if (!_tracker->isInitialized())
+    {
+        cout << "Error in track, the track has no initialized tracker" << endl;
+        return;
+    }
+    insertROI(static_cast<TrackerType*>(_tracker.get())->track(frame));
+}
+
 #endif /* FACE_RECOG_TRACK_H */
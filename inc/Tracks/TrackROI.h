@@ -2,33 +2,37 @@
 #define FACE_RECOG_TRACK_ROI_H
 
 #include "Utilities/Common.h"
+#include <array>
 
 /* Bounding box containers for accumulation of ROIs and sub-ROIs
  *   Default position (-1) will put the ROI/sub-ROI at the start of the container's accumulated ROIs (most recent first)
  *   Otherwise, the specified position is overwritten with the new ROI/sub-ROI
- *   Sub-ROIs are saved under their corresponding parent ROI */
+ *   Sub-ROIs are saved under their corresponding parent ROI
+ *   Containers have a fixed capacity allocated once, the oldest ROI/sub-ROI is dropped when full */
 class ROI
 {
 public:
+    static const size_t maxSubROI = 4;  // sub-ROIs (eyes) kept per ROI
     // constructors
-    inline ROI() { }
-    inline ROI(cv::Rect roi) { setRect(roi); }
+    inline ROI() : _subCount(0) { }
+    inline ROI(cv::Rect roi) : _subCount(0) { setRect(roi); }
     // setters
     inline void setRect(cv::Rect roi) { _roi = roi; }
     inline void updateROI(cv::Rect roi) { _roiOriginal = _roi; setRect(roi); }
     void addSubRect(cv::Rect roi, size_t pos = 0);
     void setAllSubRect(std::vector<cv::Rect> vRect);
     // getters
-    inline cv::Rect getRect() const { return _roi; }
-    inline cv::Rect getOriginalRect() const { return isUpdatedROI() ? _roiOriginal : _roi; }
+    inline const cv::Rect& getRect() const { return _roi; }
+    inline const cv::Rect& getOriginalRect() const { return isUpdatedROI() ? _roiOriginal : _roi; }
     inline bool isUpdatedROI() const { return _roiOriginal.area() > 0; }
-    cv::Rect getSubRect(size_t pos = 0) const;
+    const cv::Rect& getSubRect(size_t pos = 0) const;
     std::vector<cv::Rect> getAllSubRect() const;
-    size_t countSubROI() const;
+    inline size_t countSubROI() const { return _subCount; }
 private:
-    cv::Rect _roi;                  // main ROI
-    cv::Rect _roiOriginal;          // retain the last version of main ROI
-    std::deque<cv::Rect> _subRoi;   // to contain sub-region of main ROI
+    cv::Rect _roi;                                      // main ROI
+    cv::Rect _roiOriginal;                              // retain the last version of main ROI
+    std::array<cv::Rect, maxSubROI> _subRoi;            // to contain sub-region of main ROI
+    size_t _subCount;
 };
 
 class TrackROI
@@ -42,17 +46,21 @@ public:
     // setters
     void setTrackSize(size_t trackSize);
     void addROI(cv::Rect roi, size_t pos = 0);  // insert before position, front by default
-    void addROI(ROI roi, size_t pos = 0);       // insert before position, front by default
+    void addROI(const ROI& roi, size_t pos = 0);// insert before position, front by default
     void setROI(cv::Rect, size_t pos = 0);      // update at position, latest (most recently added) by default
-    void setROI(ROI roi, size_t pos = 0);       // update at position, latest (most recently added) by default
+    void setROI(const ROI& roi, size_t pos = 0);// update at position, latest (most recently added) by default
     // getters
     inline size_t getTrackSize() const { return _trackSize; }
-    ROI getROI(size_t pos = 0) const;
-    cv::Rect getRect(size_t pos = 0) const;
-    size_t countROI() const;
+    const ROI& getROI(size_t pos = 0) const;    // throws if out of range
+    const cv::Rect& getRect(size_t pos = 0) const;  // empty rect if out of range
+    inline size_t countROI() const { return _count; }
 private:
-    inline void init(size_t trackSize) { _trackSize = trackSize; }
-    std::deque<ROI> _roiCumul;
+    void init(size_t trackSize);
+    inline ROI& at(size_t pos) { return _roiCumul[(_head + pos) % _trackSize]; }
+    inline const ROI& at(size_t pos) const { return _roiCumul[(_head + pos) % _trackSize]; }
+    std::vector<ROI> _roiCumul;     // ring buffer of '_trackSize' ROIs, most recent at '_head'
+    size_t _head;
+    size_t _count;
     size_t _trackSize;
 };
 
@@ -39,8 +39,9 @@ using namespace cv;
     #include <Python.h>
     #include "Python/PythonInterop.h"
     #include "Python/PyCvBoostConverter.h"
-    #define PY_INITIALIZE() Py_Initialize()
-    #define PY_FINALIZE()   Py_Finalize()
+    #include "Python/PythonSession.h"
+    #define PY_INITIALIZE() PythonSession::initialize()
+    #define PY_FINALIZE()   PythonSession::finalize()
 #else/*!FACE_RECOG_HAS_PYTHON*/
     #define PY_INITIALIZE()
     #define PY_FINALIZE()
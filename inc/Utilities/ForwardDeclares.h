@@ -10,6 +10,8 @@
 // Configurations & Generic
 class CameraType;
 class ConfigFile;
+class ConfigStore;
+class ThreadPool;
 
 // Tracks
 class Association;
@@ -19,6 +21,7 @@ class HaarFeatures;
 class ImageRep;
 class Kernels;
 class LaRank;
+class MotionPredictor;
 class ROI;
 class MultiSample;
 class Sample;
@@ -30,6 +33,10 @@ class TrackROI;
 class DetectorType;
 class IDetector;
 class EyeDetector;
+#if FACE_RECOG_HAS_DNN
+class FaceDetectionNetwork;
+class FaceDetectorDNN;
+#endif/*FACE_RECOG_HAS_DNN*/
 #if FACE_RECOG_HAS_FRCNN
 class FaceDetectorFRCNN;
 #endif/*FACE_RECOG_HAS_FRCNN*/
@@ -61,6 +68,8 @@ class TrackerSTRUCK;
 // Face Recognition
 class ClassifierType;
 class IClassifier;
+class GalleryIndex;
+class SharedCellHOG;
 #if FACE_RECOG_HAS_ESVM
 class ClassifierEnsembleESVM;
 #endif/*FACE_RECOG_HAS_ESVM*/
@@ -72,4 +81,18 @@ class TemplateMatcher;
 class ClassifierEnsembleTM;
 #endif/*FACE_RECOG_HAS_TM*/
 
+// Pipeline
+class DetectionScheduler;
+class FrameContext;
+class FrameSequenceReader;
+class LoadSheddingScheduler;
+class OutputWriter;
+class IPipeline;
+class ProbeExtractor;
+class RecognitionScheduler;
+class SequenceEvaluator;
+class StreamProcessor;
+class StreamScheduler;
+class StreamSource;
+
 #endif/*FACE_RECOG_FORWARD_DECLARES_H*/
@@ -0,0 +1,52 @@
+﻿#ifndef FACE_RECOG_THREAD_POOL_H
+#define FACE_RECOG_THREAD_POOL_H
+
+#include "Utilities/Common.h"
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+/*
+    Work-stealing pool of worker threads
+
+    Each worker owns a queue of tasks processed in submission order (FIFO), an idle worker steals
+    the most recently queued task of another worker. Tasks submitted from within a worker are queued
+    on that same worker to preserve data locality, others are distributed in round-robin.
+*/
+class ThreadPool
+{
+public:
+    typedef std::function<void()> Task;
+
+    ThreadPool(size_t workerCount = 0, int ompThreadsPerWorker = 1);   // 0 workers = hardware concurrency
+    ~ThreadPool();
+    void submit(Task task);
+    void wait();                                                        // block until all submitted tasks are completed
+    inline size_t workerCount() const { return workers.size(); }
+    int currentWorkerIndex() const;                                     // index of the calling worker, -1 if not one of this pool
+
+private:
+    struct WorkerQueue
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+    void run(size_t workerIndex);
+    bool popTask(size_t workerIndex, Task& task);
+
+    std::vector<std::thread> workers;
+    std::vector<std::unique_ptr<WorkerQueue> > queues;
+    std::atomic<size_t> nextQueue;
+    std::mutex stateMutex;
+    std::condition_variable taskAvailable;
+    std::condition_variable tasksCompleted;
+    size_t queuedTasks;                     // tasks waiting in any queue
+    size_t pendingTasks;                    // tasks queued or running
+    std::exception_ptr taskError;           // first exception raised by a task, rethrown by 'wait'
+    bool stopping;
+    int ompThreads;
+};
+
+#endif/*FACE_RECOG_THREAD_POOL_H*/
@@ -34,6 +34,7 @@ void checkBoundaries(vector<Track>& trackList, int windowWidth, int windowHeight
 string rectPointCoordinates(const Rect& r, const string& sep = ",");
 double rectDist(const Rect& r1, const Rect& r2);
 void saveTrackROIToDisk(const Rect& roi, const FACE_RECOG_MAT& image, const string& label, int trackNumber, int desiredSize, const string& dirPath);
+void saveTrackROIImage(const Mat& roiImage, const string& label, int trackNumber, const string& dirPath);
 bool createDirIfNotExist(const string& dirName);
 bool prepareFrameFileNames(vector<string>& fileNames, const string& framesRegexPath);
 bool prepareTestSequences(vector<vector<string> >& sequenceFileNames, vector<string>& sequenceRegexPaths, const string& testFilePath);
@@ -38,8 +38,9 @@ ClassifierEnsembleESVM::ClassifierEnsembleESVM(const std::vector<std::vector<FAC
         EoESVM->saveModels(modelsFileDir);
 }
 
-std::vector<double> ClassifierEnsembleESVM::predict(const FACE_RECOG_MAT& roi)
+std::vector<double> ClassifierEnsembleESVM::predict(const FACE_RECOG_MAT& roi) const
 {
+    std::lock_guard<std::mutex> lock(predictMutex);
     return EoESVM->predict(GET_MAT(roi, ACCESS_READ));
 }
 
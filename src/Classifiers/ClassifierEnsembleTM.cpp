@@ -17,14 +17,49 @@ void ClassifierEnsembleTM::initialise()
 
 ClassifierEnsembleTM::ClassifierEnsembleTM(const std::vector<std::vector<FACE_RECOG_MAT>>& positiveROIs, const std::string negativeFileDir,
                                            const std::vector<std::string>& positiveIDs,
-                                           const std::vector<std::vector<FACE_RECOG_MAT>>& additionalNegativeROIs)
+                                           const std::vector<std::vector<FACE_RECOG_MAT>>& additionalNegativeROIs, bool useSharedCellHOG)
 {
-    TM.reset(new TemplateMatcher(positiveROIs, negativeFileDir, positiveIDs, additionalNegativeROIs));
+    TM.reset(new TemplateMatcher(positiveROIs, negativeFileDir, positiveIDs, additionalNegativeROIs, useSharedCellHOG));
 }
 
-std::vector<double> ClassifierEnsembleTM::predict(const FACE_RECOG_MAT& roi)
+void ClassifierEnsembleTM::setGalleryIndex(size_t shortlistSize, int listCount, int probeCount, size_t exactMaxSize)
+{
+    TM->buildGalleryIndex(shortlistSize, listCount, probeCount, exactMaxSize);
+}
+
+void ClassifierEnsembleTM::setQuantization(TemplateMatcher::Quantization mode)
+{
+    TM->setQuantization(mode);
+}
+
+void ClassifierEnsembleTM::releaseExactTemplates()
+{
+    TM->releaseExactTemplates();
+}
+
+TemplateQuantizationReport ClassifierEnsembleTM::evaluateQuantization(const std::vector<FACE_RECOG_MAT>& probes)
+{
+    return TM->evaluateQuantization(probes);
+}
+
+double ClassifierEnsembleTM::evaluateBatchScoring(const std::vector<FACE_RECOG_MAT>& probes) const
+{
+    return TM->evaluateBatchScoring(probes);
+}
+
+cv::Size ClassifierEnsembleTM::getProbeSize() const
+{
+    return TM->getImageSize();
+}
+
+std::vector<double> ClassifierEnsembleTM::predict(const FACE_RECOG_MAT& roi) const
 {
     return TM->predict(roi);
 }
 
+std::vector<std::vector<double> > ClassifierEnsembleTM::predictBatch(const std::vector<FACE_RECOG_MAT>& rois) const
+{
+    return TM->predict(rois);
+}
+
 #endif/*FACE_RECOG_HAS_TM*/
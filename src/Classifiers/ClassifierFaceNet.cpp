@@ -10,18 +10,17 @@ ClassifierFaceNet::ClassifierFaceNet()
     filePath = rootFaceNet + "src/compare_cpp.py";  //"/home/livia/code/facerecog/python/facenet/src/compare_cpp.py";
     pyFuncInit = "compare_init";
     pyFuncPredict = "main";
+    pyFuncHandle = PythonSession::instance().loadFunction(filePath, pyFuncPredict, pyFuncInit);
 }
 
 ClassifierFaceNet::~ClassifierFaceNet() { }
 
-std::vector<double> ClassifierFaceNet::predict(const FACE_RECOG_MAT& roi)
+std::vector<double> ClassifierFaceNet::predict(const FACE_RECOG_MAT& roi) const
 {
-    std::vector<bp::object> args;
-    bp::object res = callPyFuncFromFile(pyFuncInit, filePath, args);
-
-    THROW("FUNCTION INCOMPLETE - PARTIAL DONE");
-
-    return std::vector<double> {1, 2, 3};
+    cv::Mat scores = PythonSession::instance().call(pyFuncHandle, GET_MAT(roi, ACCESS_READ));
+    if (scores.empty())
+        return std::vector<double>();
+    return std::vector<double>(scores.begin<double>(), scores.end<double>());
 }
 
 #endif/*FACE_RECOG_HAS_FACE_NET*/
@@ -0,0 +1,90 @@
+﻿#include "Classifiers/GalleryIndex.h"
+#include "FaceRecog.h"
+
+void GalleryIndex::build(const std::vector<FeatureVector>& descriptorVectors, const std::vector<size_t>& descriptorLabels,
+                         int listCount, int nProbes)
+{
+    size_t nDescriptors = descriptorVectors.size();
+    ASSERT_LOG(nDescriptors > 0, "Gallery index requires at least one descriptor");
+    ASSERT_LOG(descriptorLabels.size() == nDescriptors, "Gallery index descriptors and labels count mismatch");
+
+    size_t nFeatures = descriptorVectors[0].size();
+    cv::Mat descriptors = cv::Mat((int)nDescriptors, (int)nFeatures, CV_32F);
+    for (size_t d = 0; d < nDescriptors; ++d) {
+        ASSERT_LOG(descriptorVectors[d].size() == nFeatures, "Gallery index descriptors dimension mismatch");
+        float* row = descriptors.ptr<float>((int)d);
+        for (size_t f = 0; f < nFeatures; ++f)
+            row[f] = (float)descriptorVectors[d][f];
+    }
+    labels = descriptorLabels;
+    labelCount = *std::max_element(labels.begin(), labels.end()) + 1;
+
+    // default to square root of gallery size, which balances centroid and list scanning costs
+    if (listCount <= 0)
+        listCount = (int)std::round(std::sqrt((double)nDescriptors));
+    listCount = std::max(1, std::min(listCount, (int)nDescriptors));
+    probeCount = std::max(1, std::min(nProbes, listCount));
+
+    cv::Mat assignments;
+    cv::TermCriteria criteria(cv::TermCriteria::COUNT + cv::TermCriteria::EPS, 20, 1e-3);
+    cv::kmeans(descriptors, listCount, assignments, criteria, 1, cv::KMEANS_PP_CENTERS, centroids);
+    lists = std::vector<std::vector<int> >(listCount);
+    for (int d = 0; d < assignments.rows; ++d)
+        lists[assignments.at<int>(d)].push_back(d);
+
+    // full precision descriptors are only required for clustering
+    double minValue, maxValue;
+    cv::minMaxLoc(descriptors, &minValue, &maxValue);
+    codeOffset = minValue;
+    codeScale = maxValue > minValue ? (maxValue - minValue) / 255.0 : 1.0;
+    descriptors.convertTo(codes, CV_8U, 1.0 / codeScale, -codeOffset / codeScale);
+}
+
+cv::Mat GalleryIndex::encode(const FeatureVector& descriptor) const
+{
+    cv::Mat values(1, (int)descriptor.size(), CV_32F);
+    for (int f = 0; f < values.cols; ++f)
+        values.at<float>(f) = (float)descriptor[f];
+    cv::Mat encoded;
+    values.convertTo(encoded, CV_8U, 1.0 / codeScale, -codeOffset / codeScale);
+    return encoded;
+}
+
+std::vector<size_t> GalleryIndex::search(const FeatureVector& probe, size_t shortlistSize) const
+{
+    ASSERT_LOG(!empty(), "Gallery index searched before being built");
+    ASSERT_LOG(probe.size() == (size_t)codes.cols, "Gallery index probe dimension mismatch");
+    cv::Mat probeRow(1, codes.cols, CV_32F);
+    for (int f = 0; f < codes.cols; ++f)
+        probeRow.at<float>(f) = (float)probe[f];
+    cv::Mat probeCode = encode(probe);
+
+    // nearest lists to visit
+    std::vector<std::pair<double, int> > listDistances(centroids.rows);
+    for (int l = 0; l < centroids.rows; ++l)
+        listDistances[l] = std::make_pair(cv::norm(probeRow, centroids.row(l), cv::NORM_L2SQR), l);
+    std::partial_sort(listDistances.begin(), listDistances.begin() + probeCount, listDistances.end());
+
+    // nearest descriptor of each label within visited lists
+    std::vector<double> labelDistances(labelCount, DBL_MAX);
+    for (int p = 0; p < probeCount; ++p) {
+        const std::vector<int>& list = lists[listDistances[p].second];
+        for (size_t i = 0; i < list.size(); ++i) {
+            double dist = cv::norm(probeCode, codes.row(list[i]), cv::NORM_L2SQR);
+            size_t label = labels[list[i]];
+            labelDistances[label] = std::min(labelDistances[label], dist);
+        }
+    }
+
+    std::vector<std::pair<double, size_t> > candidates;
+    for (size_t label = 0; label < labelCount; ++label)
+        if (labelDistances[label] < DBL_MAX)
+            candidates.push_back(std::make_pair(labelDistances[label], label));
+    size_t nShortlist = std::min(shortlistSize, candidates.size());
+    std::partial_sort(candidates.begin(), candidates.begin() + nShortlist, candidates.end());
+
+    std::vector<size_t> shortlist(nShortlist);
+    for (size_t s = 0; s < nShortlist; ++s)
+        shortlist[s] = candidates[s].second;
+    return shortlist;
+}
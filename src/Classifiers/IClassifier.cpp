@@ -1,6 +1,14 @@
 ﻿#include "Classifiers/IClassifier.h"
 #include "FaceRecog.h"
 
+std::vector<std::vector<double> > IClassifier::predictBatch(const std::vector<FACE_RECOG_MAT>& rois) const
+{
+    std::vector<std::vector<double> > predictions(rois.size());
+    for (size_t i = 0; i < rois.size(); ++i)
+        predictions[i] = predict(rois[i]);
+    return predictions;
+}
+
 std::shared_ptr<IClassifier> buildSpecializedClassifier(const ConfigFile& config,
                                                         const std::vector<std::vector<FACE_RECOG_MAT>>& positiveROIs,
                                                         const std::vector<std::string>& positiveIDs,
@@ -11,8 +19,19 @@ std::shared_ptr<IClassifier> buildSpecializedClassifier(const ConfigFile& config
     #ifdef FACE_RECOG_HAS_TM
     if (classifierType == ClassifierType::ENSEMBLE_TM)
     {
-        if (positiveROIs.size() > 0)
-            classifier.reset(new ClassifierEnsembleTM(positiveROIs, config.NEGDir, positiveIDs, additionalNegativeROIs));
+        if (positiveROIs.size() > 0) {
+            std::shared_ptr<ClassifierEnsembleTM> tm(new ClassifierEnsembleTM(positiveROIs, config.NEGDir, positiveIDs, additionalNegativeROIs,
+                                                                              config.useSharedCellHOG));
+            if (config.galleryIndex)
+                tm->setGalleryIndex(config.galleryShortlistSize, config.galleryIndexLists, config.galleryIndexProbes, config.galleryExactMaxSize);
+            // full precision templates are released by the caller once quantization is evaluated if requested
+            if (config.templateQuantization != TemplateMatcher::NONE) {
+                tm->setQuantization((TemplateMatcher::Quantization)config.templateQuantization);
+                if (!config.templateQuantizationCheck)
+                    tm->releaseExactTemplates();
+            }
+            classifier = tm;
+        }
         else
             classifier.reset(new ClassifierEnsembleTM());
     }
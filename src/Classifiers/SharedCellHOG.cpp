@@ -0,0 +1,120 @@
+﻿#include "Classifiers/SharedCellHOG.h"
+#include "FaceRecog.h"
+
+// clipping of normalized block values (L2-Hys)
+#define BLOCK_CLIP_VALUE 0.2f
+
+void SharedCellHOG::initialize(cv::Size imageSize, cv::Size patchCounts, cv::Size blockSize, cv::Size blockStride, cv::Size cellSize, int nBins)
+{
+    ASSERT_LOG(nBins > 0, "HOG bin count must be greater than zero");
+    ASSERT_LOG(patchCounts.area() > 0 && cellSize.area() > 0 && blockSize.area() > 0 && blockStride.area() > 0,
+               "HOG patch, cell, block and stride sizes must be greater than zero");
+    ASSERT_LOG(imageSize.width % patchCounts.width == 0 && imageSize.height % patchCounts.height == 0,
+               "HOG image size not divisible in patches");
+    cv::Size patchSize(imageSize.width / patchCounts.width, imageSize.height / patchCounts.height);
+    ASSERT_LOG(patchSize.width % cellSize.width == 0 && patchSize.height % cellSize.height == 0,
+               "HOG patch size not divisible in cells");
+
+    this->imageSize = imageSize;
+    this->patchCounts = patchCounts;
+    this->blockSize = blockSize;
+    this->blockStride = blockStride;
+    this->cellSize = cellSize;
+    this->nBins = nBins;
+    cellCounts = cv::Size(imageSize.width / cellSize.width, imageSize.height / cellSize.height);
+    patchCells = cv::Size(patchSize.width / cellSize.width, patchSize.height / cellSize.height);
+    ASSERT_LOG(patchCells.width >= blockSize.width && patchCells.height >= blockSize.height, "HOG block larger than patch");
+    patchBlocks = cv::Size((patchCells.width - blockSize.width) / blockStride.width + 1,
+                           (patchCells.height - blockSize.height) / blockStride.height + 1);
+    featureCount = (size_t)(patchBlocks.area() * blockSize.area() * nBins);
+}
+
+void SharedCellHOG::computeCells(const cv::Mat& image, std::vector<float>& cells) const
+{
+    // centered [-1,0,1] gradients over the whole image, unsigned orientations
+    cv::Mat gray, dx, dy, magnitude, angle;
+    if (image.channels() > 1)
+        cv::cvtColor(image, gray, CV_BGR2GRAY);
+    else
+        gray = image;
+    if (gray.size() != imageSize)
+        cv::resize(gray, gray, imageSize, 0, 0, cv::INTER_AREA);
+    gray.convertTo(gray, CV_32F);
+    cv::Sobel(gray, dx, CV_32F, 1, 0, 1);
+    cv::Sobel(gray, dy, CV_32F, 0, 1, 1);
+    cv::cartToPolar(dx, dy, magnitude, angle, true);
+
+    // magnitude voted into the two nearest orientation bins of the pixel cell
+    cells.assign((size_t)(cellCounts.area() * nBins), 0.0f);
+    float binWidth = 180.0f / (float)nBins;
+    int cellRows = cellCounts.height * cellSize.height;
+    int cellCols = cellCounts.width * cellSize.width;
+    for (int y = 0; y < cellRows; ++y) {
+        const float* mag = magnitude.ptr<float>(y);
+        const float* ang = angle.ptr<float>(y);
+        float* cellRow = &cells[(size_t)((y / cellSize.height) * cellCounts.width * nBins)];
+        for (int x = 0; x < cellCols; ++x) {
+            float orientation = ang[x] >= 180.0f ? ang[x] - 180.0f : ang[x];
+            float bin = orientation / binWidth - 0.5f;
+            int bin0 = (int)std::floor(bin);
+            float weight1 = bin - (float)bin0;
+            int bin1 = bin0 + 1;
+            bin0 = (bin0 + nBins) % nBins;
+            bin1 = bin1 % nBins;
+            float* hist = cellRow + (x / cellSize.width) * nBins;
+            hist[bin0] += mag[x] * (1.0f - weight1);
+            hist[bin1] += mag[x] * weight1;
+        }
+    }
+}
+
+std::vector<FeatureVector> SharedCellHOG::compute(const cv::Mat& image) const
+{
+    ASSERT_LOG(featureCount > 0, "HOG not initialized");
+    std::vector<float> cells;
+    computeCells(image, cells);
+
+    size_t nPatches = getPatchCount();
+    size_t blockLength = (size_t)(blockSize.area() * nBins);
+    std::vector<FeatureVector> descriptors(nPatches);
+    std::vector<float> block(blockLength);
+    for (int py = 0; py < patchCounts.height; ++py) {
+        for (int px = 0; px < patchCounts.width; ++px) {
+            FeatureVector& descriptor = descriptors[py * patchCounts.width + px];
+            descriptor.reserve(featureCount);
+            for (int by = 0; by < patchBlocks.height; ++by) {
+                for (int bx = 0; bx < patchBlocks.width; ++bx) {
+                    // slice block cells from shared grid
+                    int cellY = py * patchCells.height + by * blockStride.height;
+                    int cellX = px * patchCells.width + bx * blockStride.width;
+                    size_t b = 0;
+                    for (int cy = 0; cy < blockSize.height; ++cy)
+                        for (int cx = 0; cx < blockSize.width; ++cx)
+                            for (int h = 0; h < nBins; ++h)
+                                block[b++] = cells[(size_t)(((cellY + cy) * cellCounts.width + cellX + cx) * nBins + h)];
+
+                    // L2-Hys block normalization
+                    for (int pass = 0; pass < 2; ++pass) {
+                        float sumSquares = 0;
+                        for (size_t i = 0; i < blockLength; ++i)
+                            sumSquares += block[i] * block[i];
+                        float scale = 1.0f / (std::sqrt(sumSquares) + 1e-3f);
+                        for (size_t i = 0; i < blockLength; ++i)
+                            block[i] = pass == 0 ? std::min(block[i] * scale, BLOCK_CLIP_VALUE) : block[i] * scale;
+                    }
+                    descriptor.insert(descriptor.end(), block.begin(), block.end());
+                }
+            }
+        }
+    }
+    return descriptors;
+}
+
+std::vector<std::vector<FeatureVector> > SharedCellHOG::compute(const std::vector<cv::Mat>& images) const
+{
+    std::vector<std::vector<FeatureVector> > descriptors(images.size());
+    #pragma omp parallel for
+    for (omp_size_t i = 0; i < images.size(); ++i)
+        descriptors[i] = compute(images[i]);
+    return descriptors;
+}
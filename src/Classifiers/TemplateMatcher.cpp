@@ -2,11 +2,66 @@
 
 #include "Classifiers/TemplateMatcher.h"
 #include "FaceRecog.h"
+#include <opencv2/core/hal/intrin.hpp>
+#include <cstring>
+
+// squared euclidean distance of int8 codes accumulated as integers
+static int squaredDistanceInt8(const uchar* a, const uchar* b, int count)
+{
+    int i = 0, sum = 0;
+    #if CV_SIMD128
+    cv::v_int32x4 acc = cv::v_setzero_s32();
+    for (; i <= count - 16; i += 16) {
+        cv::v_uint16x8 d0, d1;
+        cv::v_expand(cv::v_absdiff(cv::v_load(a + i), cv::v_load(b + i)), d0, d1);
+        cv::v_int16x8 s0 = cv::v_reinterpret_as_s16(d0), s1 = cv::v_reinterpret_as_s16(d1);
+        acc += cv::v_dotprod(s0, s0) + cv::v_dotprod(s1, s1);
+    }
+    sum = cv::v_reduce_sum(acc);
+    #endif
+    for (; i < count; ++i) {
+        int d = (int)a[i] - (int)b[i];
+        sum += d * d;
+    }
+    return sum;
+}
+
+// IEEE half precision bits (as written by 'cv::convertFp16') to float
+static inline float halfToFloat(ushort h)
+{
+    unsigned int sign = (unsigned int)(h & 0x8000) << 16;
+    unsigned int exponent = (h >> 10) & 0x1F;
+    unsigned int mantissa = h & 0x3FF;
+    unsigned int bits;
+    if (exponent == 0) {        // zero or subnormal
+        float value = std::ldexp((float)mantissa, -24);
+        return sign ? -value : value;
+    }
+    if (exponent == 0x1F)       // infinity or NaN
+        bits = sign | 0x7F800000 | (mantissa << 13);
+    else
+        bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// squared euclidean distance of a float probe against fp16 template values, decoded on the fly
+static double squaredDistanceFp16(const float* probe, const ushort* templateValues, int count)
+{
+    double sum = 0;
+    for (int i = 0; i < count; ++i) {
+        double d = (double)probe[i] - (double)halfToFloat(templateValues[i]);
+        sum += d * d;
+    }
+    return sum;
+}
 
 TemplateMatcher::TemplateMatcher(const std::vector<std::vector<FACE_RECOG_MAT>>& positiveROIs, const std::string negativeFileDir,
                                  const std::vector<std::string>& positiveIDs,
-                                 const std::vector<std::vector<FACE_RECOG_MAT>>& additionalNegativeROIs)
+                                 const std::vector<std::vector<FACE_RECOG_MAT>>& additionalNegativeROIs, bool useSharedCellHOG)
 {
+    useSharedHOG = useSharedCellHOG;
     setConstants();
 
     // add ID as indexes if omitted or not matching dimensions
@@ -27,6 +82,15 @@ TemplateMatcher::TemplateMatcher(const std::vector<std::vector<FACE_RECOG_MAT>>&
     for (size_t p = 0; p < nPatches; ++p)
         DataFile::readSampleDataFile(negativeFileDir + "negatives-hog-patch" + std::to_string(p) +
                                      sampleFileExt, negativeSamples[p], sampleFileFormat);
+    if (useSharedHOG) {
+        bool matchingNegatives = true;
+        for (size_t p = 0; p < nPatches; ++p)
+            matchingNegatives &= negativeSamples[p].empty() || negativeSamples[p][0].size() == sharedHog.getFeatureCount();
+        ASSERT_WARN(matchingNegatives, "Negative HOG samples dimensions not matching shared cell HOG, ignored for features normalization");
+        if (!matchingNegatives)
+            for (size_t p = 0; p < nPatches; ++p)
+                negativeSamples[p].clear();
+    }
 
     // get positive sample representations
     size_t dimsPatchPositive[3]{ nPatches, nPositives, 0 };
@@ -36,6 +100,17 @@ TemplateMatcher::TemplateMatcher(const std::vector<std::vector<FACE_RECOG_MAT>>&
         size_t nRepresentations = positiveROIs[pos].size();
         for (size_t p = 0; p < nPatches; ++p)
             patchTemplates[p][pos] = std::vector<FeatureVector>(nRepresentations);
+        if (useSharedHOG) {
+            // all representations of the positive in a single batch
+            std::vector<cv::Mat> images(nRepresentations);
+            for (size_t r = 0; r < nRepresentations; ++r)
+                images[r] = GET_MAT(imPreprocess(positiveROIs[pos][r], imageSize, cv::Size(1, 1))[0], ACCESS_READ);
+            std::vector<std::vector<FeatureVector> > features = sharedHog.compute(images);
+            for (size_t r = 0; r < nRepresentations; ++r)
+                for (size_t p = 0; p < nPatches; ++p)
+                    patchTemplates[p][pos][r] = features[r][p];
+            continue;
+        }
         for (size_t r = 0; r < nRepresentations; ++r) {
             std::vector<FACE_RECOG_MAT> patches = imPreprocess(positiveROIs[pos][r], imageSize, patchCounts);
             for (size_t p = 0; p < nPatches; ++p) {
@@ -45,7 +120,39 @@ TemplateMatcher::TemplateMatcher(const std::vector<std::vector<FACE_RECOG_MAT>>&
         }
     }
 
+    // first quantized template row of each positive (representations are contiguous)
+    templateRowStarts = std::vector<size_t>(nPositives + 1, 0);
+    for (size_t pos = 0; pos < nPositives; ++pos)
+        templateRowStarts[pos + 1] = templateRowStarts[pos] + positiveROIs[pos].size();
+
     updateNormFeatures(patchTemplates, negativeSamples);
+    packTemplates();
+}
+
+void TemplateMatcher::packTemplates()
+{
+    // contiguous double precision templates and squared norms per patch for batched distances, matching 'scoreTemplates'
+    // up to the rounding of the expanded distance form (see 'evaluateBatchScoring')
+    size_t nPatches = getPatchCount();
+    size_t nPositives = getPositiveCount();
+    int nRows = (int)templateRowStarts[nPositives];
+    packedTemplates = std::vector<cv::Mat>(nPatches);
+    packedSquaredNorms = std::vector<cv::Mat>(nPatches);
+    for (size_t p = 0; p < nPatches; ++p) {
+        for (size_t pos = 0; pos < nPositives; ++pos) {
+            for (size_t r = 0; r < patchTemplates[p][pos].size(); ++r) {
+                cv::Mat row = featuresToRow(patchTemplates[p][pos][r], CV_64F);
+                if (packedTemplates[p].empty())
+                    packedTemplates[p] = cv::Mat(nRows, row.cols, CV_64F);
+                row.copyTo(packedTemplates[p].row((int)(templateRowStarts[pos] + r)));
+            }
+        }
+        if (packedTemplates[p].empty())
+            continue;
+        cv::Mat squared = packedTemplates[p].mul(packedTemplates[p]);
+        cv::reduce(squared, packedSquaredNorms[p], 1, CV_REDUCE_SUM, CV_64F);
+        packedSquaredNorms[p] = packedSquaredNorms[p].reshape(1, 1);
+    }
 }
 
 void TemplateMatcher::setConstants()
@@ -57,6 +164,8 @@ void TemplateMatcher::setConstants()
     cellSize = cv::Size(2, 2);
     nBins = 3;
     hog.initialize(imageSize, blockSize, blockStride, cellSize, nBins);
+    if (useSharedHOG)
+        sharedHog.initialize(imageSize, patchCounts, blockSize, blockStride, cellSize, nBins);
 
     sampleFileExt = ".bin";
     sampleFileFormat = BINARY;
@@ -87,29 +196,170 @@ void TemplateMatcher::updateNormFeatures(const xstd::mvector<3, FeatureVector>&
     }
 }
 
-std::vector<double> TemplateMatcher::predict(const FACE_RECOG_MAT& roi)
+void TemplateMatcher::buildGalleryIndex(size_t shortlistSize, int listCount, int probeCount, size_t exactMaxSize)
 {
+    size_t nPositives = getPositiveCount();
+    galleryShortlistSize = 0;
+    galleryIndex = GalleryIndex();
+    if (nPositives <= exactMaxSize || shortlistSize == 0 || shortlistSize >= nPositives)
+        return;     // exhaustive scoring remains cheaper or equivalent
+    ASSERT_LOG(hasExactTemplates, "Full precision templates required to build gallery index");
+
+    size_t nPatches = getPatchCount();
+    std::vector<FeatureVector> descriptors;
+    std::vector<size_t> labels;
+    for (size_t pos = 0; pos < nPositives; ++pos) {
+        for (size_t r = 0; r < patchTemplates[0][pos].size(); ++r) {
+            std::vector<FeatureVector> patchFeatures(nPatches);
+            for (size_t p = 0; p < nPatches; ++p)
+                patchFeatures[p] = patchTemplates[p][pos][r];
+            descriptors.push_back(concatPatchFeatures(patchFeatures));
+            labels.push_back(pos);
+        }
+    }
+    galleryIndex.build(descriptors, labels, listCount, probeCount);
+    galleryShortlistSize = shortlistSize;
+}
+
+std::vector<double> TemplateMatcher::predict(const FACE_RECOG_MAT& roi) const
+{
+    return scoreTemplates(computeProbeFeatures(roi), quantization != NONE);
+}
+
+std::vector<std::vector<double> > TemplateMatcher::predict(const std::vector<FACE_RECOG_MAT>& rois) const
+{
+    size_t nProbes = rois.size();
+    std::vector<std::vector<FeatureVector> > probeFeatures = computeProbeFeatures(rois);
+    std::vector<std::vector<double> > probeScores(nProbes);
+
+    // shortlisted or quantized templates are scored per probe
+    if (quantization != NONE || (galleryShortlistSize > 0 && !galleryIndex.empty()) || packedTemplates.empty()) {
+        for (size_t i = 0; i < nProbes; ++i)
+            probeScores[i] = scoreTemplates(probeFeatures[i], quantization != NONE);
+        return probeScores;
+    }
+
     size_t nPatches = getPatchCount();
     size_t nPositives = getPositiveCount();
+    int nRows = (int)templateRowStarts[nPositives];
+    cv::Mat rowScores = cv::Mat::zeros((int)nProbes, nRows, CV_64F);   // [probe][representation] sum of patch similarities
+    cv::Mat probes, distances;
+    for (size_t p = 0; p < nPatches; ++p)
+    {
+        if (packedTemplates[p].empty())
+            continue;
+        int nFeatures = packedTemplates[p].cols;
+        probes.create((int)nProbes, nFeatures, CV_64F);
+        for (size_t i = 0; i < nProbes; ++i)
+            featuresToRow(probeFeatures[i][p], CV_64F).copyTo(probes.row((int)i));
+
+        // squared distances |x|^2 + |t|^2 - 2x.t with products of all probes and templates from a single GEMM,
+        // in double precision as the per probe scoring so that results do not depend on the batch composition
+        cv::gemm(probes, packedTemplates[p], -2.0, cv::noArray(), 0.0, distances, cv::GEMM_2_T);
+        double sqrtFeatures = std::sqrt((double)nFeatures);
+        const double* templateNorms = packedSquaredNorms[p].ptr<double>(0);
+        for (int i = 0; i < (int)nProbes; ++i) {
+            double probeNorm = probes.row(i).dot(probes.row(i));
+            const double* dist = distances.ptr<double>(i);
+            double* score = rowScores.ptr<double>(i);
+            for (int row = 0; row < nRows; ++row)
+                score[row] += 1 - std::sqrt(std::max(dist[row] + probeNorm + templateNorms[row], 0.0)) / sqrtFeatures;
+        }
+    }
+
+    // fusion per positive, averaged over patches and representations
+    for (size_t i = 0; i < nProbes; ++i) {
+        probeScores[i] = std::vector<double>(nPositives, 0.0);
+        const double* score = rowScores.ptr<double>((int)i);
+        for (size_t pos = 0; pos < nPositives; ++pos) {
+            size_t nRepresentations = templateRowStarts[pos + 1] - templateRowStarts[pos];
+            for (size_t row = templateRowStarts[pos]; row < templateRowStarts[pos + 1]; ++row)
+                probeScores[i][pos] += score[row] / (double)nPatches;
+            if (nRepresentations > 0)
+                probeScores[i][pos] /= (double)nRepresentations;
+        }
+    }
+    return probeScores;
+}
+
+std::vector<std::vector<FeatureVector> > TemplateMatcher::computeProbeFeatures(const std::vector<FACE_RECOG_MAT>& rois) const
+{
+    size_t nProbes = rois.size();
+    std::vector<std::vector<FeatureVector> > probeFeatures(nProbes);
+    if (!useSharedHOG) {
+        for (size_t i = 0; i < nProbes; ++i)
+            probeFeatures[i] = computeProbeFeatures(rois[i]);
+        return probeFeatures;
+    }
+
+    // shared cell grids of all probes computed in a single batch
+    size_t nPatches = getPatchCount();
+    std::vector<cv::Mat> images(nProbes);
+    for (size_t i = 0; i < nProbes; ++i)
+        images[i] = GET_MAT(imPreprocess(rois[i], imageSize, cv::Size(1, 1))[0], ACCESS_READ);
+    std::vector<std::vector<FeatureVector> > features = sharedHog.compute(images);
+    for (size_t i = 0; i < nProbes; ++i) {
+        probeFeatures[i] = std::vector<FeatureVector>(nPatches);
+        for (size_t p = 0; p < nPatches; ++p)
+            probeFeatures[i][p] = normalizePerFeature(MIN_MAX, features[i][p], hogPatchFeaturesMin[p], hogPatchFeaturesMax[p]);
+    }
+    return probeFeatures;
+}
 
+std::vector<FeatureVector> TemplateMatcher::computeProbeFeatures(const FACE_RECOG_MAT& roi) const
+{
+    size_t nPatches = getPatchCount();
     std::vector<FeatureVector> probeSampleFeatures(nPatches);
+    if (useSharedHOG) {
+        cv::Mat image = GET_MAT(imPreprocess(roi, imageSize, cv::Size(1, 1))[0], ACCESS_READ);
+        std::vector<FeatureVector> features = sharedHog.compute(image);
+        for (size_t p = 0; p < nPatches; ++p)
+            probeSampleFeatures[p] = normalizePerFeature(MIN_MAX, features[p], hogPatchFeaturesMin[p], hogPatchFeaturesMax[p]);
+        return probeSampleFeatures;
+    }
     std::vector<FACE_RECOG_MAT> patches = imPreprocess(roi, imageSize, patchCounts);
-
-    size_t dimsScores[2]{ nPositives, 0 };
-    xstd::mvector<2, double> scores(dimsScores, 0.0);
-    std::vector<double> templateScores(nPositives, 0.0);
+    FeatureExtractorHOG probeHog = hog;     // extractor state is not shared between concurrent predictions
     for (size_t p = 0; p < nPatches; ++p) {
         cv::Mat patch = GET_MAT(patches[p], ACCESS_READ);
-        probeSampleFeatures[p] = normalizePerFeature(MIN_MAX, hog.compute(patch), hogPatchFeaturesMin[p], hogPatchFeaturesMax[p]);
+        probeSampleFeatures[p] = normalizePerFeature(MIN_MAX, probeHog.compute(patch), hogPatchFeaturesMin[p], hogPatchFeaturesMax[p]);
+    }
+    return probeSampleFeatures;
+}
+
+std::vector<double> TemplateMatcher::scoreTemplates(const std::vector<FeatureVector>& probeSampleFeatures, bool useQuantized) const
+{
+    size_t nPatches = getPatchCount();
+    size_t nPositives = getPositiveCount();
+
+    // exact scoring limited to shortlisted positives if indexed, others are left with the lowest similarity
+    std::vector<size_t> scoredPositives;
+    if (galleryShortlistSize > 0 && !galleryIndex.empty())
+        scoredPositives = galleryIndex.search(concatPatchFeatures(probeSampleFeatures), galleryShortlistSize);
+    else {
+        scoredPositives = std::vector<size_t>(nPositives);
         for (size_t pos = 0; pos < nPositives; ++pos)
-            for (size_t r = 0; r < patchTemplates[p][pos].size(); ++r)
-                scores[pos][r] += similarityFromEuclideanDistance(probeSampleFeatures[p], patchTemplates[p][pos][r]);
+            scoredPositives[pos] = pos;
     }
-    for (size_t pos = 0; pos < nPositives; ++pos) {
-        size_t nRepresentations = scores[pos].size();
+
+    // probe encoded with the same representation as int8 templates, or kept as float against decoded fp16 templates
+    std::vector<cv::Mat> probeEncoded;
+    if (useQuantized) {
+        probeEncoded = std::vector<cv::Mat>(nPatches);
+        for (size_t p = 0; p < nPatches; ++p)
+            probeEncoded[p] = quantization == INT8 ? encodeFeatures(p, probeSampleFeatures[p]) : featuresToRow(probeSampleFeatures[p]);
+    }
+
+    std::vector<double> templateScores(nPositives, 0.0);
+    for (size_t s = 0; s < scoredPositives.size(); ++s) {
+        size_t pos = scoredPositives[s];
+        size_t nRepresentations = templateRowStarts[pos + 1] - templateRowStarts[pos];
         for (size_t r = 0; r < nRepresentations; ++r) {
-            scores[pos][r] /= (double)nPatches;
-            templateScores[pos] += scores[pos][r];
+            double score = 0;
+            for (size_t p = 0; p < nPatches; ++p)
+                score += useQuantized
+                       ? similarityFromQuantizedDistance(p, probeEncoded[p], (int)(templateRowStarts[pos] + r))
+                       : similarityFromEuclideanDistance(probeSampleFeatures[p], patchTemplates[p][pos][r]);
+            templateScores[pos] += score / (double)nPatches;
         }
         templateScores[pos] /= (double)nRepresentations;
     }
@@ -117,7 +367,140 @@ std::vector<double> TemplateMatcher::predict(const FACE_RECOG_MAT& roi)
     return templateScores;
 }
 
-double TemplateMatcher::similarityFromEuclideanDistance(const FeatureVector& probeSample, const FeatureVector& templateSample)
+void TemplateMatcher::setQuantization(Quantization mode)
+{
+    ASSERT_LOG(hasExactTemplates, "Full precision templates already released, cannot quantize them again");
+    quantization = mode;
+    quantizedTemplates.clear();
+    quantizedScales.clear();
+    quantizedOffsets.clear();
+    if (mode == NONE)
+        return;
+
+    size_t nPatches = getPatchCount();
+    size_t nPositives = getPositiveCount();
+    int nRows = (int)templateRowStarts[nPositives];
+    quantizedTemplates = std::vector<cv::Mat>(nPatches);
+    quantizedScales = std::vector<double>(nPatches, 1.0);
+    quantizedOffsets = std::vector<double>(nPatches, 0.0);
+    for (size_t p = 0; p < nPatches; ++p)
+    {
+        // int8 range covers the templates and the min/max normalized probes [0,1]
+        double minValue = 0, maxValue = 1;
+        int nFeatures = 0;
+        for (size_t pos = 0; pos < nPositives; ++pos) {
+            for (size_t r = 0; r < patchTemplates[p][pos].size(); ++r) {
+                const FeatureVector& features = patchTemplates[p][pos][r];
+                nFeatures = (int)features.size();
+                minValue = std::min<double>(minValue, *std::min_element(features.begin(), features.end()));
+                maxValue = std::max<double>(maxValue, *std::max_element(features.begin(), features.end()));
+            }
+        }
+        quantizedOffsets[p] = minValue;
+        quantizedScales[p] = (maxValue - minValue) / 255.0;
+
+        quantizedTemplates[p] = cv::Mat(nRows, nFeatures, mode == INT8 ? CV_8U : CV_16S);
+        for (size_t pos = 0; pos < nPositives; ++pos)
+            for (size_t r = 0; r < patchTemplates[p][pos].size(); ++r)
+                encodeFeatures(p, patchTemplates[p][pos][r]).copyTo(quantizedTemplates[p].row((int)(templateRowStarts[pos] + r)));
+    }
+}
+
+void TemplateMatcher::releaseExactTemplates()
+{
+    ASSERT_LOG(quantization != NONE, "Full precision templates are required without quantization");
+    size_t nPatches = getPatchCount();
+    size_t nPositives = getPositiveCount();
+    for (size_t p = 0; p < nPatches; ++p)
+        for (size_t pos = 0; pos < nPositives; ++pos)
+            std::vector<FeatureVector>().swap(patchTemplates[p][pos]);
+    packedTemplates.clear();
+    packedSquaredNorms.clear();
+    hasExactTemplates = false;
+}
+
+TemplateQuantizationReport TemplateMatcher::evaluateQuantization(const std::vector<FACE_RECOG_MAT>& probes)
+{
+    ASSERT_LOG(hasExactTemplates, "Full precision templates required to evaluate quantization");
+    ASSERT_LOG(quantization != NONE, "Templates quantization not enabled");
+
+    TemplateQuantizationReport report;
+    size_t nPatches = getPatchCount();
+    size_t nRows = templateRowStarts[getPositiveCount()];
+    size_t nRankMatches = 0;
+    double sumAbsError = 0;
+    size_t nScores = 0;
+    for (size_t i = 0; i < probes.size(); ++i) {
+        std::vector<FeatureVector> probeFeatures = computeProbeFeatures(probes[i]);
+        std::vector<double> exactScores = scoreTemplates(probeFeatures, false);
+        std::vector<double> quantizedScores = scoreTemplates(probeFeatures, true);
+        for (size_t pos = 0; pos < exactScores.size(); ++pos) {
+            double absError = std::abs(exactScores[pos] - quantizedScores[pos]);
+            report.maxAbsError = std::max(report.maxAbsError, absError);
+            sumAbsError += absError;
+            ++nScores;
+        }
+        if (std::max_element(exactScores.begin(), exactScores.end()) - exactScores.begin() ==
+            std::max_element(quantizedScores.begin(), quantizedScores.end()) - quantizedScores.begin())
+            ++nRankMatches;
+    }
+    report.probeCount = probes.size();
+    report.meanAbsError = nScores > 0 ? sumAbsError / (double)nScores : 0;
+    report.rankAgreement = probes.size() > 0 ? (double)nRankMatches / (double)probes.size() : 1;
+    for (size_t p = 0; p < nPatches; ++p) {
+        size_t nFeatures = (size_t)quantizedTemplates[p].cols;
+        report.exactBytes += nRows * nFeatures * sizeof(FeatureVector::value_type);
+        report.quantizedBytes += quantizedTemplates[p].total() * quantizedTemplates[p].elemSize();
+    }
+    return report;
+}
+
+double TemplateMatcher::evaluateBatchScoring(const std::vector<FACE_RECOG_MAT>& probes) const
+{
+    ASSERT_LOG(hasExactTemplates, "Full precision templates required to evaluate batch scoring");
+    std::vector<std::vector<double> > batchScores = predict(probes);
+    double maxAbsError = 0;
+    for (size_t i = 0; i < probes.size(); ++i) {
+        std::vector<double> probeScores = predict(probes[i]);
+        for (size_t pos = 0; pos < probeScores.size(); ++pos)
+            maxAbsError = std::max(maxAbsError, std::abs(probeScores[pos] - batchScores[i][pos]));
+    }
+    return maxAbsError;
+}
+
+cv::Mat TemplateMatcher::featuresToRow(const FeatureVector& features, int depth) const
+{
+    int nFeatures = (int)features.size();
+    cv::Mat values(1, nFeatures, depth);
+    for (int f = 0; f < nFeatures; ++f) {
+        if (depth == CV_64F)
+            values.at<double>(f) = (double)features[f];
+        else
+            values.at<float>(f) = (float)features[f];
+    }
+    return values;
+}
+
+cv::Mat TemplateMatcher::encodeFeatures(size_t patch, const FeatureVector& features) const
+{
+    cv::Mat values = featuresToRow(features);
+    cv::Mat encoded;
+    if (quantization == INT8)   // saturated rounding to [0,255]
+        values.convertTo(encoded, CV_8U, 1.0 / quantizedScales[patch], -quantizedOffsets[patch] / quantizedScales[patch]);
+    else
+        cv::convertFp16(values, encoded);
+    return encoded;
+}
+
+FeatureVector TemplateMatcher::concatPatchFeatures(const std::vector<FeatureVector>& patchFeatures) const
+{
+    FeatureVector features;
+    for (size_t p = 0; p < patchFeatures.size(); ++p)
+        features.insert(features.end(), patchFeatures[p].begin(), patchFeatures[p].end());
+    return features;
+}
+
+double TemplateMatcher::similarityFromEuclideanDistance(const FeatureVector& probeSample, const FeatureVector& templateSample) const
 {
     size_t nFeatures = templateSample.size();
     assert(probeSample.size() == nFeatures);
@@ -127,4 +510,17 @@ double TemplateMatcher::similarityFromEuclideanDistance(const FeatureVector& pro
     return 1 - std::sqrt(dist) / std::sqrt((double)nFeatures);
 }
 
+double TemplateMatcher::similarityFromQuantizedDistance(size_t patch, const cv::Mat& probeEncoded, int templateRow) const
+{
+    // templates are read in place with their stored representation, without decoding allocations
+    const cv::Mat& templates = quantizedTemplates[patch];
+    double dist;
+    if (quantization == INT8)   // integer distance, scaled back to feature units
+        dist = squaredDistanceInt8(probeEncoded.ptr<uchar>(), templates.ptr<uchar>(templateRow), templates.cols)
+             * quantizedScales[patch] * quantizedScales[patch];
+    else
+        dist = squaredDistanceFp16(probeEncoded.ptr<float>(), templates.ptr<ushort>(templateRow), templates.cols);
+    return 1 - std::sqrt(dist) / std::sqrt((double)templates.cols);
+}
+
 #endif/*FACE_RECOG_HAS_TM*/
@@ -77,8 +77,12 @@ std::string ConfigFile::display() const
         << left << tab << tab << setw(padSize) << setfill(padChar) << "cameraIndex"                        << sep << cameraIndex                        << endl
         << left << tab << tab << setw(padSize) << setfill(padChar) << "cameraType"                         << sep << cameraType                         << endl
         << left << tab << tab << setw(padSize) << setfill(padChar) << "useCameraTrigger"                   << sep << useCameraTrigger                   << endl
+        << left << tab << tab << setw(padSize) << setfill(padChar) << "frameDecodeThreads"                 << sep << frameDecodeThreads                 << endl
+        << left << tab << tab << setw(padSize) << setfill(padChar) << "frameReadAhead"                     << sep << frameReadAhead                     << endl
+        << left << tab << tab << setw(padSize) << setfill(padChar) << "frameDecodeReduction"               << sep << frameDecodeReduction               << endl
         << left << tab << "algorithms" << sep << endl
         << left << tab << tab << "face detection" << sep << endl
+        << left << tab << tab << tab << setw(padSize) << setfill(padChar) << "DNN"                         << sep << DNN                                << endl
         << left << tab << tab << tab << setw(padSize) << setfill(padChar) << "FRCNN"                       << sep << FRCNN                              << endl
         << left << tab << tab << tab << setw(padSize) << setfill(padChar) << "HaarCascadeFrontal"          << sep << HaarCascadeFrontal                 << endl
         << left << tab << tab << tab << setw(padSize) << setfill(padChar) << "HaarCascadeProfile"          << sep << HaarCascadeProfile                 << endl
@@ -115,6 +119,21 @@ std::string ConfigFile::display() const
         << left << tab << tab << setw(padSize) << setfill(padChar) << "modelsFileSave"                     << sep << modelsFileSave                     << endl
         << left << tab << tab << setw(padSize) << setfill(padChar) << "modelsFileLoad"                     << sep << modelsFileLoad                     << endl
         << left << tab << tab << setw(padSize) << setfill(padChar) << "modelsFileDir"                      << sep << modelsFileDir                      << endl
+        << left << tab << tab << setw(padSize) << setfill(padChar) << "recognitionScheduling"              << sep << recognitionScheduling              << endl
+        << left << tab << tab << setw(padSize) << setfill(padChar) << "recognitionMinQuality"              << sep << recognitionMinQuality              << endl
+        << left << tab << tab << setw(padSize) << setfill(padChar) << "recognitionWindowSize"              << sep << recognitionWindowSize              << endl
+        << left << tab << tab << setw(padSize) << setfill(padChar) << "recognitionProbesPerWindow"         << sep << recognitionProbesPerWindow         << endl
+        << left << tab << tab << setw(padSize) << setfill(padChar) << "recognitionFrameBudget"             << sep << recognitionFrameBudget             << endl
+        << left << tab << tab << setw(padSize) << setfill(padChar) << "recognitionStableDelta"             << sep << recognitionStableDelta             << endl
+        << left << tab << tab << setw(padSize) << setfill(padChar) << "recognitionStableInterval"          << sep << recognitionStableInterval          << endl
+        << left << tab << tab << setw(padSize) << setfill(padChar) << "galleryIndex"                       << sep << galleryIndex                       << endl
+        << left << tab << tab << setw(padSize) << setfill(padChar) << "galleryShortlistSize"               << sep << galleryShortlistSize               << endl
+        << left << tab << tab << setw(padSize) << setfill(padChar) << "galleryIndexLists"                  << sep << galleryIndexLists                  << endl
+        << left << tab << tab << setw(padSize) << setfill(padChar) << "galleryIndexProbes"                 << sep << galleryIndexProbes                 << endl
+        << left << tab << tab << setw(padSize) << setfill(padChar) << "galleryExactMaxSize"                << sep << galleryExactMaxSize                << endl
+        << left << tab << tab << setw(padSize) << setfill(padChar) << "templateQuantization"               << sep << templateQuantization               << endl
+        << left << tab << tab << setw(padSize) << setfill(padChar) << "templateQuantizationCheck"          << sep << templateQuantizationCheck          << endl
+        << left << tab << tab << setw(padSize) << setfill(padChar) << "useSharedCellHOG"                   << sep << useSharedCellHOG                   << endl
         << left << tab << "detection/tracking parameters" << sep << endl
         << left << tab << tab << setw(padSize) << setfill(padChar) << "searchRadius"                       << sep << searchRadius                       << endl
         << left << tab << tab << setw(padSize) << setfill(padChar) << "useHungarianMatching"               << sep << useHungarianMatching               << endl
@@ -128,6 +147,20 @@ std::string ConfigFile::display() const
         << left << tab << tab << setw(padSize) << setfill(padChar) << "trackerOverlapThresh"               << sep << trackerOverlapThreshold            << endl
         << left << tab << tab << setw(padSize) << setfill(padChar) << "detectionAugmentationOffset"        << sep << detectionAugmentationOffset        << endl
         << left << tab << tab << setw(padSize) << setfill(padChar) << "detectionFrameInterval"             << sep << detectionFrameInterval             << endl
+        << left << tab << tab << setw(padSize) << setfill(padChar) << "detectionMotionGating"              << sep << detectionMotionGating              << endl
+        << left << tab << tab << setw(padSize) << setfill(padChar) << "detectionMaxFrameInterval"          << sep << detectionMaxFrameInterval          << endl
+        << left << tab << tab << setw(padSize) << setfill(padChar) << "detectionFullSweepInterval"         << sep << detectionFullSweepInterval         << endl
+        << left << tab << tab << setw(padSize) << setfill(padChar) << "motionThreshold"                    << sep << motionThreshold                    << endl
+        << left << tab << tab << setw(padSize) << setfill(padChar) << "motionLearningRate"                 << sep << motionLearningRate                 << endl
+        << left << tab << tab << setw(padSize) << setfill(padChar) << "motionDownscale"                    << sep << motionDownscale                    << endl
+        << left << tab << tab << setw(padSize) << setfill(padChar) << "motionFullFrameRatio"               << sep << motionFullFrameRatio               << endl
+        << left << tab << tab << setw(padSize) << setfill(padChar) << "kcfUseHOG"                          << sep << kcfUseHOG                          << endl
+        << left << tab << tab << setw(padSize) << setfill(padChar) << "kcfTemplateSize"                    << sep << kcfTemplateSize                    << endl
+        << left << tab << tab << setw(padSize) << setfill(padChar) << "kcfPadding"                         << sep << kcfPadding                         << endl
+        << left << tab << tab << setw(padSize) << setfill(padChar) << "kcfScaleStep"                       << sep << kcfScaleStep                       << endl
+        << left << tab << tab << setw(padSize) << setfill(padChar) << "struckMotionPrediction"             << sep << struckMotionPrediction             << endl
+        << left << tab << tab << setw(padSize) << setfill(padChar) << "struckMinSearchRadius"              << sep << struckMinSearchRadius              << endl
+        << left << tab << tab << setw(padSize) << setfill(padChar) << "struckCoarseToFine"                 << sep << struckCoarseToFine                 << endl
         << left << tab << "training (Fast-DT)" << endl
         << left << tab << tab << setw(padSize) << setfill(padChar) << "seed"                               << sep << seed                               << endl
         << left << tab << tab << setw(padSize) << setfill(padChar) << "svmC"                               << sep << svmC                               << endl
@@ -141,6 +174,17 @@ std::string ConfigFile::display() const
         << left << tab << tab << setw(padSize) << setfill(padChar) << "faceMinSize"                        << sep << face.minSize                       << endl
         << left << tab << tab << setw(padSize) << setfill(padChar) << "faceMaxSize"                        << sep << face.maxSize                       << endl
         << left << tab << tab << setw(padSize) << setfill(padChar) << "faceConfidenceSize"                 << sep << face.confidenceSize                << endl
+        << left << tab << tab << setw(padSize) << setfill(padChar) << "faceTileSize"                       << sep << faceTileSize                       << endl
+        << left << tab << tab << setw(padSize) << setfill(padChar) << "dnnModelFile"                       << sep << dnnModelFile                       << endl
+        << left << tab << tab << setw(padSize) << setfill(padChar) << "dnnWeightsFile"                     << sep << dnnWeightsFile                     << endl
+        << left << tab << tab << setw(padSize) << setfill(padChar) << "dnnInputSize"                       << sep << dnnInputSize                       << endl
+        << left << tab << tab << setw(padSize) << setfill(padChar) << "dnnConfidenceThreshold"             << sep << dnnConfidenceThreshold             << endl
+        << left << tab << tab << setw(padSize) << setfill(padChar) << "dnnInputScale"                      << sep << dnnInputScale                      << endl
+        << left << tab << tab << setw(padSize) << setfill(padChar) << "dnnInputMean"                       << sep << dnnInputMean                       << endl
+        << left << tab << tab << setw(padSize) << setfill(padChar) << "dnnSwapRB"                          << sep << dnnSwapRB                          << endl
+        << left << tab << tab << setw(padSize) << setfill(padChar) << "dnnBatchSize"                       << sep << dnnBatchSize                       << endl
+        << left << tab << tab << setw(padSize) << setfill(padChar) << "dnnBatchWait"                       << sep << dnnBatchWait                       << endl
+        << left << tab << tab << setw(padSize) << setfill(padChar) << "dnnThreads"                         << sep << dnnThreads                         << endl
         << left << tab << "eyes bounding boxes" << sep << endl
         << left << tab << tab << setw(padSize) << setfill(padChar) << "useEyeDetection"                    << sep << useEyesDetection                   << endl
         << left << tab << tab << setw(padSize) << setfill(padChar) << "useEyeLocalizedPosition"            << sep << useEyeLocalizedPosition            << endl
@@ -164,6 +208,10 @@ std::string ConfigFile::display() const
         << left << tab << tab << setw(padSize) << setfill(padChar) << "outputLocalROI"                     << sep << outputLocalROI                     << endl
         << left << tab << tab << setw(padSize) << setfill(padChar) << "roiOutputSize"                      << sep << roiOutputSize                      << endl
         << left << tab << tab << setw(padSize) << setfill(padChar) << "outputDirsClearOnStart"             << sep << outputDirsClearOnStart             << endl
+        << left << tab << tab << setw(padSize) << setfill(padChar) << "outputWriterThreads"                << sep << outputWriterThreads                << endl
+        << left << tab << tab << setw(padSize) << setfill(padChar) << "outputQueueSize"                    << sep << outputQueueSize                    << endl
+        << left << tab << tab << setw(padSize) << setfill(padChar) << "outputFramesVideo"                  << sep << outputFramesVideo                  << endl
+        << left << tab << tab << setw(padSize) << setfill(padChar) << "outputVideoFPS"                     << sep << outputVideoFPS                     << endl
         << left << tab << tab << setw(padSize) << setfill(padChar) << "flipFrames"                         << sep << flipFrames                         << endl
         << left << tab << tab << setw(padSize) << setfill(padChar) << "displayFrames"                      << sep << displayFrames                      << endl
         << left << tab << tab << setw(padSize) << setfill(padChar) << "displayFrameRate"                   << sep << displayFrameRate                   << endl
@@ -186,6 +234,16 @@ std::string ConfigFile::display() const
         << left << tab << tab << setw(padSize) << setfill(padChar) << "plotMaxTracks"                      << sep << plotMaxTracks                      << endl
         << left << tab << tab << setw(padSize) << setfill(padChar) << "plotMaxPOI"                         << sep << plotMaxPOI                         << endl
         << left << tab << tab << setw(padSize) << setfill(padChar) << "plotResetOnTrackLost"               << sep << plotResetOnTrackLost               << endl
+        << left << tab << "multiple streams" << sep << endl
+        << left << tab << tab << setw(padSize) << setfill(padChar) << "multiStreamWorkers"                 << sep << multiStreamWorkers                 << endl
+        << left << tab << tab << setw(padSize) << setfill(padChar) << "multiStreamOmpThreads"              << sep << multiStreamOmpThreads              << endl
+        << left << tab << tab << setw(padSize) << setfill(padChar) << "testSequenceWorkers"                << sep << testSequenceWorkers                << endl
+        << left << tab << "load shedding" << sep << endl
+        << left << tab << tab << setw(padSize) << setfill(padChar) << "loadSheddingBudget"                 << sep << loadSheddingBudget                 << endl
+        << left << tab << tab << setw(padSize) << setfill(padChar) << "loadSheddingRecoverRatio"           << sep << loadSheddingRecoverRatio           << endl
+        << left << tab << tab << setw(padSize) << setfill(padChar) << "loadSheddingHoldFrames"             << sep << loadSheddingHoldFrames             << endl
+        << left << tab << "configuration reload" << sep << endl
+        << left << tab << tab << setw(padSize) << setfill(padChar) << "configHotReload"                    << sep << configHotReload                    << endl
         << string(padLine, '=') << endl;
 
     std::string out_str(out.str());
@@ -224,169 +282,261 @@ ConfigFile::ConfigFile(const std::string& path)
     ifstream f(path.c_str());
     ASSERT_LOG(f, "error: could not load config file: '" + path + "'\n");
 
-    string line, name, tmp;
+    string line;
     while (getline(f, line))
-    {
-        istringstream iss(line);
-        iss >> name >> tmp;
-
-        // skip invalid lines and comments
-        if (iss.fail() || tmp != "=" || name[0] == '#') continue;
-
-        // training (Fast-DT)
-        if      (name == "seed") iss >> seed;
-        else if (name == "svmC") iss >> svmC;
-        else if (name == "svmBudgetSize") iss >> svmBudgetSize;
-        else if (name == "feature")
-        {
-            string featureName, kernelName;
-            double param;
-            iss >> featureName >> kernelName >> param;
-            FeatureKernelPair fkp;
-
-            if      (featureName == FeatureName(kFeatureTypeHaar))      fkp.feature = kFeatureTypeHaar;
-            else if (featureName == FeatureName(kFeatureTypeRaw))       fkp.feature = kFeatureTypeRaw;
-            else if (featureName == FeatureName(kFeatureTypeHistogram)) fkp.feature = kFeatureTypeHistogram;
-            else THROW("unrecognised feature: " + featureName);
-
-            if      (kernelName == KernelName(kKernelTypeLinear))       fkp.kernel = kKernelTypeLinear;
-            else if (kernelName == KernelName(kKernelTypeIntersection)) fkp.kernel = kKernelTypeIntersection;
-            else if (kernelName == KernelName(kKernelTypeChi2))         fkp.kernel = kKernelTypeChi2;
-            else if (kernelName == KernelName(kKernelTypeGaussian)) {
-                ASSERT_LOG(iss, "gaussian kernel requires a parameter (sigma)");
-                ASSERT_LOG(param > 0, "gaussian kernel sigma must be greater than zero");
-                fkp.kernel = kKernelTypeGaussian;
-                fkp.params.push_back(param);
-            }
-            else THROW("unrecognised kernel: " + kernelName);
-            features.push_back(fkp);
-        }
+        parseLine(line);
+    validateValues();
+}
 
-        // device parameters
-        else if (name == "deviceIndex")                             iss >> deviceIndex;
-        // camera parameters
-        else if (name == "cameraIndex")                             iss >> cameraIndex;
-        else if (name == "cameraType")                              iss >> cameraType;
-        else if (name == "useCameraTrigger")                        iss >> useCameraTrigger;
-        // algorithms for face detection
-        else if (name == "FRCNN")                                   iss >> FRCNN;
-        else if (name == "HaarCascadeFrontal")                      iss >> HaarCascadeFrontal;
-        else if (name == "HaarCascadeProfile")                      iss >> HaarCascadeProfile;
-        else if (name == "LBPCascadeFrontal")                       iss >> LBPCascadeFrontal;
-        else if (name == "LBPCascadeProfile")                       iss >> LBPCascadeProfile;
-        else if (name == "LBPCascadeFrontalImproved")               iss >> LBPCascadeFrontalImproved;
-        else if (name == "SSD")                                     iss >> SSD;
-        else if (name == "YOLO")                                    iss >> YOLO;
-        // algorithms for face tracking
-        else if (name == "Camshift")                                iss >> Camshift;
-        else if (name == "Compressive")                             iss >> Compressive;
-        else if (name == "KCF")                                     iss >> KCF;
-        else if (name == "STRUCK")                                  iss >> STRUCK;
-        // algorithms for face recognition
-        else if (name == "ESVM")                                    iss >> ESVM;
-        else if (name == "FaceNet")                                 iss >> FaceNet;
-        else if (name == "TM")                                      iss >> TM;
-        // face recognition parameters
-        else if (name == "useFaceRecognition")                      iss >> useFaceRecognition;
-        else if (name == "useGeometricPositiveStills")              iss >> useGeometricPositiveStills;
-        else if (name == "useSyntheticPositiveStills")              iss >> useSyntheticPositiveStills;
-        else if (name == "useReferenceNegativeStills")              iss >> useReferenceNegativeStills;
-        else if (name == "useGeometricNegativeStills")              iss >> useGeometricNegativeStills;
-        else if (name == "geometricTranslatePixels")                iss >> geometricTranslatePixels;
-        else if (name == "geometricScalingMinSize")                 iss >> geometricScalingMinSize;
-        else if (name == "geometricScalingFactor")                  iss >> geometricScalingFactor;
-        else if (name == "NEGDirExtra")                             iss >> NEGDirExtra;
-        else if (name == "NEGDir")                                  iss >> NEGDir;
-        else if (name == "POIDir")                                  iss >> POIDir;
-        else if (name == "thresholdFaceConsidered")                 iss >> thresholdFaceConsidered;
-        else if (name == "thresholdFaceRecognized")                 iss >> thresholdFaceRecognized;
-        else if (name == "roiAccumulationSize")                     iss >> roiAccumulationSize;
-        else if (name == "roiAccumulationMode") {
-            int mode;
-            iss >> mode;
-            roiAccumulationMode = (mode == CircularBuffer::ScoreMode::CUMUL) ? CircularBuffer::ScoreMode::CUMUL
-                                : (mode == CircularBuffer::ScoreMode::AVG)   ? CircularBuffer::ScoreMode::AVG
-                                :                                              CircularBuffer::ScoreMode::RAW;
-        }
-        else if (name == "modelsFileSave")                          iss >> modelsFileSave;
-        else if (name == "modelsFileLoad")                          iss >> modelsFileLoad;
-        else if (name == "modelsFileDir")                           iss >> modelsFileDir;
-        // detection and tracking parameters
-        else if (name == "searchRadius")                            iss >> searchRadius;
-        else if (name == "useHungarianMatching")                    iss >> useHungarianMatching;
-        else if (name == "associationTrackThreshold")               iss >> associationTrackThreshold;
-        else if (name == "removeTrackCountThresholdInBounds")       iss >> removeTrackCountThresholdInBounds;
-        else if (name == "removeTrackCountThresholdOutBounds")      iss >> removeTrackCountThresholdOutBounds;
-        else if (name == "removeTrackConfidenceInBounds")           iss >> removeTrackConfidenceInBounds;
-        else if (name == "removeTrackConfidenceOutBounds")          iss >> removeTrackConfidenceOutBounds;
-        else if (name == "createTrackCountThreshold")               iss >> createTrackCountThreshold;
-        else if (name == "createTrackConfidenceThreshold")          iss >> createTrackConfidenceThreshold;
-        else if (name == "trackerOverlapThreshold")                 iss >> trackerOverlapThreshold;
-        else if (name == "detectionAugmentationOffset")             iss >> detectionAugmentationOffset;
-        else if (name == "detectionFrameInterval")                  iss >> detectionFrameInterval;
-        // face bounding boxes parameters
-        else if (name == "faceOverlapThreshold")                    iss >> face.overlapThreshold;
-        else if (name == "faceMinNeighbours")                       iss >> face.minNeighbours;
-        else if (name == "faceScaleFactor")                         iss >> face.scaleFactor;
-        else if (name == "faceNmsThreshold")                        iss >> face.nmsThreshold;
-        else if (name == "faceMinWidth")                            iss >> face.minSize.width;
-        else if (name == "faceMinHeight")                           iss >> face.minSize.height;
-        else if (name == "faceMaxWidth")                            iss >> face.maxSize.width;
-        else if (name == "faceMaxHeight")                           iss >> face.maxSize.height;
-        else if (name == "faceConfidenceSize") {
-            int size;
-            iss >> size;
-            face.confidenceSize = cv::Size(size, size);
+bool ConfigFile::setValue(const std::string& name, const std::string& value)
+{
+    return setValues(std::vector<std::pair<std::string, std::string> >(1, std::make_pair(name, value)));
+}
+
+bool ConfigFile::setValues(const std::vector<std::pair<std::string, std::string> >& values)
+{
+    // coupled parameters can be invalid until all of them are updated
+    // features given as values replace the current ones, only lines of a file accumulate them
+    bool parsed = true;
+    for (size_t v = 0; v < values.size(); ++v) {
+        if (values[v].first == "feature") {
+            features.clear();
+            break;
         }
-        // eyes bounding boxes parameters
-        else if (name == "useEyesDetection")                        iss >> useEyesDetection;
-        else if (name == "useEyeLocalizedPosition")                 iss >> useEyeLocalizedPosition;
-        else if (name == "eyesOverlapThreshold")                    iss >> eyes.overlapThreshold;
-        else if (name == "eyesMinNeighbours")                       iss >> eyes.minNeighbours;
-        else if (name == "eyesScaleFactor")                         iss >> eyes.scaleFactor;
-        else if (name == "eyesNmsThreshold")                        iss >> eyes.nmsThreshold;
-        else if (name == "eyesMinWidth")                            iss >> eyes.minSize.width;
-        else if (name == "eyesMinHeight")                           iss >> eyes.minSize.height;
-        else if (name == "eyesMaxWidth")                            iss >> eyes.maxSize.width;
-        else if (name == "eyesMaxHeight")                           iss >> eyes.maxSize.height;
-        // localized ROI detection
-        else if (name == "useLocalSearchROI")                       iss >> useLocalSearchROI;
-        else if (name == "use3CascadesLocalSearch")                 iss >> use3CascadesLocalSearch;
-        else if (name == "bboxSizeMultiplyer")                      iss >> bboxSizeMultiplyer;
-        // output/debug/display parameters
-        else if (name == "verboseConfig")                           iss >> verboseConfig;
-        else if (name == "verboseDevices")                          iss >> verboseDevices;
-        else if (name == "verboseDebug")                            iss >> verboseDebug;
-        else if (name == "outputDebug")                             iss >> outputDebug;
-        else if (name == "outputFrames")                            iss >> outputFrames;
-        else if (name == "outputROI")                               iss >> outputROI;
-        else if (name == "outputLocalROI")                          iss >> outputLocalROI;
-        else if (name == "roiOutputSize")                           iss >> roiOutputSize;
-        else if (name == "outputDirsClearOnStart")                  iss >> outputDirsClearOnStart;
-        else if (name == "flipFrames")                              iss >> flipFrames;
-        else if (name == "displayFrames")                           iss >> displayFrames;
-        else if (name == "displayFrameRate")                        iss >> displayFrameRate;
-        else if (name == "displayFrameNumber")                      iss >> displayFrameNumber;
-        else if (name == "displaySequenceTrackID")                  iss >> displaySequenceTrackID;
-        else if (name == "displayWindowX")                          iss >> displayWindowX;
-        else if (name == "displayWindowY")                          iss >> displayWindowY;
-        else if (name == "displayWindowW")                          iss >> displayWindowW;
-        else if (name == "displayWindowH")                          iss >> displayWindowH;
-        else if (name == "displayOldROI")                           iss >> displayOldROI;
-        else if (name == "roiColorMode")                            iss >> roiColorMode;
-        else if (name == "roiThickness")                            iss >> roiThickness;
-        else if (name == "roiThicknessOld")                         iss >> roiThicknessOld;
-        // plot display
-        else if (name == "displayPlots")                            iss >> displayPlots;
-        else if (name == "plotAccumulationPoints")                  iss >> plotAccumulationPoints;
-        else if (name == "plotFigureWidth")                         iss >> plotFigureWidth;
-        else if (name == "plotFigureHeight")                        iss >> plotFigureHeight;
-        else if (name == "plotTrackDirection")                      iss >> plotTrackDirection;
-        else if (name == "plotMaxTracks")                           iss >> plotMaxTracks;
-        else if (name == "plotMaxPOI")                              iss >> plotMaxPOI;
-        else if (name == "plotResetOnTrackLost")                    iss >> plotResetOnTrackLost;
     }
+    for (size_t v = 0; v < values.size(); ++v)
+        parsed = parseLine(values[v].first + " = " + values[v].second) && parsed;
     validateValues();
+    return parsed;
+}
+
+bool ConfigFile::parseLine(const std::string& line)
+{
+    string name, tmp;
+    istringstream iss(line);
+    iss >> name >> tmp;
+
+    // skip invalid lines and comments
+    if (iss.fail() || tmp != "=" || name[0] == '#') return false;
+
+    // training (Fast-DT)
+    if      (name == "seed") iss >> seed;
+    else if (name == "svmC") iss >> svmC;
+    else if (name == "svmBudgetSize") iss >> svmBudgetSize;
+    else if (name == "feature")
+    {
+        string featureName, kernelName;
+        double param;
+        iss >> featureName >> kernelName >> param;
+        FeatureKernelPair fkp;
+
+        if      (featureName == FeatureName(kFeatureTypeHaar))      fkp.feature = kFeatureTypeHaar;
+        else if (featureName == FeatureName(kFeatureTypeRaw))       fkp.feature = kFeatureTypeRaw;
+        else if (featureName == FeatureName(kFeatureTypeHistogram)) fkp.feature = kFeatureTypeHistogram;
+        else THROW("unrecognised feature: " + featureName);
+
+        if      (kernelName == KernelName(kKernelTypeLinear))       fkp.kernel = kKernelTypeLinear;
+        else if (kernelName == KernelName(kKernelTypeIntersection)) fkp.kernel = kKernelTypeIntersection;
+        else if (kernelName == KernelName(kKernelTypeChi2))         fkp.kernel = kKernelTypeChi2;
+        else if (kernelName == KernelName(kKernelTypeGaussian)) {
+            ASSERT_LOG(iss, "gaussian kernel requires a parameter (sigma)");
+            ASSERT_LOG(param > 0, "gaussian kernel sigma must be greater than zero");
+            fkp.kernel = kKernelTypeGaussian;
+            fkp.params.push_back(param);
+        }
+        else THROW("unrecognised kernel: " + kernelName);
+        features.push_back(fkp);
+    }
+
+    // device parameters
+    else if (name == "deviceIndex")                             iss >> deviceIndex;
+    // camera parameters
+    else if (name == "cameraIndex")                             iss >> cameraIndex;
+    else if (name == "cameraType")                              iss >> cameraType;
+    else if (name == "useCameraTrigger")                        iss >> useCameraTrigger;
+    else if (name == "frameDecodeThreads")                      iss >> frameDecodeThreads;
+    else if (name == "frameReadAhead")                          iss >> frameReadAhead;
+    else if (name == "frameDecodeReduction")                    iss >> frameDecodeReduction;
+    // algorithms for face detection
+    else if (name == "DNN")                                     iss >> DNN;
+    else if (name == "FRCNN")                                   iss >> FRCNN;
+    else if (name == "HaarCascadeFrontal")                      iss >> HaarCascadeFrontal;
+    else if (name == "HaarCascadeProfile")                      iss >> HaarCascadeProfile;
+    else if (name == "LBPCascadeFrontal")                       iss >> LBPCascadeFrontal;
+    else if (name == "LBPCascadeProfile")                       iss >> LBPCascadeProfile;
+    else if (name == "LBPCascadeFrontalImproved")               iss >> LBPCascadeFrontalImproved;
+    else if (name == "SSD")                                     iss >> SSD;
+    else if (name == "YOLO")                                    iss >> YOLO;
+    // algorithms for face tracking
+    else if (name == "Camshift")                                iss >> Camshift;
+    else if (name == "Compressive")                             iss >> Compressive;
+    else if (name == "KCF")                                     iss >> KCF;
+    else if (name == "STRUCK")                                  iss >> STRUCK;
+    // algorithms for face recognition
+    else if (name == "ESVM")                                    iss >> ESVM;
+    else if (name == "FaceNet")                                 iss >> FaceNet;
+    else if (name == "TM")                                      iss >> TM;
+    // face recognition parameters
+    else if (name == "useFaceRecognition")                      iss >> useFaceRecognition;
+    else if (name == "useGeometricPositiveStills")              iss >> useGeometricPositiveStills;
+    else if (name == "useSyntheticPositiveStills")              iss >> useSyntheticPositiveStills;
+    else if (name == "useReferenceNegativeStills")              iss >> useReferenceNegativeStills;
+    else if (name == "useGeometricNegativeStills")              iss >> useGeometricNegativeStills;
+    else if (name == "geometricTranslatePixels")                iss >> geometricTranslatePixels;
+    else if (name == "geometricScalingMinSize")                 iss >> geometricScalingMinSize;
+    else if (name == "geometricScalingFactor")                  iss >> geometricScalingFactor;
+    else if (name == "NEGDirExtra")                             iss >> NEGDirExtra;
+    else if (name == "NEGDir")                                  iss >> NEGDir;
+    else if (name == "POIDir")                                  iss >> POIDir;
+    else if (name == "thresholdFaceConsidered")                 iss >> thresholdFaceConsidered;
+    else if (name == "thresholdFaceRecognized")                 iss >> thresholdFaceRecognized;
+    else if (name == "roiAccumulationSize")                     iss >> roiAccumulationSize;
+    else if (name == "roiAccumulationMode") {
+        int mode;
+        iss >> mode;
+        roiAccumulationMode = (mode == CircularBuffer::ScoreMode::CUMUL) ? CircularBuffer::ScoreMode::CUMUL
+                            : (mode == CircularBuffer::ScoreMode::AVG)   ? CircularBuffer::ScoreMode::AVG
+                            :                                              CircularBuffer::ScoreMode::RAW;
+    }
+    else if (name == "modelsFileSave")                          iss >> modelsFileSave;
+    else if (name == "modelsFileLoad")                          iss >> modelsFileLoad;
+    else if (name == "modelsFileDir")                           iss >> modelsFileDir;
+    // recognition probes scheduling
+    else if (name == "recognitionScheduling")                   iss >> recognitionScheduling;
+    else if (name == "recognitionMinQuality")                   iss >> recognitionMinQuality;
+    else if (name == "recognitionWindowSize")                   iss >> recognitionWindowSize;
+    else if (name == "recognitionProbesPerWindow")              iss >> recognitionProbesPerWindow;
+    else if (name == "recognitionFrameBudget")                  iss >> recognitionFrameBudget;
+    else if (name == "recognitionStableDelta")                  iss >> recognitionStableDelta;
+    else if (name == "recognitionStableInterval")               iss >> recognitionStableInterval;
+    // gallery index
+    else if (name == "galleryIndex")                            iss >> galleryIndex;
+    else if (name == "galleryShortlistSize")                    iss >> galleryShortlistSize;
+    else if (name == "galleryIndexLists")                       iss >> galleryIndexLists;
+    else if (name == "galleryIndexProbes")                      iss >> galleryIndexProbes;
+    else if (name == "galleryExactMaxSize")                     iss >> galleryExactMaxSize;
+    // template quantization
+    else if (name == "templateQuantization")                    iss >> templateQuantization;
+    else if (name == "templateQuantizationCheck")               iss >> templateQuantizationCheck;
+    // shared cell HOG
+    else if (name == "useSharedCellHOG")                        iss >> useSharedCellHOG;
+    // detection and tracking parameters
+    else if (name == "searchRadius")                            iss >> searchRadius;
+    else if (name == "useHungarianMatching")                    iss >> useHungarianMatching;
+    else if (name == "associationTrackThreshold")               iss >> associationTrackThreshold;
+    else if (name == "removeTrackCountThresholdInBounds")       iss >> removeTrackCountThresholdInBounds;
+    else if (name == "removeTrackCountThresholdOutBounds")      iss >> removeTrackCountThresholdOutBounds;
+    else if (name == "removeTrackConfidenceInBounds")           iss >> removeTrackConfidenceInBounds;
+    else if (name == "removeTrackConfidenceOutBounds")          iss >> removeTrackConfidenceOutBounds;
+    else if (name == "createTrackCountThreshold")               iss >> createTrackCountThreshold;
+    else if (name == "createTrackConfidenceThreshold")          iss >> createTrackConfidenceThreshold;
+    else if (name == "trackerOverlapThreshold")                 iss >> trackerOverlapThreshold;
+    else if (name == "detectionAugmentationOffset")             iss >> detectionAugmentationOffset;
+    else if (name == "detectionFrameInterval")                  iss >> detectionFrameInterval;
+    else if (name == "detectionMotionGating")                   iss >> detectionMotionGating;
+    else if (name == "detectionMaxFrameInterval")               iss >> detectionMaxFrameInterval;
+    else if (name == "detectionFullSweepInterval")              iss >> detectionFullSweepInterval;
+    else if (name == "motionThreshold")                         iss >> motionThreshold;
+    else if (name == "motionLearningRate")                      iss >> motionLearningRate;
+    else if (name == "motionDownscale")                         iss >> motionDownscale;
+    else if (name == "motionFullFrameRatio")                    iss >> motionFullFrameRatio;
+    // KCF tracker
+    else if (name == "kcfUseHOG")                               iss >> kcfUseHOG;
+    else if (name == "kcfTemplateSize")                         iss >> kcfTemplateSize;
+    else if (name == "kcfPadding")                              iss >> kcfPadding;
+    else if (name == "kcfScaleStep")                            iss >> kcfScaleStep;
+    else if (name == "struckMotionPrediction")                  iss >> struckMotionPrediction;
+    else if (name == "struckMinSearchRadius")                   iss >> struckMinSearchRadius;
+    else if (name == "struckCoarseToFine")                      iss >> struckCoarseToFine;
+    // face bounding boxes parameters
+    else if (name == "faceOverlapThreshold")                    iss >> face.overlapThreshold;
+    else if (name == "faceMinNeighbours")                       iss >> face.minNeighbours;
+    else if (name == "faceScaleFactor")                         iss >> face.scaleFactor;
+    else if (name == "faceNmsThreshold")                        iss >> face.nmsThreshold;
+    else if (name == "faceMinWidth")                            iss >> face.minSize.width;
+    else if (name == "faceMinHeight")                           iss >> face.minSize.height;
+    else if (name == "faceMaxWidth")                            iss >> face.maxSize.width;
+    else if (name == "faceMaxHeight")                           iss >> face.maxSize.height;
+    else if (name == "faceConfidenceSize") {
+        int size;
+        iss >> size;
+        face.confidenceSize = cv::Size(size, size);
+    }
+    else if (name == "faceTileSize")                            iss >> faceTileSize;
+    // DNN face detector
+    else if (name == "dnnModelFile")                            iss >> dnnModelFile;
+    else if (name == "dnnWeightsFile")                          iss >> dnnWeightsFile;
+    else if (name == "dnnInputSize")                            iss >> dnnInputSize;
+    else if (name == "dnnConfidenceThreshold")                  iss >> dnnConfidenceThreshold;
+    else if (name == "dnnInputScale")                           iss >> dnnInputScale;
+    else if (name == "dnnInputMean")                            iss >> dnnInputMean[0] >> dnnInputMean[1] >> dnnInputMean[2];
+    else if (name == "dnnSwapRB")                               iss >> dnnSwapRB;
+    else if (name == "dnnBatchSize")                            iss >> dnnBatchSize;
+    else if (name == "dnnBatchWait")                            iss >> dnnBatchWait;
+    else if (name == "dnnThreads")                              iss >> dnnThreads;
+    // eyes bounding boxes parameters
+    else if (name == "useEyesDetection")                        iss >> useEyesDetection;
+    else if (name == "useEyeLocalizedPosition")                 iss >> useEyeLocalizedPosition;
+    else if (name == "eyesOverlapThreshold")                    iss >> eyes.overlapThreshold;
+    else if (name == "eyesMinNeighbours")                       iss >> eyes.minNeighbours;
+    else if (name == "eyesScaleFactor")                         iss >> eyes.scaleFactor;
+    else if (name == "eyesNmsThreshold")                        iss >> eyes.nmsThreshold;
+    else if (name == "eyesMinWidth")                            iss >> eyes.minSize.width;
+    else if (name == "eyesMinHeight")                           iss >> eyes.minSize.height;
+    else if (name == "eyesMaxWidth")                            iss >> eyes.maxSize.width;
+    else if (name == "eyesMaxHeight")                           iss >> eyes.maxSize.height;
+    // localized ROI detection
+    else if (name == "useLocalSearchROI")                       iss >> useLocalSearchROI;
+    else if (name == "use3CascadesLocalSearch")                 iss >> use3CascadesLocalSearch;
+    else if (name == "bboxSizeMultiplyer")                      iss >> bboxSizeMultiplyer;
+    // output/debug/display parameters
+    else if (name == "verboseConfig")                           iss >> verboseConfig;
+    else if (name == "verboseDevices")                          iss >> verboseDevices;
+    else if (name == "verboseDebug")                            iss >> verboseDebug;
+    else if (name == "outputDebug")                             iss >> outputDebug;
+    else if (name == "outputFrames")                            iss >> outputFrames;
+    else if (name == "outputROI")                               iss >> outputROI;
+    else if (name == "outputLocalROI")                          iss >> outputLocalROI;
+    else if (name == "roiOutputSize")                           iss >> roiOutputSize;
+    else if (name == "outputDirsClearOnStart")                  iss >> outputDirsClearOnStart;
+    else if (name == "outputWriterThreads")                     iss >> outputWriterThreads;
+    else if (name == "outputQueueSize")                         iss >> outputQueueSize;
+    else if (name == "outputFramesVideo")                       iss >> outputFramesVideo;
+    else if (name == "outputVideoFPS")                          iss >> outputVideoFPS;
+    else if (name == "flipFrames")                              iss >> flipFrames;
+    else if (name == "displayFrames")                           iss >> displayFrames;
+    else if (name == "displayFrameRate")                        iss >> displayFrameRate;
+    else if (name == "displayFrameNumber")                      iss >> displayFrameNumber;
+    else if (name == "displaySequenceTrackID")                  iss >> displaySequenceTrackID;
+    else if (name == "displayWindowX")                          iss >> displayWindowX;
+    else if (name == "displayWindowY")                          iss >> displayWindowY;
+    else if (name == "displayWindowW")                          iss >> displayWindowW;
+    else if (name == "displayWindowH")                          iss >> displayWindowH;
+    else if (name == "displayOldROI")                           iss >> displayOldROI;
+    else if (name == "roiColorMode")                            iss >> roiColorMode;
+    else if (name == "roiThickness")                            iss >> roiThickness;
+    else if (name == "roiThicknessOld")                         iss >> roiThicknessOld;
+    // plot display
+    else if (name == "displayPlots")                            iss >> displayPlots;
+    else if (name == "plotAccumulationPoints")                  iss >> plotAccumulationPoints;
+    else if (name == "plotFigureWidth")                         iss >> plotFigureWidth;
+    else if (name == "plotFigureHeight")                        iss >> plotFigureHeight;
+    else if (name == "plotTrackDirection")                      iss >> plotTrackDirection;
+    else if (name == "plotMaxTracks")                           iss >> plotMaxTracks;
+    else if (name == "plotMaxPOI")                              iss >> plotMaxPOI;
+    else if (name == "plotResetOnTrackLost")                    iss >> plotResetOnTrackLost;
+    // multiple streams processing
+    else if (name == "multiStreamWorkers")                      iss >> multiStreamWorkers;
+    else if (name == "multiStreamOmpThreads")                   iss >> multiStreamOmpThreads;
+    else if (name == "testSequenceWorkers")                     iss >> testSequenceWorkers;
+    // load shedding
+    else if (name == "loadSheddingBudget")                      iss >> loadSheddingBudget;
+    else if (name == "loadSheddingRecoverRatio")                iss >> loadSheddingRecoverRatio;
+    else if (name == "loadSheddingHoldFrames")                  iss >> loadSheddingHoldFrames;
+    // configuration reload
+    else if (name == "configHotReload")                         iss >> configHotReload;
+    else return false;
+    return true;
 }
 
 void ConfigFile::setDefaults()
@@ -400,7 +550,11 @@ void ConfigFile::setDefaults()
     cameraType                  = CameraType::UNDEFINED;
     cameraIndex                 = -1;
     useCameraTrigger            = false;
+    frameDecodeThreads          = 0;
+    frameReadAhead              = 8;
+    frameDecodeReduction        = 1;
 
+    DNN                         = false;
     FRCNN                       = false;
     HaarCascadeFrontal          = true;
     HaarCascadeProfile          = true;
@@ -438,6 +592,25 @@ void ConfigFile::setDefaults()
     modelsFileLoad              = false;
     modelsFileDir               = "./models/";
 
+    recognitionScheduling           = false;
+    recognitionMinQuality           = 0.2;
+    recognitionWindowSize           = 10;
+    recognitionProbesPerWindow      = 3;
+    recognitionFrameBudget          = 0;
+    recognitionStableDelta          = 0.5;
+    recognitionStableInterval       = 15;
+
+    galleryIndex                    = false;
+    galleryShortlistSize            = 32;
+    galleryIndexLists               = 0;
+    galleryIndexProbes              = 4;
+    galleryExactMaxSize             = 500;
+
+    templateQuantization            = 0;
+    templateQuantizationCheck       = false;
+
+    useSharedCellHOG                = false;
+
     searchRadius                            = 30;
     useHungarianMatching                    = false;
     associationTrackThreshold               = 90;
@@ -449,6 +622,20 @@ void ConfigFile::setDefaults()
     createTrackConfidenceThreshold          = 0.25;
     trackerOverlapThreshold                 = 0.6;
     detectionFrameInterval                  = 3;
+    detectionMotionGating                   = false;
+    detectionMaxFrameInterval               = 15;
+    detectionFullSweepInterval              = 30;
+    motionThreshold                         = 25;
+    motionLearningRate                      = 0.05;
+    motionDownscale                         = 0.25;
+    motionFullFrameRatio                    = 0.5;
+    kcfUseHOG                               = true;
+    kcfTemplateSize                         = 96;
+    kcfPadding                              = 2.5;
+    kcfScaleStep                            = 1.05;
+    struckMotionPrediction                  = false;
+    struckMinSearchRadius                   = 8;
+    struckCoarseToFine                      = false;
     features.clear();
 
     face.overlapThreshold   = 0.1;
@@ -458,6 +645,17 @@ void ConfigFile::setDefaults()
     face.minSize            = cv::Size(25, 25);
     face.maxSize            = cv::Size(120, 120);
     face.confidenceSize     = cv::Size(40, 40);
+    faceTileSize            = 0;
+    dnnModelFile            = "dnn/deploy.prototxt";
+    dnnWeightsFile          = "dnn/res10_300x300_ssd_iter_140000.caffemodel";
+    dnnInputSize            = 300;
+    dnnConfidenceThreshold  = 0.5;
+    dnnInputScale           = 1.0;
+    dnnInputMean            = cv::Scalar(104, 177, 123);    // Caffe ResNet-SSD face model (BGR)
+    dnnSwapRB               = false;
+    dnnBatchSize            = 8;
+    dnnBatchWait            = 0;
+    dnnThreads              = 0;
 
     useEyesDetection        = false;
     useEyeLocalizedPosition = false;
@@ -481,6 +679,10 @@ void ConfigFile::setDefaults()
     outputLocalROI          = true;
     roiOutputSize           = 96;
     outputDirsClearOnStart  = false;
+    outputWriterThreads     = 2;
+    outputQueueSize         = 64;
+    outputFramesVideo       = false;
+    outputVideoFPS          = 25.0;
     flipFrames              = false;
     displayFrames           = true;
     displayFrameRate        = false;
@@ -503,6 +705,16 @@ void ConfigFile::setDefaults()
     plotMaxTracks           = 10;
     plotMaxPOI              = 10;
     plotResetOnTrackLost    = true;
+
+    multiStreamWorkers      = 0;
+    multiStreamOmpThreads   = 1;
+    testSequenceWorkers     = 1;
+
+    loadSheddingBudget          = 0;
+    loadSheddingRecoverRatio    = 0.7;
+    loadSheddingHoldFrames      = 15;
+
+    configHotReload         = false;
 }
 
 void ConfigFile::validateValues()
@@ -524,6 +736,28 @@ void ConfigFile::validateValues()
     }
     else if (!useReferenceNegativeStills)
         ASSERT_WARN(!useGeometricNegativeStills, "Config 'useGeometricNegativeStills' ignored since 'useReferenceNegativeStills' is disabled");
+    if (useFaceRecognition && recognitionScheduling) {
+        ASSERT_LOG(recognitionMinQuality >= 0.0 && recognitionMinQuality <= 1.0, "Config 'recognitionMinQuality' not in range [0,1]");
+        ASSERT_LOG(recognitionWindowSize > 0, "Config 'recognitionWindowSize' not greater than 0");
+        ASSERT_LOG(recognitionProbesPerWindow > 0 && recognitionProbesPerWindow <= recognitionWindowSize,
+                   "Config 'recognitionProbesPerWindow' not in range ]0,recognitionWindowSize]");
+        ASSERT_LOG(recognitionFrameBudget >= 0, "Config 'recognitionFrameBudget' not greater or equal to 0");
+        ASSERT_LOG(recognitionStableDelta >= 0.0, "Config 'recognitionStableDelta' not greater or equal to 0");
+        ASSERT_LOG(recognitionStableInterval > 0, "Config 'recognitionStableInterval' not greater than 0");
+    }
+    if (useFaceRecognition && galleryIndex) {
+        ASSERT_WARN(TM, "Config 'galleryIndex' only applies to 'TM' classifier");
+        ASSERT_LOG(galleryShortlistSize > 0, "Config 'galleryShortlistSize' not greater than 0");
+        ASSERT_LOG(galleryIndexLists >= 0, "Config 'galleryIndexLists' not greater or equal to 0");
+        ASSERT_LOG(galleryIndexProbes > 0, "Config 'galleryIndexProbes' not greater than 0");
+        ASSERT_LOG(galleryExactMaxSize >= 0, "Config 'galleryExactMaxSize' not greater or equal to 0");
+    }
+    if (useFaceRecognition && templateQuantization != 0) {
+        ASSERT_WARN(TM, "Config 'templateQuantization' only applies to 'TM' classifier");
+        ASSERT_LOG(templateQuantization == 1 || templateQuantization == 2, "Config 'templateQuantization' unknown value");
+    }
+    if (useFaceRecognition && useSharedCellHOG)
+        ASSERT_WARN(TM, "Config 'useSharedCellHOG' only applies to 'TM' classifier");
 
     ASSERT_LOG(face.overlapThreshold >= 0.0 && face.overlapThreshold <= 1.0, "'faceOverlapThreshold' not in range [0,1]");
     ASSERT_LOG(face.scaleFactor > 1.0, "Config 'faceScaleFactor' not greater than 1");
@@ -533,6 +767,7 @@ void ConfigFile::validateValues()
     ASSERT_LOG(face.confidenceSize.width > 0 && face.confidenceSize.height > 0, "Config 'faceConfidenceSize' not greater than zero");
     ASSERT_LOG(face.maxSize.width > face.minSize.width && face.maxSize.height > face.minSize.height,
                "Config 'faceMaxSize' not greater than 'faceMinSize'");
+    ASSERT_LOG(faceTileSize >= 0, "Config 'faceTileSize' not greater or equal to 0");
 
     if (!useEyesDetection)
         ASSERT_WARN(!useEyeLocalizedPosition, "Config 'useEyeLocalizedPosition' will be ignored since 'useEyesDetection' is disabled");
@@ -561,13 +796,36 @@ void ConfigFile::validateValues()
     ASSERT_LOG(createTrackConfidenceThreshold >= 0, "Config 'createTrackConfidenceThreshold' not greater or equal to 0");
     ASSERT_LOG(trackerOverlapThreshold >= 0.0 && trackerOverlapThreshold <= 1.0, "Config 'trackerOverlapThreshold' not in range [0,1]");
     ASSERT_LOG(detectionFrameInterval > 0, "Config 'detectionFrameInterval' not greater than 0");
+    if (detectionMotionGating) {
+        ASSERT_LOG(detectionMaxFrameInterval >= detectionFrameInterval, "Config 'detectionMaxFrameInterval' not greater or equal to 'detectionFrameInterval'");
+        ASSERT_LOG(detectionFullSweepInterval >= detectionFrameInterval, "Config 'detectionFullSweepInterval' not greater or equal to 'detectionFrameInterval'");
+        ASSERT_LOG(motionThreshold > 0 && motionThreshold < 256, "Config 'motionThreshold' not in range ]0,255]");
+        ASSERT_LOG(motionLearningRate > 0.0 && motionLearningRate <= 1.0, "Config 'motionLearningRate' not in range ]0,1]");
+        ASSERT_LOG(motionDownscale > 0.0 && motionDownscale <= 1.0, "Config 'motionDownscale' not in range ]0,1]");
+        ASSERT_LOG(motionFullFrameRatio > 0.0 && motionFullFrameRatio <= 1.0, "Config 'motionFullFrameRatio' not in range ]0,1]");
+    }
+    if (KCF) {
+        ASSERT_LOG(kcfTemplateSize >= 16, "Config 'kcfTemplateSize' not greater or equal to 16");
+        ASSERT_LOG(kcfPadding >= 1.0, "Config 'kcfPadding' not greater or equal to 1");
+        ASSERT_LOG(kcfScaleStep >= 1.0, "Config 'kcfScaleStep' not greater or equal to 1");
+    }
+    if (STRUCK && struckMotionPrediction)
+        ASSERT_LOG(struckMinSearchRadius > 0 && struckMinSearchRadius <= searchRadius, "Config 'struckMinSearchRadius' not in range ]0,searchRadius]");
     if (useLocalSearchROI)
         ASSERT_LOG(bboxSizeMultiplyer > 0.0, "Config 'bboxSizeMultiplyer' not greater than 0");
 
     ASSERT_LOG(cameraType.isDefined(), "Config 'cameraType' undefined: [" + cameraType.name() + "]");
     ASSERT_LOG(cameraIndex >= 0, "Config 'cameraIndex' not greater or equal to 0");
+    ASSERT_LOG(frameDecodeThreads >= 0, "Config 'frameDecodeThreads' not greater or equal to 0");
+    ASSERT_LOG(frameReadAhead > 0, "Config 'frameReadAhead' not greater than 0");
+    ASSERT_LOG(frameDecodeReduction == 1 || frameDecodeReduction == 2 || frameDecodeReduction == 4 || frameDecodeReduction == 8,
+               "Config 'frameDecodeReduction' must be one of {1,2,4,8}");
 
     ASSERT_LOG(roiOutputSize > 0, "Config 'roiOutputSize' not greater than 0");
+    ASSERT_LOG(outputWriterThreads >= 0, "Config 'outputWriterThreads' not greater or equal to 0");
+    ASSERT_LOG(outputQueueSize > 0, "Config 'outputQueueSize' not greater than 0");
+    if (outputFramesVideo)
+        ASSERT_LOG(outputVideoFPS > 0, "Config 'outputVideoFPS' not greater than 0");
     ASSERT_LOG(roiThickness > 0, "Config 'roiThickness' not greater than 0");
     ASSERT_LOG(roiThicknessOld > 0, "Config 'roiThicknessOld' not greater than 0");
 
@@ -580,8 +838,18 @@ void ConfigFile::validateValues()
         ASSERT_LOG(plotMaxPOI > 0, "Config 'plotMaxPOI' not greater than 0");
     }
 
+    ASSERT_LOG(multiStreamWorkers >= 0, "Config 'multiStreamWorkers' not greater or equal to 0");
+    ASSERT_LOG(multiStreamOmpThreads >= 0, "Config 'multiStreamOmpThreads' not greater or equal to 0");
+    ASSERT_LOG(testSequenceWorkers >= 0, "Config 'testSequenceWorkers' not greater or equal to 0");
+
+    ASSERT_LOG(loadSheddingBudget >= 0, "Config 'loadSheddingBudget' not greater or equal to 0");
+    if (loadSheddingBudget > 0) {
+        ASSERT_LOG(loadSheddingRecoverRatio > 0 && loadSheddingRecoverRatio < 1, "Config 'loadSheddingRecoverRatio' not in range ]0,1[");
+        ASSERT_LOG(loadSheddingHoldFrames > 0, "Config 'loadSheddingHoldFrames' not greater than 0");
+    }
+
     bool anyCascade = requireAnyCascade();
-    ASSERT_LOG((anyCascade ^ SSD ^ FRCNN ^ YOLO) ^ (anyCascade & SSD & FRCNN & YOLO),
+    ASSERT_LOG((anyCascade ^ SSD ^ FRCNN ^ YOLO ^ DNN) ^ (anyCascade & SSD & FRCNN & YOLO & DNN),
                "At least one and only one face detector type can be used at the same time!");
     ASSERT_LOG((STRUCK ^ KCF ^ Camshift ^ Compressive) ^ (STRUCK & KCF & Camshift & Compressive),
                "At least one and only one face tracker type can be used at the same time!");
@@ -601,6 +869,17 @@ void ConfigFile::validateValues()
         THROW("Face detector YOLO specified in config cannot be used without 'FACE_RECOG_HAS_YOLO' definition");
         #endif/*FACE_RECOG_HAS_YOLO*/
     }
+    if (DNN) {
+        #ifndef FACE_RECOG_HAS_DNN
+        THROW("Face detector DNN specified in config cannot be used without 'FACE_RECOG_HAS_DNN' definition");
+        #endif/*FACE_RECOG_HAS_DNN*/
+        ASSERT_LOG(dnnInputSize > 0, "Config 'dnnInputSize' not greater than 0");
+        ASSERT_LOG(dnnConfidenceThreshold >= 0 && dnnConfidenceThreshold <= 1, "Config 'dnnConfidenceThreshold' not in range [0,1]");
+        ASSERT_LOG(dnnInputScale > 0, "Config 'dnnInputScale' not greater than 0");
+        ASSERT_LOG(dnnBatchSize > 0, "Config 'dnnBatchSize' not greater than 0");
+        ASSERT_LOG(dnnBatchWait >= 0, "Config 'dnnBatchWait' not greater or equal to 0");
+        ASSERT_LOG(dnnThreads >= 0, "Config 'dnnThreads' not greater or equal to 0");
+    }
 
     ASSERT_LOG(roiAccumulationSize > 0, "Config 'roiAccumulationSize' not greater than 0");
     ASSERT_WARN(useFaceRecognition, "Config 'useFaceRecognition' detected will disable all face recognition operations and checks");
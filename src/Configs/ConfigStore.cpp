@@ -0,0 +1,167 @@
+﻿#include "Configs/ConfigStore.h"
+#include "FaceRecog.h"
+#include <csignal>
+#include <set>
+
+// set by reload requests, consumed by the next poll
+static volatile std::sig_atomic_t reloadRequested = 0;
+
+static void onReloadSignal(int)
+{
+    reloadRequested = 1;
+}
+
+// parameters only read per frame, by schedulers reconfigured on reload or by tracks created afterwards
+static const std::set<std::string> runtimeParameters =
+{
+    "thresholdFaceConsidered", "thresholdFaceRecognized",
+    "recognitionScheduling", "recognitionMinQuality", "recognitionWindowSize", "recognitionProbesPerWindow",
+    "recognitionFrameBudget", "recognitionStableDelta", "recognitionStableInterval",
+    "searchRadius", "useHungarianMatching", "associationTrackThreshold",
+    "removeTrackCountThresholdInBounds", "removeTrackCountThresholdOutBounds",
+    "removeTrackConfidenceInBounds", "removeTrackConfidenceOutBounds",
+    "createTrackCountThreshold", "createTrackConfidenceThreshold", "trackerOverlapThreshold", "detectionAugmentationOffset",
+    "detectionFrameInterval", "detectionMotionGating", "detectionMaxFrameInterval", "detectionFullSweepInterval",
+    "motionThreshold", "motionLearningRate", "motionDownscale", "motionFullFrameRatio",
+    "kcfUseHOG", "kcfTemplateSize", "kcfPadding", "kcfScaleStep",
+    "struckMotionPrediction", "struckMinSearchRadius", "struckCoarseToFine",
+    "seed", "svmC", "svmBudgetSize",
+    "bboxSizeMultiplyer",
+    "displayFrameRate", "displayFrameNumber", "displaySequenceTrackID", "displayOldROI", "roiThickness", "roiThicknessOld",
+    "loadSheddingBudget", "loadSheddingRecoverRatio", "loadSheddingHoldFrames"
+};
+
+static bool sameFeatures(const ConfigFile& a, const ConfigFile& b)
+{
+    if (a.features.size() != b.features.size())
+        return false;
+    for (size_t f = 0; f < a.features.size(); ++f)
+        if (a.features[f].feature != b.features[f].feature || a.features[f].kernel != b.features[f].kernel
+            || a.features[f].params != b.features[f].params)
+            return false;
+    return true;
+}
+
+// single parameter applied on the active configuration, values only valid in combination with others are considered changed
+static bool isChanged(const ConfigFile& active, const std::string& activeDisplay, const std::string& name, const std::string& value)
+{
+    ConfigFile probe(active);
+    try { probe.setValue(name, value); }
+    catch (std::exception&) { return true; }
+    return probe.display() != activeDisplay;
+}
+
+ConfigStore::ConfigStore(const std::string& path)
+    : path(path)
+    , snapshot(std::make_shared<const ConfigFile>(path))
+    , version(1)
+{
+    boost::system::error_code ec;
+    lastWriteTime = bfs::last_write_time(path, ec);
+}
+
+ConfigSnapshot ConfigStore::current() const
+{
+    return std::atomic_load(&snapshot);
+}
+
+void ConfigStore::requestReload()
+{
+    reloadRequested = 1;
+}
+
+void ConfigStore::installReloadSignal()
+{
+    #if defined(FACE_RECOG_LINUX)
+    std::signal(SIGHUP, onReloadSignal);
+    #endif
+}
+
+bool ConfigStore::isRuntimeParameter(const std::string& name)
+{
+    return runtimeParameters.find(name) != runtimeParameters.end();
+}
+
+bool ConfigStore::readValues(std::vector<std::pair<std::string, std::string> >& values) const
+{
+    ifstream f(path.c_str());
+    if (!f)
+        return false;
+
+    // same tokens as 'ConfigFile::parseLine', value is the remaining of the line
+    string line;
+    while (getline(f, line))
+    {
+        string name, tmp, value;
+        istringstream iss(line);
+        iss >> name >> tmp;
+        if (iss.fail() || tmp != "=" || name[0] == '#')
+            continue;
+        getline(iss >> std::ws, value);
+        boost::algorithm::trim(value);
+        values.push_back(std::make_pair(name, value));
+    }
+    return true;
+}
+
+bool ConfigStore::poll(logstream& log)
+{
+    boost::system::error_code ec;
+    std::time_t writeTime = bfs::last_write_time(path, ec);
+    bool modified = !ec && writeTime != lastWriteTime;
+    if (!modified && !reloadRequested)
+        return false;
+    reloadRequested = 0;
+    if (!ec)
+        lastWriteTime = writeTime;
+
+    // complete file must be valid on its own, otherwise keep the current snapshot
+    ConfigSnapshot active = current();
+    std::shared_ptr<ConfigFile> next;
+    std::vector<std::string> applied, restart;
+    try
+    {
+        ConfigFile loaded(path);
+        std::vector<std::pair<std::string, std::string> > values;
+        ASSERT_LOG(readValues(values), "could not read config file: '" + path + "'");
+
+        std::vector<std::pair<std::string, std::string> > runtimeValues;
+        std::string activeDisplay = active->display();
+        for (size_t v = 0; v < values.size(); ++v)
+        {
+            const std::string& name = values[v].first;
+            if (name == "feature")
+                continue;   // accumulated by each line, compared as a whole below
+            if (!isChanged(*active, activeDisplay, name, values[v].second))
+                continue;
+            if (isRuntimeParameter(name)) {
+                runtimeValues.push_back(values[v]);
+                applied.push_back(name);
+            }
+            else restart.push_back(name);
+        }
+        next = std::make_shared<ConfigFile>(*active);
+        next->setValues(runtimeValues);
+        if (!sameFeatures(loaded, *active))
+            restart.push_back("feature");
+    }
+    catch (std::exception& ex)
+    {
+        log << "Config reload failed, keeping version " << version.load() << ": " << ex.what() << std::endl;
+        return false;
+    }
+
+    if (!restart.empty())
+        log << "Config changes requiring a restart ignored: " << boost::algorithm::join(restart, ", ") << std::endl;
+    if (applied.empty())
+        return false;
+
+    // snapshots only referenced by the store are no longer employed by any reader
+    retired.erase(std::remove_if(retired.begin(), retired.end(), [](const ConfigSnapshot& s) { return s.use_count() == 1; }),
+                  retired.end());
+    retired.push_back(active);
+    std::atomic_store(&snapshot, ConfigSnapshot(next));
+    ++version;
+    log << "Config version " << version.load() << " applied: " << boost::algorithm::join(applied, ", ") << std::endl;
+    return true;
+}
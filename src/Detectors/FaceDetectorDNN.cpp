@@ -0,0 +1,255 @@
+﻿#ifdef FACE_RECOG_HAS_DNN
+
+#include "Detectors/FaceDetectorDNN.h"
+#include "FaceRecog.h"
+
+FaceDetectionNetwork::FaceDetectionNetwork(const std::string& modelPath, const std::string& weightsPath, cv::Size inputSize,
+                                           int maxBatchSize, int batchWaitMs, double inputScale, cv::Scalar inputMean, bool swapRB)
+{
+    // ONNX models are self-contained, Caffe models require both the prototxt and caffemodel files
+    net = cv::dnn::readNet(weightsPath, modelPath);
+    ASSERT_LOG(!net.empty(), "Failed to load DNN face detector model [" + weightsPath + "]");
+    net.setPreferableBackend(cv::dnn::DNN_BACKEND_DEFAULT);
+    net.setPreferableTarget(cv::dnn::DNN_TARGET_CPU);
+    this->weightsPath = weightsPath;
+    this->inputSize = inputSize;
+    this->maxBatchSize = std::max(maxBatchSize, 1);
+    this->batchWaitMs = std::max(batchWaitMs, 0);
+    this->inputScale = inputScale;
+    this->inputMean = inputMean;
+    this->swapRB = swapRB;
+    pendingImages = 0;
+    forwarding = false;
+}
+
+std::shared_ptr<FaceDetectionNetwork> FaceDetectionNetwork::getShared(const std::string& modelPath, const std::string& weightsPath, cv::Size inputSize,
+                                                                      int maxBatchSize, int batchWaitMs, double inputScale, cv::Scalar inputMean, bool swapRB)
+{
+    // detectors requesting other input or batching parameters get their own network
+    std::ostringstream key;
+    key << modelPath << "|" << weightsPath << "|" << inputSize << "|" << maxBatchSize << "|" << batchWaitMs
+        << "|" << inputScale << "|" << inputMean << "|" << swapRB;
+
+    static std::mutex sharedMutex;
+    static std::map<std::string, std::weak_ptr<FaceDetectionNetwork> > sharedNetworks;
+    std::lock_guard<std::mutex> lock(sharedMutex);
+    std::shared_ptr<FaceDetectionNetwork> network = sharedNetworks[key.str()].lock();
+    if (!network) {
+        network = std::make_shared<FaceDetectionNetwork>(modelPath, weightsPath, inputSize, maxBatchSize, batchWaitMs,
+                                                         inputScale, inputMean, swapRB);
+        sharedNetworks[key.str()] = network;
+    }
+    return network;
+}
+
+void FaceDetectionNetwork::detect(const std::vector<cv::Mat>& images, std::vector<std::vector<cv::Rect> >& bboxes,
+                                  std::vector<std::vector<float> >& confidences)
+{
+    Request request;
+    request.images = &images;
+    request.bboxes = &bboxes;
+    request.confidences = &confidences;
+
+    std::unique_lock<std::mutex> lock(queueMutex);
+    pending.push_back(&request);
+    pendingImages += images.size();
+    queueChanged.notify_all();
+    while (!request.done)
+    {
+        // another caller is forwarding, the request is either part of its batch or taken by the next one
+        if (forwarding) {
+            queueChanged.wait(lock);
+            continue;
+        }
+
+        // gather requests of concurrent callers until the batch is full or the wait expires
+        forwarding = true;
+        queueChanged.wait_for(lock, std::chrono::milliseconds(batchWaitMs),
+                              [this] { return pendingImages >= (size_t)maxBatchSize; });
+        std::vector<Request*> batch(pending.begin(), pending.end());
+        pending.clear();
+        pendingImages = 0;
+        lock.unlock();
+        std::exception_ptr error;
+        try { forward(batch); }
+        catch (...) { error = std::current_exception(); }
+        lock.lock();
+
+        // waiting callers must be released even when the forward pass failed, each of them rethrows the error
+        for (size_t r = 0; r < batch.size(); ++r) {
+            batch[r]->error = error;
+            batch[r]->done = true;
+        }
+        forwarding = false;
+        queueChanged.notify_all();
+    }
+    if (request.error)
+        std::rethrow_exception(request.error);
+}
+
+void FaceDetectionNetwork::forward(const std::vector<Request*>& batch)
+{
+    std::vector<const cv::Mat*> images;
+    std::vector<std::pair<size_t, size_t> > origins;    // (request, image)
+    for (size_t r = 0; r < batch.size(); ++r) {
+        size_t nImages = batch[r]->images->size();
+        batch[r]->bboxes->assign(nImages, std::vector<cv::Rect>());
+        batch[r]->confidences->assign(nImages, std::vector<float>());
+        for (size_t i = 0; i < nImages; ++i) {
+            images.push_back(&(*batch[r]->images)[i]);
+            origins.push_back(std::make_pair(r, i));
+        }
+    }
+
+    for (size_t start = 0; start < images.size(); start += maxBatchSize)
+    {
+        // colour input blob of network size, buffers reused across passes
+        size_t nBlob = std::min((size_t)maxBatchSize, images.size() - start);
+        colorImages.resize(nBlob);
+        for (size_t b = 0; b < nBlob; ++b) {
+            const cv::Mat& image = *images[start + b];
+            if (image.channels() == 3)
+                cv::resize(image, colorImages[b], inputSize, 0, 0, cv::INTER_AREA);
+            else {
+                cv::resize(image, resizedImage, inputSize, 0, 0, cv::INTER_AREA);
+                cv::cvtColor(resizedImage, colorImages[b], image.channels() == 1 ? cv::COLOR_GRAY2BGR : cv::COLOR_BGRA2BGR);
+            }
+        }
+        cv::dnn::blobFromImages(colorImages, inputBlob, inputScale, inputSize, inputMean, swapRB, false);
+        net.setInput(inputBlob);
+        cv::Mat output = net.forward();
+
+        // detections rows [image, label, confidence, x1, y1, x2, y2] of the whole blob
+        cv::Mat rows(output.size[2], output.size[3], CV_32F, output.ptr<float>());
+        for (int d = 0; d < rows.rows; ++d)
+        {
+            const float* row = rows.ptr<float>(d);
+            int b = (int)row[0];
+            if (b < 0 || b >= (int)nBlob)
+                continue;
+            const cv::Mat& image = *images[start + b];
+            cv::Rect bbox(cv::Point((int)(row[3] * image.cols), (int)(row[4] * image.rows)),
+                          cv::Point((int)(row[5] * image.cols), (int)(row[6] * image.rows)));
+            bbox &= cv::Rect(0, 0, image.cols, image.rows);
+            if (bbox.area() <= 0)
+                continue;
+            const std::pair<size_t, size_t>& origin = origins[start + b];
+            (*batch[origin.first]->bboxes)[origin.second].push_back(bbox);
+            (*batch[origin.first]->confidences)[origin.second].push_back(row[2]);
+        }
+    }
+}
+
+FaceDetectorDNN::FaceDetectorDNN(std::shared_ptr<FaceDetectionNetwork> network, double confidenceThreshold,
+                                 cv::Size minSize, cv::Size maxSize, int tileSize, double overlapThreshold)
+{
+    ASSERT_LOG(network != nullptr, "DNN face detector requires a loaded network");
+    this->network = network;
+    this->confidenceThreshold = confidenceThreshold;
+    this->minSize = minSize;
+    this->maxSize = maxSize;
+    this->tileSize = tileSize;
+    this->overlapThreshold = overlapThreshold;
+    modelPaths.push_back(network->getWeightsPath());
+}
+
+void FaceDetectorDNN::assignImage(const FACE_RECOG_MAT& frame)
+{
+    cleanImages();
+    frames.push_back(frame);
+}
+
+void FaceDetectorDNN::assignImage(const FrameContext& context)
+{
+    assignImage(context.getFrame());
+}
+
+// Tiles overlapping by the maximum face size so that any detectable face lies entirely within at least one tile
+std::vector<cv::Rect> FaceDetectorDNN::computeTiles(cv::Size frameSize) const
+{
+    std::vector<cv::Rect> tiles;
+    int overlap = std::max(maxSize.width, maxSize.height);
+    int tileDim = std::max(tileSize, 2 * overlap);
+    if (tileSize <= 0 || (frameSize.width <= tileDim && frameSize.height <= tileDim))
+        return tiles;
+
+    std::vector<int> xs, ys;
+    int step = tileDim - overlap;
+    for (int x = 0; ; x += step) {
+        xs.push_back(std::min(x, std::max(frameSize.width - tileDim, 0)));
+        if (x + tileDim >= frameSize.width) break;
+    }
+    for (int y = 0; ; y += step) {
+        ys.push_back(std::min(y, std::max(frameSize.height - tileDim, 0)));
+        if (y + tileDim >= frameSize.height) break;
+    }
+    for (size_t j = 0; j < ys.size(); ++j)
+        for (size_t i = 0; i < xs.size(); ++i)
+            tiles.push_back(cv::Rect(xs[i], ys[j], tileDim, tileDim) & cv::Rect(cv::Point(0, 0), frameSize));
+    return tiles;
+}
+
+bool FaceDetectorDNN::detect(std::vector<std::vector<cv::Rect> >& bboxes)
+{
+    ASSERT_LOG(frames.size() == 1, "DNN face detector expects a single assigned image in `FaceDetectorDNN::detect`");
+    bboxes = std::vector<std::vector<cv::Rect> >(1);
+
+    // whole frame for large faces, and tiles for small faces of high resolution frames, all in the same batch
+    cv::Mat frame = GET_MAT(frames[0], ACCESS_READ);
+    std::vector<cv::Rect> regions = computeTiles(frame.size());
+    regions.insert(regions.begin(), cv::Rect(0, 0, frame.cols, frame.rows));
+    std::vector<cv::Mat> images(regions.size());
+    for (size_t r = 0; r < regions.size(); ++r)
+        images[r] = frame(regions[r]);
+
+    std::vector<std::vector<cv::Rect> > found;
+    std::vector<std::vector<float> > foundConfidences;
+    network->detect(images, found, foundConfidences);
+
+    std::vector<cv::Rect> candidates;
+    std::vector<float> confidences;
+    for (size_t r = 0; r < regions.size(); ++r) {
+        for (size_t d = 0; d < found[r].size(); ++d) {
+            cv::Rect bbox = found[r][d] + regions[r].tl();
+            if (foundConfidences[r][d] < confidenceThreshold || bbox.width < minSize.width || bbox.height < minSize.height
+                || (maxSize != cv::Size() && (bbox.width > maxSize.width || bbox.height > maxSize.height)))
+                continue;
+            candidates.push_back(bbox);
+            confidences.push_back(foundConfidences[r][d]);
+        }
+    }
+
+    // duplicates of overlapping tiles and whole frame removed
+    std::vector<int> keep;
+    cv::dnn::NMSBoxes(candidates, confidences, (float)confidenceThreshold, (float)overlapThreshold, keep);
+    for (size_t k = 0; k < keep.size(); ++k)
+        bboxes[0].push_back(candidates[keep[k]]);
+    return true;
+}
+
+double FaceDetectorDNN::evaluateConfidence(const Track& track, const FACE_RECOG_MAT& image)
+{
+    // highest confidence of a detection centered within the track, searched in a slightly enlarged region
+    cv::Rect face = track.bbox();
+    cv::Rect region(face.x - face.width / 4, face.y - face.height / 4, face.width * 3 / 2, face.height * 3 / 2);
+    cv::Mat frame = GET_MAT(image, ACCESS_READ);
+    region &= cv::Rect(0, 0, frame.cols, frame.rows);
+    if (region.area() <= 0)
+        return 0;
+
+    std::vector<cv::Mat> images(1, frame(region));
+    std::vector<std::vector<cv::Rect> > found;
+    std::vector<std::vector<float> > confidences;
+    network->detect(images, found, confidences);
+
+    double maxConfidence = 0;
+    for (size_t d = 0; d < found[0].size(); ++d) {
+        cv::Rect bbox = found[0][d] + region.tl();
+        cv::Point center(bbox.x + bbox.width / 2, bbox.y + bbox.height / 2);
+        if (face.contains(center))
+            maxConfidence = std::max(maxConfidence, (double)confidences[0][d]);
+    }
+    return maxConfidence;
+}
+
+#endif/*FACE_RECOG_HAS_DNN*/
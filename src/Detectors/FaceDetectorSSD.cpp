@@ -113,7 +113,7 @@ double FaceDetectorSSD::evaluateConfidence(const Track& track, const FACE_RECOG_
     double score = 0;
     #pragma omp parallel for
     for (long f = 0; f < nFaces; ++f) {
-        croppedFaces[f] = imResize(imFlip(image(face).clone(), faceFlipModes[f]), evalSize);
+        croppedFaces[f] = imResize(imFlip(image(face), faceFlipModes[f]), evalSize);
         double tempWeights = 0;
         confidences[f] = faceFinder[f].classify(croppedFaces[f], tempWeights);
     }
@@ -33,6 +33,7 @@ FaceDetectorVJ::FaceDetectorVJ(double scaleFactor, int nmsThreshold, cv::Size mi
 
 void FaceDetectorVJ::setDefaults()
 {
+    tileSize = 0;
     initializeParameters(1.2, 4, Size(20, 20), Size(60, 60), Size(40, 40), 0, 0.1);
 }
 
@@ -84,6 +85,17 @@ void FaceDetectorVJ::assignImage(const FACE_RECOG_MAT& frame)
     }
 }
 
+// flipped frames are shared through the context instead of being flipped again by each model
+void FaceDetectorVJ::assignImage(const FrameContext& context)
+{
+    cleanImages();
+    size_t nClassifiers = faceFinder.size();
+    for (size_t i = 0; i < nClassifiers; ++i) {
+        FlipMode fm = (i < faceFlipModes.size()) ? faceFlipModes[i] : NONE;
+        frames.push_back(context.getFlipped(fm));
+    }
+}
+
 bool FaceDetectorVJ::detect(vector<vector<Rect>>& bboxes)
 {
     size_t nClassifiers = faceFinder.size();
@@ -93,6 +105,11 @@ bool FaceDetectorVJ::detect(vector<vector<Rect>>& bboxes)
     if (bboxes.size() != nClassifiers)
         bboxes = std::vector<std::vector<Rect>>(nClassifiers);
 
+    #if !FACE_RECOG_USE_CUDA
+    if (tileSize > 0 && nImages > 0 && (frames[0].cols > tileSize || frames[0].rows > tileSize))
+        return detectTiled(bboxes);
+    #endif
+
     #pragma omp parallel for
     for (omp_size_t c = 0; c < nClassifiers; ++c)
     {
@@ -107,6 +124,110 @@ bool FaceDetectorVJ::detect(vector<vector<Rect>>& bboxes)
     return true;
 }
 
+/*
+    Tiles overlapping by the maximum face size so that any detectable face lies entirely within at least one tile
+
+    Core regions split the frame between tiles at the middle of their overlaps. A face centered in a tile core is
+    entirely within that tile since half the overlap is no smaller than half the maximum face size.
+*/
+std::vector<cv::Rect> FaceDetectorVJ::computeTiles(cv::Size frameSize, int tileDim, int overlap, std::vector<cv::Rect>& cores) const
+{
+    std::vector<int> xs, ys;
+    int step = tileDim - overlap;
+    for (int x = 0; ; x += step) {
+        xs.push_back(std::min(x, std::max(frameSize.width - tileDim, 0)));
+        if (x + tileDim >= frameSize.width) break;
+    }
+    for (int y = 0; ; y += step) {
+        ys.push_back(std::min(y, std::max(frameSize.height - tileDim, 0)));
+        if (y + tileDim >= frameSize.height) break;
+    }
+    // core bounds at the middle between consecutive tile centers
+    std::vector<int> xb(1, 0), yb(1, 0);
+    for (size_t i = 1; i < xs.size(); ++i)
+        xb.push_back((xs[i - 1] + xs[i] + tileDim) / 2);
+    for (size_t j = 1; j < ys.size(); ++j)
+        yb.push_back((ys[j - 1] + ys[j] + tileDim) / 2);
+    xb.push_back(frameSize.width);
+    yb.push_back(frameSize.height);
+
+    std::vector<cv::Rect> tiles;
+    cores.clear();
+    cv::Rect frameRect(cv::Point(0, 0), frameSize);
+    for (size_t j = 0; j < ys.size(); ++j)
+        for (size_t i = 0; i < xs.size(); ++i) {
+            tiles.push_back(cv::Rect(xs[i], ys[j], tileDim, tileDim) & frameRect);
+            cores.push_back(cv::Rect(cv::Point(xb[i], yb[j]), cv::Point(xb[i + 1], yb[j + 1])));
+        }
+    return tiles;
+}
+
+/*
+    Detection over overlapping tiles processed in parallel for every model
+
+    Raw candidates (without neighbour grouping) of all tiles are stitched back in frame coordinates and grouped
+    afterward as 'detectMultiScale' does over the whole image, so that faces found on tile overlaps are merged.
+    Only candidates centered in the core of their tile are kept, since the same windows are also found by the
+    neighbouring tile on overlaps and would otherwise count twice toward the minimum neighbours of the grouping.
+    Each thread employs its own copy of the cascades since concurrent 'detectMultiScale' calls are not safe.
+*/
+bool FaceDetectorVJ::detectTiled(vector<vector<Rect>>& bboxes)
+{
+    #if FACE_RECOG_USE_CUDA
+    return false;
+    #else
+    size_t nClassifiers = faceFinder.size();
+    int overlap = std::max(maxSize.width, maxSize.height);
+    int tileDim = std::max(tileSize, 2 * overlap);
+    cv::Size frameSize = frames[0].size();
+    std::vector<cv::Rect> cores;
+    std::vector<cv::Rect> tiles = computeTiles(frameSize, tileDim, overlap, cores);
+    size_t nTiles = tiles.size();
+
+    // single tile covering the whole frame (face size too large compared to frame), no benefit from tiling
+    if (nTiles <= 1) {
+        #pragma omp parallel for
+        for (omp_size_t c = 0; c < nClassifiers; ++c)
+            faceFinder[c].detectMultiScale(frames[c], bboxes[c], scaleFactor, nmsThreshold, CASCADE_SCALE_IMAGE, minSize, maxSize);
+        return true;
+    }
+
+    size_t nThreads = (size_t)omp_get_max_threads();
+    while (tileFinders.size() < nThreads) {
+        std::vector<cv::CascadeClassifier> finders(nClassifiers);
+        for (size_t c = 0; c < nClassifiers; ++c)
+            ASSERT_LOG(finders[c].load(modelPaths[c]), "Failed to load cascade copy for tiled detection [" + modelPaths[c] + "]");
+        tileFinders.push_back(finders);
+    }
+
+    std::vector<std::vector<std::vector<Rect> > > candidates(nClassifiers, std::vector<std::vector<Rect> >(nTiles));
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t job = 0; job < nClassifiers * nTiles; ++job)
+    {
+        size_t c = job / nTiles;
+        size_t t = job % nTiles;
+        std::vector<Rect> found;
+        tileFinders[omp_get_thread_num()][c].detectMultiScale(frames[c](tiles[t]), found, scaleFactor, 0,
+                                                              CASCADE_SCALE_IMAGE, minSize, maxSize);
+        std::vector<Rect>& owned = candidates[c][t];
+        owned.reserve(found.size());
+        for (size_t r = 0; r < found.size(); ++r) {
+            Rect bbox = found[r] + tiles[t].tl();
+            if (cores[t].contains(cv::Point(bbox.x + bbox.width / 2, bbox.y + bbox.height / 2)))
+                owned.push_back(bbox);
+        }
+    }
+
+    for (size_t c = 0; c < nClassifiers; ++c) {
+        bboxes[c].clear();
+        for (size_t t = 0; t < nTiles; ++t)
+            bboxes[c].insert(bboxes[c].end(), candidates[c][t].begin(), candidates[c][t].end());
+        cv::groupRectangles(bboxes[c], nmsThreshold, 0.2);
+    }
+    return true;
+    #endif
+}
+
 void FaceDetectorVJ::flipDetections(size_t index, vector<vector<Rect>>& bboxes)
 {
     for (size_t i = 0; i < bboxes[index].size(); ++i)
@@ -124,7 +245,19 @@ vector<Rect> FaceDetectorVJ::mergeDetections(vector<vector<Rect>>& bboxes)
         for (size_t b = 0; b < nBBox; ++b)
             if (faceFlipModes[b] == HORIZONTAL)
                 flipDetections(b, bboxes);
-    return util::mergeDetections(bboxes, overlapThreshold, frontalOnly);
+    vector<Rect> merged = util::mergeDetections(bboxes, overlapThreshold, frontalOnly);
+
+    // merging keeps detections of the first (frontal) model unchanged, others are profile detections
+    frontalDetections.assign(merged.size(), frontalOnly);
+    if (!frontalOnly)
+        for (size_t m = 0; m < merged.size(); ++m)
+            frontalDetections[m] = std::find(bboxes[0].begin(), bboxes[0].end(), merged[m]) != bboxes[0].end();
+    return merged;
+}
+
+bool FaceDetectorVJ::isFrontalDetection(size_t index)
+{
+    return index >= frontalDetections.size() || frontalDetections[index];
 }
 
 double FaceDetectorVJ::evaluateConfidence(const Track& track, const FACE_RECOG_MAT& image)
@@ -143,7 +276,7 @@ double FaceDetectorVJ::evaluateConfidence(const Track& track, const FACE_RECOG_M
     double score = 0;
     #pragma omp parallel for
     for (omp_size_t f = 0; f < nFaces; ++f) {
-        croppedFaces[f] = imResize(imFlip(image(face).clone(), faceFlipModes[f]), evalSize);
+        croppedFaces[f] = imResize(imFlip(image(face), faceFlipModes[f]), evalSize);
         double tempWeights = 0;
         confidences[f] = faceFinder[f].classify(croppedFaces[f], tempWeights);
     }
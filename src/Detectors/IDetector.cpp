@@ -80,10 +80,28 @@ std::shared_ptr<IDetector> buildSpecializedDetector(const ConfigFile& config, co
             }
             if (config.LBPCascadeFrontalImproved) {
                 std::string modelFilePath = (modelBasePath / bfs::path("lbpcascades/lbpcascade_frontalface_improved.xml")).generic_string();
-                ASSERT_LOG(vj.loadDetector(modelBasePath, NONE), "Load frontal global face detector model [" + modelFilePath + "] failed");
+                ASSERT_LOG(vj.loadDetector(modelFilePath, NONE), "Load frontal global face detector model [" + modelFilePath + "] failed");
             }
+            vj.setTileSize(config.faceTileSize);
             detector = std::static_pointer_cast<IDetector>(std::make_shared<FaceDetectorVJ>(vj));
         }
+        else if (config.DNN) {
+            #ifdef FACE_RECOG_HAS_DNN
+            // network shared by the detectors of all streams to batch their frames together
+            std::string modelPathProto = (modelBasePath / bfs::path(config.dnnModelFile)).generic_string();
+            std::string modelPathWeights = (modelBasePath / bfs::path(config.dnnWeightsFile)).generic_string();
+            ASSERT_LOG(bfs::is_regular_file(modelPathWeights), "DNN face detector model not found [" + modelPathWeights + "]");
+            // OpenCV threads are process-wide, only set when building detectors instead of on each forward pass
+            if (config.dnnThreads > 0)
+                cv::setNumThreads(config.dnnThreads);
+            std::shared_ptr<FaceDetectionNetwork> network = FaceDetectionNetwork::getShared(
+                modelPathProto, modelPathWeights, cv::Size(config.dnnInputSize, config.dnnInputSize), config.dnnBatchSize,
+                config.dnnBatchWait, config.dnnInputScale, config.dnnInputMean, config.dnnSwapRB);
+            detector = std::static_pointer_cast<IDetector>(std::make_shared<FaceDetectorDNN>(
+                network, config.dnnConfidenceThreshold, config.face.minSize, config.face.maxSize,
+                config.faceTileSize, config.face.overlapThreshold));
+            #endif/*FACE_RECOG_HAS_DNN*/
+        }
         else if (config.FRCNN) {
             #ifdef FACE_RECOG_HAS_FRCNN
             detector = std::static_pointer_cast<IDetector>(std::make_shared<FaceDetectorFRCNN>());
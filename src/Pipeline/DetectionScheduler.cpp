@@ -0,0 +1,128 @@
+﻿#include "Pipeline/DetectionScheduler.h"
+#include "FaceRecog.h"
+
+DetectionScheduler::DetectionScheduler(const ConfigFile& config)
+{
+    configure(config);
+    intervalScale = 1;
+    reset();
+}
+
+void DetectionScheduler::configure(const ConfigFile& config)
+{
+    useMotionGating = config.detectionMotionGating;
+    minInterval = config.detectionFrameInterval;
+    maxInterval = std::max(config.detectionMaxFrameInterval, minInterval);
+    fullSweepInterval = std::max(config.detectionFullSweepInterval, minInterval);
+    motionThreshold = config.motionThreshold;
+    motionLearningRate = config.motionLearningRate;
+    motionDownscale = config.motionDownscale;
+    motionFullFrameRatio = config.motionFullFrameRatio;
+    // regions must remain large enough for the detector to find faces at its smallest scale
+    regionMinSize = cv::Size(config.face.minSize.width * 2, config.face.minSize.height * 2);
+}
+
+void DetectionScheduler::reset()
+{
+    frameIndex = 0;
+    framesSinceDetection = 0;
+    framesSinceFullSweep = 0;
+    fullSweep = false;
+    activity = 0;
+    regions.clear();
+    background.release();
+}
+
+bool DetectionScheduler::schedule(const FrameContext& context, bool requireFrequent)
+{
+    regions.clear();
+    fullSweep = false;
+    if (!useMotionGating) {
+        fullSweep = frameIndex++ % (minInterval * intervalScale) == 0;
+        return fullSweep;
+    }
+
+    updateMotion(context);
+    bool firstFrame = frameIndex++ == 0;
+    ++framesSinceDetection;
+    ++framesSinceFullSweep;
+
+    double regionsArea = 0;
+    for (size_t r = 0; r < regions.size(); ++r)
+        regionsArea += regions[r].area();
+    double regionsRatio = regionsArea / (double)context.getSize().area();
+    bool motion = !regions.empty();
+    bool minIntervalReached = framesSinceDetection >= minInterval * intervalScale;
+
+    // full frame when guaranteed sweep is due, when unconfirmed tracks need frequent detections,
+    // after the maximum interval without activity, or when moving regions cover most of the frame
+    fullSweep = firstFrame || framesSinceFullSweep >= fullSweepInterval * intervalScale
+             || (requireFrequent && minIntervalReached)
+             || (!motion && framesSinceDetection >= maxInterval * intervalScale)
+             || (motion && minIntervalReached && regionsRatio >= motionFullFrameRatio);
+    if (!fullSweep && !(motion && minIntervalReached))
+        return false;
+
+    if (fullSweep) {
+        regions.clear();
+        framesSinceFullSweep = 0;
+    }
+    framesSinceDetection = 0;
+    return true;
+}
+
+void DetectionScheduler::updateMotion(const FrameContext& context)
+{
+    cv::GaussianBlur(context.getDownscaled(motionDownscale), smallFrame, cv::Size(5, 5), 0);
+    if (background.empty() || background.size() != smallFrame.size()) {
+        smallFrame.convertTo(background, CV_32F);
+        activity = 0;
+        return;
+    }
+
+    // change mask against running background
+    cv::Mat backgroundU8;
+    background.convertTo(backgroundU8, CV_8U);
+    cv::absdiff(smallFrame, backgroundU8, diffFrame);
+    cv::threshold(diffFrame, motionMask, motionThreshold, 255, cv::THRESH_BINARY);
+    cv::accumulateWeighted(smallFrame, background, motionLearningRate);
+    activity = (double)cv::countNonZero(motionMask) / (double)motionMask.total();
+    if (activity == 0)
+        return;
+
+    // bounding boxes of moving blobs, scaled back to frame coordinates with minimal detectable size
+    cv::dilate(motionMask, motionMask, cv::Mat(), cv::Point(-1, -1), 2);
+    std::vector<std::vector<cv::Point> > contours;
+    cv::findContours(motionMask, contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
+    cv::Rect frameRect(cv::Point(0, 0), context.getSize());
+    double scale = 1.0 / motionDownscale;
+    std::vector<cv::Rect> blobs;
+    for (size_t c = 0; c < contours.size(); ++c)
+    {
+        cv::Rect r = cv::boundingRect(contours[c]);
+        cv::Rect blob((int)(r.x * scale), (int)(r.y * scale), (int)(r.width * scale), (int)(r.height * scale));
+        int padW = std::max(regionMinSize.width - blob.width, 0) / 2 + regionMinSize.width / 2;
+        int padH = std::max(regionMinSize.height - blob.height, 0) / 2 + regionMinSize.height / 2;
+        blob = cv::Rect(blob.x - padW, blob.y - padH, blob.width + 2 * padW, blob.height + 2 * padH) & frameRect;
+        if (blob.area() > 0)
+            blobs.push_back(blob);
+    }
+
+    // merge overlapping regions to avoid detecting the same faces multiple times
+    bool merged = true;
+    while (merged)
+    {
+        merged = false;
+        for (size_t i = 0; i < blobs.size() && !merged; ++i) {
+            for (size_t j = i + 1; j < blobs.size(); ++j) {
+                if ((blobs[i] & blobs[j]).area() > 0) {
+                    blobs[i] |= blobs[j];
+                    blobs.erase(blobs.begin() + j);
+                    merged = true;
+                    break;
+                }
+            }
+        }
+    }
+    regions = blobs;
+}
@@ -0,0 +1,93 @@
+﻿#include "Pipeline/FrameContext.h"
+#include "FaceRecog.h"
+
+FrameContext::FrameContext(const FACE_RECOG_MAT& frame) :
+    frame(frame) { }
+
+const FACE_RECOG_MAT& FrameContext::getGray() const
+{
+    std::call_once(grayOnce, [this]() {
+        if (frame.channels() == 3)
+            FACE_RECOG_NAMESPACE::cvtColor(frame, gray, CV_BGR2GRAY);
+        else
+            gray = frame;
+    });
+    return gray;
+}
+
+const cv::Mat& FrameContext::getGrayMat() const
+{
+    std::call_once(grayMatOnce, [this]() { grayMat = GET_MAT(getGray(), ACCESS_READ); });
+    return grayMat;
+}
+
+const FACE_RECOG_MAT& FrameContext::getFlipped(FlipMode flipMode) const
+{
+    if (flipMode == NONE)
+        return getGray();
+    const FACE_RECOG_MAT& source = getGray();
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    auto it = flipped.find((int)flipMode);
+    if (it == flipped.end())
+        it = flipped.insert(std::make_pair((int)flipMode, imFlip(source, flipMode))).first;
+    return it->second;  // map nodes are never moved by later insertions
+}
+
+const cv::Mat& FrameContext::getIntegral() const
+{
+    std::call_once(integralOnce, [this]() { cv::integral(getGrayMat(), integral, CV_32S); });
+    return integral;
+}
+
+const cv::Mat& FrameContext::getSquaredIntegral() const
+{
+    std::call_once(squaredIntegralOnce, [this]() {
+        // plain integral obtained by the same pass is kept unless already computed
+        cv::Mat sum;
+        cv::integral(getGrayMat(), sum, squaredIntegral, CV_32S, CV_64F);
+        std::call_once(integralOnce, [this, &sum]() { integral = sum; });
+    });
+    return squaredIntegral;
+}
+
+const cv::Mat& FrameContext::getHSV() const
+{
+    std::call_once(hsvOnce, [this]() {
+        if (frame.channels() == 3)
+            cv::cvtColor(GET_MAT(frame, ACCESS_READ), hsv, CV_BGR2HSV);
+        else
+            hsv = cv::Mat(frame.size(), CV_8UC3, cv::Scalar::all(0));
+    });
+    return hsv;
+}
+
+const cv::Mat& FrameContext::getTrackerGray() const
+{
+    if (frame.channels() != 3)
+        return getGrayMat();
+    std::call_once(trackerGrayOnce, [this]() { cv::cvtColor(GET_MAT(frame, ACCESS_READ), trackerGray, CV_RGB2GRAY); });
+    return trackerGray;
+}
+
+const cv::Mat& FrameContext::getTrackerIntegral() const
+{
+    if (frame.channels() != 3)
+        return getIntegral();
+    std::call_once(trackerIntegralOnce, [this]() { cv::integral(getTrackerGray(), trackerIntegral, CV_32S); });
+    return trackerIntegral;
+}
+
+const cv::Mat& FrameContext::getDownscaled(double scale) const
+{
+    if (scale == 1)
+        return getGrayMat();
+    const cv::Mat& source = getGrayMat();
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    auto it = downscaled.find(scale);
+    if (it == downscaled.end()) {
+        cv::Mat small;
+        cv::resize(source, small, cv::Size(), scale, scale, cv::INTER_AREA);
+        it = downscaled.insert(std::make_pair(scale, small)).first;
+    }
+    return it->second;
+}
@@ -0,0 +1,89 @@
+﻿#include "Pipeline/FrameSequenceReader.h"
+#include "FaceRecog.h"
+
+FrameSequenceReader::FrameSequenceReader(size_t threadCount, size_t readAhead, int reduction)
+    : nThreads(std::max<size_t>(threadCount, 1))
+    , slots(std::max<size_t>(readAhead, 1))
+    , nextDecode(0)
+    , nextRead(0)
+    , stopping(false)
+{
+    readFlags = reduction == 8 ? cv::IMREAD_REDUCED_COLOR_8
+              : reduction == 4 ? cv::IMREAD_REDUCED_COLOR_4
+              : reduction == 2 ? cv::IMREAD_REDUCED_COLOR_2
+              : cv::IMREAD_COLOR;
+}
+
+FrameSequenceReader::~FrameSequenceReader()
+{
+    close();
+}
+
+void FrameSequenceReader::open(const std::vector<std::string>& filePaths)
+{
+    close();
+    paths = filePaths;
+    nextDecode = 0;
+    nextRead = 0;
+    stopping = false;
+    for (size_t s = 0; s < slots.size(); ++s) {
+        slots[s].image.release();
+        slots[s].ready = false;
+    }
+    for (size_t t = 0; t < std::min(nThreads, paths.size()); ++t)
+        decoders.push_back(std::thread(&FrameSequenceReader::decode, this));
+}
+
+void FrameSequenceReader::close()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    slotAvailable.notify_all();
+    frameReady.notify_all();
+    for (size_t t = 0; t < decoders.size(); ++t)
+        decoders[t].join();
+    decoders.clear();
+}
+
+void FrameSequenceReader::decode()
+{
+    size_t capacity = slots.size();
+    for (;;)
+    {
+        size_t index;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            slotAvailable.wait(lock, [this, capacity] { return stopping || nextDecode >= paths.size() || nextDecode < nextRead + capacity; });
+            if (stopping || nextDecode >= paths.size())
+                return;
+            index = nextDecode++;
+        }
+
+        cv::Mat image = cv::imread(paths[index], readFlags);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        Slot& slot = slots[index % capacity];
+        slot.image = image;
+        slot.ready = true;
+        frameReady.notify_all();
+    }
+}
+
+bool FrameSequenceReader::read(cv::Mat& frame)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    if (nextRead >= paths.size())
+        return false;
+    Slot& slot = slots[nextRead % slots.size()];
+    frameReady.wait(lock, [this, &slot] { return slot.ready || stopping; });
+    if (!slot.ready)
+        return false;
+    frame = slot.image;
+    slot.image.release();
+    slot.ready = false;
+    ++nextRead;
+    slotAvailable.notify_all();
+    return !frame.empty();
+}
@@ -0,0 +1,67 @@
+﻿#include "Pipeline/LoadSheddingScheduler.h"
+#include "FaceRecog.h"
+
+// weight of the last frame in the smoothed processing time
+static const double averageRate = 0.2;
+
+LoadSheddingScheduler::LoadSheddingScheduler(const ConfigFile& config)
+{
+    configure(config);
+    reset();
+}
+
+void LoadSheddingScheduler::configure(const ConfigFile& config)
+{
+    budget = config.loadSheddingBudget;
+    recoverRatio = config.loadSheddingRecoverRatio;
+    holdFrames = config.loadSheddingHoldFrames;
+    if (!isEnabled())
+        level = NONE;
+}
+
+void LoadSheddingScheduler::reset()
+{
+    level = NONE;
+    framesSinceChange = 0;
+    averageTime = 0;
+    levelFrames.fill(0);
+    escalations = 0;
+    recoveries = 0;
+}
+
+bool LoadSheddingScheduler::update(double frameTime)
+{
+    if (!isEnabled())
+        return false;
+
+    averageTime = averageTime > 0 ? averageRate * frameTime + (1 - averageRate) * averageTime : frameTime;
+    ++levelFrames[level];
+    if (++framesSinceChange < holdFrames)
+        return false;
+
+    if (averageTime > budget && level < LEVEL_COUNT - 1) {
+        ++level;
+        ++escalations;
+    }
+    else if (averageTime < budget * recoverRatio && level > NONE) {
+        --level;
+        ++recoveries;
+    }
+    else return false;
+    framesSinceChange = 0;
+    return true;
+}
+
+std::string LoadSheddingScheduler::levelName(int level)
+{
+    switch (level)
+    {
+        case NONE:                  return "NONE";
+        case SKIP_OUTPUTS:          return "SKIP_OUTPUTS";
+        case STALE_LOCAL_SEARCH:    return "STALE_LOCAL_SEARCH";
+        case SKIP_EYES:             return "SKIP_EYES";
+        case THROTTLE_RECOGNITION:  return "THROTTLE_RECOGNITION";
+        case REDUCE_DETECTION:      return "REDUCE_DETECTION";
+        default:                    return "UNDEFINED";
+    }
+}
@@ -0,0 +1,166 @@
+﻿#include "Pipeline/OutputWriter.h"
+#include "FaceRecog.h"
+
+OutputWriter::OutputWriter(const ConfigFile& config)
+    : capacity((size_t)config.outputQueueSize)
+    , videoFPS(config.outputVideoFPS)
+    , activeWrites(0)
+    , stopping(false)
+    , dropped(0)
+    , written(0)
+{
+    for (int t = 0; t < config.outputWriterThreads; ++t)
+        imageThreads.push_back(std::thread(&OutputWriter::writeImages, this));
+    if (config.outputWriterThreads > 0)
+        videoThread = std::thread(&OutputWriter::writeVideos, this);
+}
+
+OutputWriter::~OutputWriter()
+{
+    flush();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    outputAvailable.notify_all();
+    for (size_t t = 0; t < imageThreads.size(); ++t)
+        imageThreads[t].join();
+    if (videoThread.joinable())
+        videoThread.join();
+    for (auto it = videoWriters.begin(); it != videoWriters.end(); ++it)
+        it->second.release();
+}
+
+bool OutputWriter::writeImage(const std::string& filePath, const cv::Mat& image)
+{
+    if (imageThreads.empty()) {
+        ensureDirectory(bfs::path(filePath).parent_path().string());
+        cv::imwrite(filePath, image);
+        ++written;
+        return true;
+    }
+    return submit(imageQueue, filePath, image);
+}
+
+bool OutputWriter::writeTrackROI(const cv::Mat& roi, const std::string& label, int trackNumber, const std::string& dirPath)
+{
+    return writeImage(dirPath + "/person_" + std::to_string(trackNumber) + "/" + label + ".png", roi);
+}
+
+bool OutputWriter::writeVideoFrame(const std::string& videoPath, const cv::Mat& frame)
+{
+    if (!videoThread.joinable()) {
+        appendVideoFrame(Output{ videoPath, frame });
+        return true;
+    }
+    return submit(videoQueue, videoPath, frame);
+}
+
+bool OutputWriter::submit(std::deque<Output>& queue, const std::string& path, const cv::Mat& image)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (queue.size() >= capacity) {
+            ++dropped;
+            return false;
+        }
+    }
+    // copy outside the lock, caller buffers are reused for the next frames
+    Output output{ path, image.clone() };
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        queue.push_back(std::move(output));
+    }
+    outputAvailable.notify_all();
+    return true;
+}
+
+void OutputWriter::flush()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    outputsWritten.wait(lock, [this] { return imageQueue.empty() && videoQueue.empty() && activeWrites == 0; });
+}
+
+void OutputWriter::writeImages()
+{
+    for (;;)
+    {
+        Output output;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            outputAvailable.wait(lock, [this] { return stopping || !imageQueue.empty(); });
+            if (imageQueue.empty())
+                return;
+            output = std::move(imageQueue.front());
+            imageQueue.pop_front();
+            ++activeWrites;
+        }
+        ensureDirectory(bfs::path(output.path).parent_path().string());
+        cv::imwrite(output.path, output.image);
+        ++written;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            --activeWrites;
+        }
+        outputsWritten.notify_all();
+    }
+}
+
+void OutputWriter::writeVideos()
+{
+    for (;;)
+    {
+        Output output;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            outputAvailable.wait(lock, [this] { return stopping || !videoQueue.empty(); });
+            if (videoQueue.empty())
+                return;
+            output = std::move(videoQueue.front());
+            videoQueue.pop_front();
+            ++activeWrites;
+        }
+        appendVideoFrame(output);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            --activeWrites;
+        }
+        outputsWritten.notify_all();
+    }
+}
+
+void OutputWriter::appendVideoFrame(const Output& output)
+{
+    cv::VideoWriter& writer = videoWriters[output.path];
+    if (!writer.isOpened()) {
+        ensureDirectory(bfs::path(output.path).parent_path().string());
+        writer.open(output.path, cv::VideoWriter::fourcc('M', 'J', 'P', 'G'), videoFPS, output.image.size(), output.image.channels() == 3);
+        if (!writer.isOpened()) {
+            ASSERT_WARN(false, "Failed to open output video [" + output.path + "]");
+            ++dropped;
+            return;
+        }
+        videoSizes[output.path] = output.image.size();
+    }
+    // video frame size is fixed by the first frame
+    const cv::Size& size = videoSizes[output.path];
+    if (output.image.size() != size) {
+        cv::Mat resized;
+        cv::resize(output.image, resized, size, 0, 0, cv::INTER_AREA);
+        writer.write(resized);
+    }
+    else
+        writer.write(output.image);
+    ++written;
+}
+
+void OutputWriter::ensureDirectory(const std::string& dirPath)
+{
+    if (dirPath.empty())
+        return;
+    std::lock_guard<std::mutex> lock(directoryMutex);
+    if (directories.count(dirPath))
+        return;
+    bfs::create_directories(dirPath);
+    directories.insert(dirPath);
+}
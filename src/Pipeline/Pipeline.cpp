@@ -0,0 +1,62 @@
+﻿#include "Pipeline/Pipeline.h"
+#include "FaceRecog.h"
+
+template <class Detector, class Tracker, class Classifier>
+int Pipeline<Detector, Tracker, Classifier>::detectMerge(IDetector& detector, std::vector<cv::Rect>& bboxes)
+{
+    assert(dynamic_cast<Detector*>(&detector));
+    Detector& specialized = static_cast<Detector&>(detector);
+    std::vector<std::vector<cv::Rect> > multiBBoxes;
+    if (!specialized.detect(multiBBoxes))
+        return -1;
+    bboxes = specialized.mergeDetections(multiBBoxes);
+    return (int)(bboxes.size());
+}
+
+template <class Detector, class Tracker, class Classifier>
+void Pipeline<Detector, Tracker, Classifier>::trackFaces(std::vector<Track>& tracks, const ImageRep& image)
+{
+    #pragma omp parallel for
+    for (omp_size_t i = 0; i < tracks.size(); ++i) {
+        tracks[i].trackWith<Tracker>(image);
+        tracks[i].markNotMatched();   // no match with detection
+    }
+}
+
+template <class Detector, class Tracker, class Classifier>
+std::vector<std::vector<double> > Pipeline<Detector, Tracker, Classifier>::predictBatch(const IClassifier& classifier,
+                                                                                              const std::vector<FACE_RECOG_MAT>& rois)
+{
+    assert(dynamic_cast<const Classifier*>(&classifier));
+    return static_cast<const Classifier&>(classifier).predictBatch(rois);
+}
+
+// explicit instantiations of common combinations
+template class Pipeline<IDetector, ITracker, IClassifier>;
+#if defined(FACE_RECOG_HAS_VJ) && defined(FACE_RECOG_HAS_STRUCK)
+    #ifdef FACE_RECOG_HAS_TM
+    template class Pipeline<FaceDetectorVJ, TrackerSTRUCK, ClassifierEnsembleTM>;
+    #endif/*FACE_RECOG_HAS_TM*/
+    #ifdef FACE_RECOG_HAS_ESVM
+    template class Pipeline<FaceDetectorVJ, TrackerSTRUCK, ClassifierEnsembleESVM>;
+    #endif/*FACE_RECOG_HAS_ESVM*/
+#endif
+
+std::shared_ptr<IPipeline> buildPipeline(const ConfigFile& config, const IClassifier* classifier)
+{
+    // global face detector and trackers are built from the same config options
+    #if defined(FACE_RECOG_HAS_VJ) && defined(FACE_RECOG_HAS_STRUCK)
+    if (config.requireAnyCascade() && config.STRUCK)
+    {
+        #ifdef FACE_RECOG_HAS_TM
+        if (!classifier || dynamic_cast<const ClassifierEnsembleTM*>(classifier))
+            return std::make_shared<Pipeline<FaceDetectorVJ, TrackerSTRUCK, ClassifierEnsembleTM> >();
+        #endif/*FACE_RECOG_HAS_TM*/
+        #ifdef FACE_RECOG_HAS_ESVM
+        if (!classifier || dynamic_cast<const ClassifierEnsembleESVM*>(classifier))
+            return std::make_shared<Pipeline<FaceDetectorVJ, TrackerSTRUCK, ClassifierEnsembleESVM> >();
+        #endif/*FACE_RECOG_HAS_ESVM*/
+    }
+    #endif
+    return std::make_shared<Pipeline<IDetector, ITracker, IClassifier> >();
+}
@@ -0,0 +1,51 @@
+﻿#include "Pipeline/ProbeExtractor.h"
+#include "FaceRecog.h"
+
+ProbeExtractor::ProbeExtractor(cv::Size size)
+    : probeCount(0)
+{
+    setProbeSize(size);
+}
+
+void ProbeExtractor::setProbeSize(cv::Size size)
+{
+    if (size == probeSize)
+        return;
+    probeSize = size;
+    batch.release();
+    probes.clear();
+    probeCount = 0;
+}
+
+size_t ProbeExtractor::extract(const FACE_RECOG_MAT& frameGray, const std::vector<cv::Rect>& rois)
+{
+    ASSERT_LOG(isEnabled(), "Probe size must be specified before extraction");
+    probeCount = rois.size();
+    if (probeCount == 0)
+        return 0;
+
+    // grow buffer only if required, probe headers refer to its rows
+    if ((size_t)batch.rows < probeCount) {
+        batch.create((int)probeCount, probeSize.area(), CV_8UC1);
+        probes = std::vector<cv::Mat>(probeCount);
+        for (size_t i = 0; i < probeCount; ++i)
+            probes[i] = batch.row((int)i).reshape(1, probeSize.height);
+    }
+
+    cv::Mat gray = GET_MAT(frameGray, ACCESS_READ);
+    cv::Rect frameRect(0, 0, gray.cols, gray.rows);
+    for (size_t i = 0; i < probeCount; ++i)
+    {
+        const cv::Rect& roi = rois[i];
+        if ((roi & frameRect) == roi)
+            cv::resize(gray(roi), probes[i], probeSize, 0, 0, cv::INTER_AREA);
+        else {
+            // crop and scale in a single pass, missing pixels replicated from frame borders
+            double sx = probeSize.width / (double)roi.width;
+            double sy = probeSize.height / (double)roi.height;
+            cv::Mat transform = (cv::Mat_<double>(2, 3) << sx, 0, -roi.x * sx, 0, sy, -roi.y * sy);
+            cv::warpAffine(gray, probes[i], transform, probeSize, cv::INTER_LINEAR, cv::BORDER_REPLICATE);
+        }
+    }
+    return probeCount;
+}
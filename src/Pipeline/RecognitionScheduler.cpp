@@ -0,0 +1,127 @@
+﻿#include "Pipeline/RecognitionScheduler.h"
+#include "FaceRecog.h"
+
+// laplacian variance of crops considered as half sharp (normalized crop size)
+#define SHARPNESS_REFERENCE 100.0
+// weight of new crops in running track quality
+#define QUALITY_UPDATE_RATE 0.2
+
+RecognitionScheduler::RecognitionScheduler(const ConfigFile& config)
+{
+    configure(config);
+    reset();
+}
+
+void RecognitionScheduler::configure(const ConfigFile& config)
+{
+    useScheduling = config.recognitionScheduling;
+    useEyesDetection = config.useEyesDetection;
+    minQuality = config.recognitionMinQuality;
+    windowSize = config.recognitionWindowSize;
+    probesPerWindow = config.recognitionProbesPerWindow;
+    frameBudget = config.recognitionFrameBudget;
+    stableDelta = config.recognitionStableDelta;
+    stableInterval = config.recognitionStableInterval;
+    qualitySize = config.face.confidenceSize;
+    minFaceWidth = config.face.minSize.width;
+}
+
+void RecognitionScheduler::reset()
+{
+    frameIndex = 0;
+    states.clear();
+}
+
+std::vector<size_t> RecognitionScheduler::schedule(std::vector<Track>& tracks, const std::vector<size_t>& candidates,
+                                                   const FACE_RECOG_MAT& frameGray)
+{
+    size_t currentFrame = frameIndex++;
+    if (!useScheduling)
+        return candidates;
+
+    // drop states of removed tracks
+    for (std::map<int, TrackState>::iterator it = states.begin(); it != states.end();) {
+        bool found = false;
+        for (size_t i = 0; i < tracks.size() && !found; ++i)
+            found = tracks[i].getTrackNumber() == it->first;
+        it = found ? std::next(it) : states.erase(it);
+    }
+
+    std::vector<std::pair<double, size_t> > eligible;   // (priority, track index)
+    for (size_t c = 0; c < candidates.size(); ++c)
+    {
+        Track& track = tracks[candidates[c]];
+        TrackState& state = states[track.getTrackNumber()];
+        if (currentFrame - state.windowStart >= (size_t)windowSize) {
+            state.windowStart = currentFrame;
+            state.windowProbes = 0;
+        }
+
+        double quality = probeQuality(track, frameGray);
+        double runningQuality = state.quality < 0 ? quality : state.quality;
+        state.quality = runningQuality + QUALITY_UPDATE_RATE * (quality - runningQuality);
+
+        // stable recognized tracks only need periodic confirmation
+        bool stable = track.isRecognized() && state.stableCount >= probesPerWindow;
+        if (stable && currentFrame - state.lastProbe < (size_t)stableInterval)
+            continue;
+
+        // keep window slots for better crops, unless remaining frames are required to fill them
+        int remainingFrames = windowSize - (int)(currentFrame - state.windowStart);
+        int remainingProbes = probesPerWindow - state.windowProbes;
+        if (quality < minQuality || remainingProbes <= 0)
+            continue;
+        if (quality < runningQuality && remainingFrames > remainingProbes)
+            continue;
+
+        // unresolved identities are prioritized over already recognized ones
+        eligible.push_back(std::make_pair(quality + (track.isRecognized() ? 0.0 : 1.0), candidates[c]));
+    }
+
+    if (frameBudget > 0 && eligible.size() > (size_t)frameBudget) {
+        std::partial_sort(eligible.begin(), eligible.begin() + frameBudget, eligible.end(),
+                          std::greater<std::pair<double, size_t> >());
+        eligible.resize(frameBudget);
+    }
+
+    std::vector<size_t> selected(eligible.size());
+    for (size_t e = 0; e < eligible.size(); ++e) {
+        selected[e] = eligible[e].second;
+        TrackState& state = states[tracks[selected[e]].getTrackNumber()];
+        state.windowProbes++;
+        state.lastProbe = currentFrame;
+    }
+    std::sort(selected.begin(), selected.end());
+    return selected;
+}
+
+void RecognitionScheduler::update(int trackNumber, double accumulatedScore)
+{
+    if (!useScheduling)
+        return;
+    TrackState& state = states[trackNumber];
+    state.stableCount = std::abs(accumulatedScore - state.lastScore) <= stableDelta ? state.stableCount + 1 : 0;
+    state.lastScore = accumulatedScore;
+}
+
+double RecognitionScheduler::probeQuality(Track& track, const FACE_RECOG_MAT& frameGray)
+{
+    cv::Rect bbox = track.bbox() & cv::Rect(0, 0, frameGray.cols, frameGray.rows);
+    if (bbox.area() == 0)
+        return 0;
+
+    // sharpness from laplacian variance of the normalized crop, mapped to [0,1[
+    cv::Mat gray = GET_MAT(frameGray, ACCESS_READ);
+    cv::resize(gray(bbox), crop, qualitySize, 0, 0, cv::INTER_AREA);
+    cv::Laplacian(crop, laplacian, CV_32F);
+    cv::Scalar mean, stddev;
+    cv::meanStdDev(laplacian, mean, stddev);
+    double variance = stddev[0] * stddev[0];
+    double sharpness = variance / (variance + SHARPNESS_REFERENCE);
+
+    // crops close to the minimal detection size hold less facial details
+    double size = std::min(1.0, bbox.width / (2.0 * minFaceWidth));
+    double eyes = (!useEyesDetection || track.isValidatedEyeDetection()) ? 1.0 : 0.5;
+    double pose = track.isFrontalDetection() ? 1.0 : 0.5;
+    return sharpness * size * eyes * pose;
+}
@@ -0,0 +1,102 @@
+﻿#include "Pipeline/SequenceEvaluator.h"
+#include "FaceRecog.h"
+
+SequenceEvaluator::SequenceEvaluator(const ConfigFile* config, const SharedModels& sharedModels, const std::string& modelBasePath)
+    : conf(config)
+    , models(sharedModels)
+{
+    ASSERT_LOG(conf, "ConfigFile reference invalid");
+    pool.reset(new ThreadPool(conf->testSequenceWorkers, conf->multiStreamOmpThreads));
+
+    // detectors memorize assigned images and their cascades cannot run concurrently, one set per worker
+    for (size_t w = 0; w < pool->workerCount(); ++w)
+        detectorSets.push_back(buildDetectorSet(*conf, modelBasePath));
+}
+
+void SequenceEvaluator::addSequence(const std::string& regexPath, const std::vector<std::string>& frameNames,
+                                    const std::string& resultFilePath)
+{
+    Sequence sequence;
+    sequence.sequenceID = bfs::path(regexPath).remove_filename().filename().string();
+    sequence.regexPath = regexPath;
+    sequence.frameNames = frameNames;
+    sequence.resultFilePath = resultFilePath;
+    sequences.push_back(sequence);
+}
+
+void SequenceEvaluator::run(logstream& logResult)
+{
+    // longest sequences first to avoid a single long one finishing alone at the end
+    std::vector<size_t> order(sequences.size());
+    for (size_t s = 0; s < order.size(); ++s)
+        order[s] = s;
+    std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+        return sequences[a].frameNames.size() > sequences[b].frameNames.size();
+    });
+    for (size_t s = 0; s < order.size(); ++s) {
+        size_t index = order[s];
+        pool->submit([this, index] { process(index); });
+    }
+    pool->wait();
+    mergeResults(logResult);
+}
+
+void SequenceEvaluator::process(size_t sequenceIndex)
+{
+    Sequence& sequence = sequences[sequenceIndex];
+    int worker = pool->currentWorkerIndex();
+    ASSERT_LOG(worker >= 0, "Sequence processing must be executed by a pool worker");
+
+    StreamSource source(*conf);
+    if (!source.open(sequence.regexPath, sequence.frameNames)) {
+        ASSERT_WARN(false, "Failed to open test sequence [" + sequence.regexPath + "]");
+        return;
+    }
+    StreamProcessor processor(conf, models);
+    logstream logSequence(sequence.resultFilePath, false, true);
+    StreamProcessor::writeResultsHeader(logSequence, models.targetIDs.size());
+
+    FACE_RECOG_MAT frame;
+    while (sequence.frameCounter < sequence.frameNames.size() && source.read(frame))
+    {
+        processor.process(frame, detectorSets[worker]);
+        processor.writeResults(logSequence, sequence.sequenceID, sequenceIndex, sequence.frameNames[sequence.frameCounter]);
+        ++sequence.frameCounter;
+    }
+    sequence.trackNumberCount = processor.getTrackNumberCount();
+}
+
+// TRACK_NUMBER fields of a result line offset, each of the TRACK_COUNT tracks has the same field count after the frame fields
+static std::string offsetTrackNumbers(const std::string& line, int offset)
+{
+    const size_t frameFields = 5;
+    std::vector<std::string> fields;
+    boost::split(fields, line, boost::is_any_of(","));
+    size_t trackCount = fields.size() > frameFields ? std::stoul(fields[3]) : 0;
+    if (trackCount == 0 || offset == 0)
+        return line;
+    size_t trackFields = (fields.size() - frameFields) / trackCount;
+    for (size_t t = 0; t < trackCount; ++t) {
+        std::string& trackNumber = fields[frameFields + t * trackFields];
+        trackNumber = std::to_string(std::stoi(trackNumber) + offset);
+    }
+    return boost::join(fields, ",");
+}
+
+void SequenceEvaluator::mergeResults(logstream& logResult)
+{
+    StreamProcessor::writeResultsHeader(logResult, models.targetIDs.size());
+    int trackNumberOffset = 0;
+    for (size_t s = 0; s < sequences.size(); ++s)
+    {
+        // missing sequence results would leave the merged results silently incomplete
+        std::ifstream sequenceFile(sequences[s].resultFilePath);
+        ASSERT_LOG(sequenceFile.is_open(), "Failed to open results of sequence '" + sequences[s].sequenceID +
+                                           "' [" + sequences[s].resultFilePath + "], merged results incomplete");
+        std::string line;
+        std::getline(sequenceFile, line);   // skip header
+        while (std::getline(sequenceFile, line))
+            logResult << offsetTrackNumbers(line, trackNumberOffset) << std::endl;
+        trackNumberOffset += sequences[s].trackNumberCount;
+    }
+}
@@ -0,0 +1,605 @@
+﻿#include "Pipeline/StreamProcessor.h"
+#include "FaceRecog.h"
+
+// debug output employed only when a debug log is attached to the stream
+#define STREAM_DEBUG(x) FACE_RECOG_DEBUG(if (logDebug) { *logDebug << x; })
+
+DetectorSet buildDetectorSet(const ConfigFile& config, const std::string& modelBasePath)
+{
+    DetectorSet detectors;
+    detectors.face = buildSpecializedDetector(config, modelBasePath, DetectorType::FACE_DETECTOR_GLOBAL);
+    ASSERT_LOG(detectors.face, "Global face detector not properly initialized");
+    detectors.localFace = buildSpecializedDetector(config, modelBasePath, DetectorType::FACE_DETECTOR_LOCAL);
+    detectors.eyes = buildSpecializedDetector(config, modelBasePath, DetectorType::EYE_DETECTOR);
+    return detectors;
+}
+
+StreamProcessor::StreamProcessor(const ConfigFile* config, const SharedModels& sharedModels)
+    : conf(config)
+    , confSnapshot(config, [](const ConfigFile*) {})    // startup configuration owned by the caller
+    , models(sharedModels)
+    , accScores(config->roiAccumulationSize)
+    , association(confSnapshot)
+    , detectionScheduler(*config)
+    , recognitionScheduler(*config)
+    , loadShedding(*config)
+    , probeExtractor(sharedModels.classifier ? sharedModels.classifier->getProbeSize() : cv::Size())
+    , roiExtractor(cv::Size(config->roiOutputSize, config->roiOutputSize))
+    , logDebug(nullptr)
+    , outputWriter(nullptr)
+    , pipeline(buildPipeline(*config, sharedModels.classifier.get()))
+{
+    ASSERT_LOG(conf, "ConfigFile reference invalid");
+    ASSERT_LOG(!conf->useFaceRecognition || models.classifier, "Classifier required for face recognition");
+    currentTracks.reserve(25);
+    trackNumber = 0;
+    minScores = std::vector<double>(models.targetIDs.size(),  DBL_MAX);
+    maxScores = std::vector<double>(models.targetIDs.size(), -DBL_MAX);
+    reset();
+}
+
+void StreamProcessor::reset()
+{
+    frameIndex = 0;
+    isNewDetection = false;
+    outputTime = 0;
+    currentTracks.clear();
+    initCandidates.clear();
+    newCandidates.clear();
+    mergedDet.clear();
+    mergedDetFrontal.clear();
+    notMatchedDets.clear();
+    accScores = CircularBuffer(conf->roiAccumulationSize);
+    detectionScheduler.reset();
+    recognitionScheduler.reset();
+}
+
+void StreamProcessor::updateConfig(const ConfigSnapshot& config)
+{
+    // existing tracks keep the snapshot they were created with, new tracks employ the updated one
+    ASSERT_LOG(config, "ConfigFile reference invalid");
+    confSnapshot = config;
+    conf = config.get();
+    association.configure(confSnapshot);
+    detectionScheduler.configure(*conf);
+    recognitionScheduler.configure(*conf);
+    loadShedding.configure(*conf);
+}
+
+void StreamProcessor::process(const FACE_RECOG_MAT& inputFrame, DetectorSet& detectors)
+{
+    TP frameTime = getTimeNowPrecise();
+    detectionScheduler.setIntervalScale(loadShedding.isShedding(LoadSheddingScheduler::REDUCE_DETECTION) ? 2 : 1);
+
+    // image representations computed once on demand and shared by all frame consumers
+    FrameContext context(inputFrame);
+    frame = inputFrame;
+    frameGray = context.getGray();
+
+    // unconfirmed candidates and tracks losing confidence require detections at the shortest interval
+    bool requireFrequent = !initCandidates.empty();
+    for (size_t i = 0; i < currentTracks.size() && !requireFrequent; ++i)
+        requireFrequent = currentTracks[i].getRemoveCount() > 0;
+    isNewDetection = detectionScheduler.schedule(context, requireFrequent);
+    if (isNewDetection)
+        detectFaces(context, detectors);
+
+    // internal image representation for trackers
+    ImageRep image(context);
+    trackFaces(image);
+    if (isNewDetection) {
+        matchDetections(image, detectors);
+        createTracks(image, detectors);
+    }
+    util::mergeOverlappingTracks(currentTracks, conf->trackerOverlapThreshold, frameGray);
+
+    if (conf->useLocalSearchROI && detectors.localFace)
+        searchLocalROI(image, detectors);
+    if (conf->useEyesDetection && detectors.eyes && currentTracks.size() > 0
+        && !loadShedding.isShedding(LoadSheddingScheduler::SKIP_EYES))
+        detectEyes(detectors);
+    if (conf->useFaceRecognition
+        && !(loadShedding.isShedding(LoadSheddingScheduler::THROTTLE_RECOGNITION) && frameIndex % 2))
+        recognizeFaces();
+
+    if (loadShedding.getLevel() > LoadSheddingScheduler::NONE)
+        ++stats.totalFramesShed;
+    if (loadShedding.update(getDeltaTimePrecise(frameTime, MILLISECONDS) + outputTime))
+        STREAM_DEBUG("Load shedding level: " << LoadSheddingScheduler::levelName(loadShedding.getLevel())
+                     << " (average frame time: " << loadShedding.getAverageTime() << " ms)" << std::endl);
+    outputTime = 0;
+
+    ++frameIndex;
+    ++stats.totalFrames;
+}
+
+void StreamProcessor::detectFaces(const FrameContext& context, DetectorSet& detectors)
+{
+    FACE_RECOG_DEBUG(TP frameTime = getTimeNowPrecise());
+
+    if (detectionScheduler.isFullSweep())
+    {
+        detectors.face->assignImage(context);
+        pipeline->detectMerge(*detectors.face, mergedDet);
+        mergedDetFrontal.resize(mergedDet.size());
+        for (size_t d = 0; d < mergedDet.size(); ++d)
+            mergedDetFrontal[d] = detectors.face->isFrontalDetection(d);
+    }
+    else
+    {
+        // detect only within moving regions, positions offset back to frame coordinates
+        mergedDet.clear();
+        mergedDetFrontal.clear();
+        const std::vector<cv::Rect>& regions = detectionScheduler.getRegions();
+        for (size_t r = 0; r < regions.size(); ++r)
+        {
+            std::vector<cv::Rect> regionDet;
+            detectors.face->assignImage(FACE_RECOG_MAT(frameGray, regions[r]));
+            pipeline->detectMerge(*detectors.face, regionDet);
+            for (size_t d = 0; d < regionDet.size(); ++d) {
+                mergedDet.push_back(regionDet[d] + regions[r].tl());
+                mergedDetFrontal.push_back(detectors.face->isFrontalDetection(d));
+            }
+        }
+        ++stats.totalFramesDetectRegions;
+        STREAM_DEBUG("Motion regions: " << regions.size() << ", activity: " << detectionScheduler.getActivity() << std::endl);
+    }
+
+    FACE_RECOG_DEBUG(
+        double deltaTime = getDeltaTimePrecise(frameTime, MILLISECONDS);
+        stats.sumTimeDetect += deltaTime;
+    );
+    STREAM_DEBUG(setprecision(3) << "detection time: " << deltaTime << " ms" << std::endl);
+
+    // reinit candidates
+    for (size_t i = 0; i < initCandidates.size(); ++i)
+        initCandidates[i].markNotMatched();
+
+    // augment detections with offset, limited by frame boundaries
+    int offset = conf->detectionAugmentationOffset;
+    for (size_t i = 0; i < mergedDet.size(); ++i)
+    {
+        int initX = mergedDet[i].x;
+        int initY = mergedDet[i].y;
+        mergedDet[i].x = std::max(mergedDet[i].x - offset, 0);
+        mergedDet[i].y = std::max(mergedDet[i].y - offset, 0);
+        mergedDet[i].width = (mergedDet[i].x + mergedDet[i].width + offset * 2 <= frame.cols)
+            ? mergedDet[i].width + offset * 2
+            : frame.cols - initX;
+        mergedDet[i].height = (mergedDet[i].y + mergedDet[i].height + offset * 2 <= frame.rows)
+            ? mergedDet[i].height + offset * 2
+            : frame.rows - initY;
+        STREAM_DEBUG("END -- mergedDet " << i << ": " << mergedDet[i] << std::endl);
+    }
+
+    ++stats.totalFramesDetect;
+}
+
+void StreamProcessor::trackFaces(const ImageRep& image)
+{
+    if (frameIndex == 0)
+    {
+        for (size_t i = 0; i < mergedDet.size(); ++i) {
+            Track track(confSnapshot, mergedDet[i], trackNumber++);
+            track.setFrontalDetection(mergedDetFrontal[i]);
+            track.reInitTracking(image);
+            currentTracks.push_back(track);
+        }
+        return;
+    }
+
+    FACE_RECOG_DEBUG(TP frameTime = getTimeNowPrecise());
+    pipeline->trackFaces(currentTracks, image);
+    FACE_RECOG_DEBUG(stats.sumTimeTrack += getDeltaTimePrecise(frameTime, MILLISECONDS));
+}
+
+void StreamProcessor::matchDetections(const ImageRep& image, DetectorSet& detectors)
+{
+    // match detection with track if IoU > thresh
+    STREAM_DEBUG("Number of detections = " << mergedDet.size() << std::endl);
+    usedDetectorIndexes.clear();
+    for (size_t i = 0; i < currentTracks.size(); ++i)
+    {
+        for (size_t j = 0; j < mergedDet.size(); ++j)
+        {
+            int maxSize = std::max(currentTracks[i].bbox().width, mergedDet[j].width);
+            cv::Rect resizedTrackBbox = util::getConstSizedRect(currentTracks[i].bbox(), maxSize, frame.size());
+            cv::Rect resizedMergedDetBbox = util::getConstSizedRect(mergedDet[j], maxSize, frame.size());
+            if (util::intersect(resizedTrackBbox, resizedMergedDetBbox, conf->face.overlapThreshold)) {
+                currentTracks[i].insertROI(mergedDet[j]);
+                currentTracks[i].setFrontalDetection(mergedDetFrontal[j]);
+                currentTracks[i].reInitTracking(image);
+                currentTracks[i].markMatched();
+                usedDetectorIndexes.push_back(j);
+                STREAM_DEBUG("Track #" << i << " matched with detection: " << j << std::endl);
+            }
+        }
+    }
+
+    // evaluate removal of tracks not matched with any detection
+    for (size_t i = 0; i < currentTracks.size(); ++i)
+    {
+        if (currentTracks[i].isMatched())
+            continue;
+        cv::Rect bbox = currentTracks[i].bbox();
+        double maxConfidence = detectors.face->evaluateConfidence(currentTracks[i], frameGray);
+        bool onImageEdge = (bbox.x == 0 || bbox.y == 0 || bbox.x + bbox.width == frame.cols || bbox.y + bbox.height == frame.rows);
+        STREAM_DEBUG("Max confidence for track " << currentTracks[i].getTrackNumber() << " = " << maxConfidence << std::endl);
+        if ((maxConfidence <= conf->removeTrackConfidenceOutBounds && onImageEdge) ||
+            (maxConfidence <= conf->removeTrackConfidenceInBounds))
+            currentTracks[i].increaseRemoveCount();
+        else
+            currentTracks[i].setRemoveCount(0);
+    }
+
+    for (std::vector<Track>::iterator iter = currentTracks.begin(); iter != currentTracks.end();)
+    {
+        if (iter->getRemoveCount() >= conf->removeTrackCountThresholdOutBounds) {
+            if (conf->useFaceRecognition)
+                accScores.removeTrackScores(iter->getTrackNumber());
+            iter = currentTracks.erase(iter);
+            STREAM_DEBUG("Removing track" << std::endl);
+        }
+        else
+            ++iter;
+    }
+}
+
+void StreamProcessor::createTracks(const ImageRep& image, DetectorSet& detectors)
+{
+    // unmatched detections
+    for (size_t i = 0; i < mergedDet.size(); ++i)
+        if (std::find(usedDetectorIndexes.begin(), usedDetectorIndexes.end(), i) == usedDetectorIndexes.end())
+            notMatchedDets.push_back(mergedDet[i]);
+    for (size_t i = 0; i < initCandidates.size(); ++i)
+        initCandidates[i].markNotMatched();
+
+    if (initCandidates.size() >= 1 || notMatchedDets.size() >= 1)
+    {
+        if (conf->useHungarianMatching)
+        {
+            association.extendSet(initCandidates, notMatchedDets);
+            association.computeCost(initCandidates, notMatchedDets);
+            association.matchCandidates(initCandidates, notMatchedDets, newCandidates);
+            association.reduceSet(initCandidates);  // remove fake tracks
+        }
+        else
+        {
+            for (size_t i = 0; i < notMatchedDets.size(); ++i)
+                newCandidates.push_back(Track(confSnapshot, notMatchedDets[i]));
+        }
+        STREAM_DEBUG("Number of new candidates: " << newCandidates.size() << std::endl);
+
+        // add new candidates from this frame
+        initCandidates.insert(initCandidates.end(), newCandidates.begin(), newCandidates.end());
+        newCandidates.clear();
+        notMatchedDets.clear();
+
+        // evaluate confidence of init candidates
+        for (size_t i = 0; i < initCandidates.size(); ++i)
+        {
+            double maxConfidence = detectors.face->evaluateConfidence(initCandidates[i], frameGray);
+            STREAM_DEBUG("Max confidence for candidate " << i << " = " << maxConfidence << std::endl);
+            if (maxConfidence > conf->createTrackConfidenceThreshold)
+                initCandidates[i].increaseCreateCount();
+            else
+                initCandidates[i].setCreateCount(-1);
+        }
+    }
+
+    // loop over candidates for track creation
+    for (std::vector<Track>::iterator iter = initCandidates.begin(); iter != initCandidates.end();)
+    {
+        if (iter->getCreateCount() >= conf->createTrackCountThreshold)
+        {
+            iter->setCreateCount(0);
+            iter->reInitTracking(image);
+            iter->setTrackNumber(trackNumber++);
+            iter->setTrackSize(conf->roiAccumulationSize);
+            currentTracks.push_back(*iter);
+            iter = initCandidates.erase(iter);
+            STREAM_DEBUG("Created track" << std::endl);
+        }
+        else if (iter->getCreateCount() == -1)
+            iter = initCandidates.erase(iter);
+        else
+            ++iter; // otherwise, just keep among the candidates
+    }
+}
+
+void StreamProcessor::searchLocalROI(const ImageRep& image, DetectorSet& detectors)
+{
+    FACE_RECOG_DEBUG(TP frameTime = getTimeNowPrecise());
+    size_t nLocalFaceModels = detectors.localFace->modelCount();
+    std::shared_ptr<FaceDetectorVJ> vj(std::static_pointer_cast<FaceDetectorVJ>(detectors.localFace));
+    bool staleOnly = loadShedding.isShedding(LoadSheddingScheduler::STALE_LOCAL_SEARCH);
+    for (size_t i = 0; i < currentTracks.size(); ++i)
+    {
+        // under load, only correct tracks that were not matched by the latest detections
+        if (staleOnly && (currentTracks[i].isMatched() || currentTracks[i].getRemoveCount() == 0))
+            continue;
+
+        // expand ROI by a config factor to give more slack for local search detection
+        // access contained VJ face detector to update parameters for local search (mostly for maxSize)
+        cv::Rect bbox = currentTracks[i].bbox();
+        int expandedMaxSize = (int)(bbox.width * conf->bboxSizeMultiplyer);
+        vj->initializeParameters(conf->face.scaleFactor, conf->face.nmsThreshold, conf->face.minSize,
+                                 cv::Size(expandedMaxSize, expandedMaxSize), conf->face.confidenceSize,
+                                 conf->face.minNeighbours, conf->face.overlapThreshold);
+
+        // execute localize search to find faces ROI
+        cv::Rect localSearchBBox = util::getConstSizedRect(bbox, expandedMaxSize, frame.size());
+        std::vector<std::vector<cv::Rect> > localComboFaces(nLocalFaceModels);
+        detectors.localFace->assignImage(FACE_RECOG_MAT(frameGray, localSearchBBox));
+        detectors.localFace->detect(localComboFaces);
+        std::vector<cv::Rect> newROIs = detectors.localFace->mergeDetections(localComboFaces);
+        STREAM_DEBUG("Local search " << localSearchBBox << ": " << newROIs.size() << " detections in bbox region" << std::endl);
+
+        // find the closest detection from the original one (best match IoU)
+        int bestJ = -1;
+        double bestIoU = -1;
+        for (size_t j = 0; j < newROIs.size(); ++j)
+        {
+            // get absolute position on frame
+            newROIs[j].x += localSearchBBox.x;
+            newROIs[j].y += localSearchBBox.y;
+
+            int maxSize = std::max(bbox.width, newROIs[j].width);
+            cv::Rect resizedTrackBbox = util::getConstSizedRect(bbox, maxSize, frame.size());
+            cv::Rect resizedROI = util::getConstSizedRect(newROIs[j], maxSize, frame.size());
+            double IoU = util::overlap(resizedROI, resizedTrackBbox);
+            if (IoU > bestIoU) {
+                bestIoU = IoU;
+                bestJ = (int)j;
+            }
+        }
+
+        if (bestIoU > 0) {
+            // update latest ROI with adjusted local search bbox
+            ROI roi = currentTracks[i].getROI();
+            roi.updateROI(newROIs[bestJ]);
+            currentTracks[i].updateROI(roi);
+            currentTracks[i].reInitTracking(image);
+            currentTracks[i].markMatched();
+            STREAM_DEBUG("Track #" << currentTracks[i].getTrackNumber() << " localized search match: " << newROIs[bestJ] << std::endl);
+        }
+        ++stats.totalFramesDetectLocal;
+    }
+    FACE_RECOG_DEBUG(stats.sumTimeDetectLocal += getDeltaTimePrecise(frameTime, MILLISECONDS));
+}
+
+void StreamProcessor::detectEyes(DetectorSet& detectors)
+{
+    STREAM_DEBUG("Eye detection: " << currentTracks.size() << " tracks" << std::endl);
+    size_t nEyeModels = detectors.eyes->modelCount();
+    std::shared_ptr<EyeDetector> eyesDetSpec = std::static_pointer_cast<EyeDetector>(detectors.eyes);
+    for (size_t i = 0; i < currentTracks.size(); ++i)
+    {
+        ROI roi = currentTracks[i].getROI(); // Get most recent ROI without eyes
+        for (size_t iDet = 0; iDet < nEyeModels; ++iDet)
+        {
+            // Get the search area, either the full face ROI or localized position if specified
+            cv::Rect searchArea = roi.getRect();
+            if (conf->useEyeLocalizedPosition) {
+                // Top-Left 1/4 of face ROI (or Right if frame is flipped)
+                if ((iDet == eyesDetSpec->leftEyeIndex && !conf->flipFrames) || (iDet == eyesDetSpec->rightEyeIndex && conf->flipFrames))
+                    searchArea = cv::Rect(searchArea.x, searchArea.y, searchArea.width / 2, searchArea.height / 2);
+                // Top-Right 1/4 of face ROI (or Left if frame is flipped)
+                if ((iDet == eyesDetSpec->rightEyeIndex && !conf->flipFrames) || (iDet == eyesDetSpec->leftEyeIndex && conf->flipFrames))
+                    searchArea = cv::Rect(searchArea.x + searchArea.width / 2, searchArea.y, searchArea.width / 2, searchArea.height / 2);
+            }
+            detectors.eyes->assignImage(FACE_RECOG_MAT(frameGray, searchArea));
+        }
+        // Find eyes with each eye detector and add them to the current ROI
+        std::vector<std::vector<cv::Rect> > eyes(nEyeModels);
+        detectors.eyes->detect(eyes);
+        for (size_t iEye = 0; iEye < eyes.size(); ++iEye) {
+            for (size_t jEye = 0; jEye < eyes[iEye].size(); ++jEye) {
+                roi.addSubRect(eyes[iEye][jEye]);
+                currentTracks[i].setValidateEyeDetection();
+            }
+        }
+        currentTracks[i].updateROI(roi); // update current ROI with eyes added
+    }
+}
+
+void StreamProcessor::recognizeFaces()
+{
+    std::vector<size_t> candidates;
+    for (size_t i = 0; i < currentTracks.size(); ++i)
+    {
+        // skip probe if not validated with requested methods
+        if (conf->useLocalSearchROI && !currentTracks[i].getROI().isUpdatedROI() && !currentTracks[i].isUnknown()) {
+            currentTracks[i].markUnknown();
+            continue;
+        }
+        if (conf->useEyesDetection && !currentTracks[i].isValidatedEyeDetection() && !currentTracks[i].isUnknown()) {
+            currentTracks[i].markUnknown();
+            continue;
+        }
+        candidates.push_back(i);
+    }
+
+    // probes worth predicting according to track states, crop quality and frame budget
+    std::vector<size_t> probes = recognitionScheduler.schedule(currentTracks, candidates, frameGray);
+    stats.totalProbes += (int)probes.size();
+    stats.totalProbesSkipped += (int)(candidates.size() - probes.size());
+    STREAM_DEBUG("Recognition probes: " << probes.size() << "/" << candidates.size() << std::endl);
+
+    // normalized probes of all tracks extracted at once if supported by the classifier
+    std::vector<cv::Rect> probeRects(probes.size());
+    for (size_t p = 0; p < probes.size(); ++p)
+        probeRects[p] = currentTracks[probes[p]].bbox();
+    if (probeExtractor.isEnabled())
+        probeExtractor.extract(frameGray, probeRects);
+
+    // predict recognition scores of all probes at once
+    std::vector<FACE_RECOG_MAT> probeROIs(probes.size());
+    for (size_t p = 0; p < probes.size(); ++p)
+        probeROIs[p] = probeExtractor.isEnabled() ? GET_UMAT(probeExtractor.getProbe(p), ACCESS_READ) : frame(probeRects[p]);
+    std::vector<std::vector<double> > probePredictions = pipeline->predictBatch(*models.classifier, probeROIs);
+
+    for (size_t p = 0; p < probes.size(); ++p)
+    {
+        size_t i = probes[p];
+        int currentTrackNum = currentTracks[i].getTrackNumber();
+        const std::vector<double>& predictions = probePredictions[p];
+        accScores.addPredictions(currentTrackNum, predictions);
+
+        FACE_RECOG_DEBUG(
+            for (size_t pos = 0; pos < predictions.size() && pos < minScores.size(); ++pos) {
+                minScores[pos] = std::min(minScores[pos], predictions[pos]);
+                maxScores[pos] = std::max(maxScores[pos], predictions[pos]);
+            }
+        );
+        STREAM_DEBUG("TRACK #" << currentTrackNum << " predictions: " << predictions.size() << std::endl);
+
+        // update target recognitions
+        double bestGuestTargetScore; int bestGuestTargetIndex;
+        accScores.getMaxPositiveInfo(conf->roiAccumulationMode, currentTrackNum, bestGuestTargetIndex, bestGuestTargetScore);
+        recognitionScheduler.update(currentTrackNum, bestGuestTargetScore);
+        if (bestGuestTargetIndex >= 0) {
+            if (bestGuestTargetScore >= conf->thresholdFaceRecognized) {
+                currentTracks[i].markRecognized();
+                currentTracks[i].setName(models.targetIDs[bestGuestTargetIndex]);
+            }
+            else if (bestGuestTargetScore >= conf->thresholdFaceConsidered) {
+                currentTracks[i].markConsidered();
+                currentTracks[i].setName(models.targetIDs[bestGuestTargetIndex]);
+            }
+            else {
+                currentTracks[i].markUnknown();
+                currentTracks[i].setName("");
+            }
+        }
+    }
+}
+
+void StreamProcessor::drawTracks(cv::Mat& image, const MultiColorType& colors)
+{
+    ColorCode bboxColorNotMatched = colors.getColorCode(0);
+    ColorCode bboxColorConsidered = colors.getColorCode(1);
+    ColorCode bboxColorRecognized = colors.getColorCode(2);
+
+    for (size_t i = 0; i < currentTracks.size(); ++i)
+    {
+        // either unused eye detection or required eyes are validated
+        bool eyeOK = !conf->useEyesDetection || currentTracks[i].isValidatedEyeDetection();
+        // display original ROI before update if available and requested
+        bool showUpdate = conf->useLocalSearchROI && conf->displayOldROI && currentTracks[i].getROI().isUpdatedROI();
+
+        ColorCode color = (eyeOK && currentTracks[i].isRecognized()) ? bboxColorRecognized  // Recognized
+                        : (eyeOK && currentTracks[i].isConsidered()) ? bboxColorConsidered  // Considered
+                        : bboxColorNotMatched;                                              // NotMatched | no eyes
+
+        // draw old face ROI (original detection), then updated face ROI
+        cv::Rect bbox = currentTracks[i].bbox();
+        if (showUpdate)
+            cv::rectangle(image, currentTracks[i].getROI().getOriginalRect(), color, conf->roiThicknessOld);
+        cv::rectangle(image, bbox, color, conf->roiThickness);
+
+        // display recognition score and target ID
+        if (conf->useFaceRecognition) {
+            int bestPosIndex = -1; double bestPosScore = 0;
+            accScores.getMaxPositiveInfo(conf->roiAccumulationMode, currentTracks[i].getTrackNumber(), bestPosIndex, bestPosScore);
+            if ((currentTracks[i].isRecognized() || currentTracks[i].isConsidered()) && bestPosIndex >= 0) {
+                std::string strTargetTagAndScore = models.targetIDs[bestPosIndex] + " | " + std::to_string(bestPosScore);
+                cv::Point point(bbox.x, bbox.y + bbox.height + 15);
+                cv::putText(image, strTargetTagAndScore, point, cv::FONT_HERSHEY_PLAIN, 1.0, color, 2);
+            }
+        }
+
+        // display track number
+        std::string strTrackerNumber = cv::format("#%u", currentTracks[i].getTrackNumber());
+        cv::putText(image, strTrackerNumber, cv::Point(bbox.x, bbox.y - 10), cv::FONT_HERSHEY_PLAIN, 1.0, color, 2);
+
+        // draw eyes ROI
+        if (conf->useEyesDetection) {
+            const ROI& roi = currentTracks[i].getROI();
+            ColorCode darkColor = color / 2;
+            for (size_t iEye = 0; iEye < roi.countSubROI(); ++iEye)
+                cv::rectangle(image, roi.getSubRect(iEye), darkColor, 2);
+        }
+    }
+}
+
+void StreamProcessor::writeResultsHeader(logstream& logResult, size_t targetCount)
+{
+    logResult << "SEQUENCE_TRACK_ID,SEQUENCE_NUMBER,FRAME_NUMBER,TRACK_COUNT,TARGET_COUNT,TRACK_NUMBER,"
+              << "BEST_LABEL,BEST_SCORE_RAW,BEST_SCORE_ACC,ROI_TL_X,ROI_TL_Y,ROI_BR_X,ROI_BR_Y";
+    for (size_t poi = 0; poi < targetCount; ++poi) {
+        std::string spoi = std::to_string(poi);
+        logResult << ",TARGET_LABEL_" + spoi + ",TARGET_SCORE_RAW_" + spoi + ",TARGET_SCORE_ACC_" + spoi;
+    }
+    logResult << std::endl;
+}
+
+/*
+    Output recognition results of the current frame as CSV line:
+        SEQUENCE_TRACK_ID,SEQUENCE_NUMBER,FRAME_NUMBER,TRACK_COUNT,TARGET_COUNT{<results>(i)}     for i=TRACK_COUNT
+    where each <results>(i):
+        ,TRACK_NUMBER,BEST_LABEL,BEST_SCORE_RAW,BEST_SCORE_ACC,
+        ROI_TL_X,ROI_TL_Y,ROI_BR_X,ROI_BR_Y{<result_target>(j)}     for j=TARGET_COUNT
+    where each <result_target>(j):
+        ,TARGET_LABEL,TARGET_SCORE_RAW,TARGET_SCORE_ACC
+*/
+void StreamProcessor::writeResults(logstream& logResult, const std::string& sequenceID, size_t sequenceNumber, const std::string& frameLabel)
+{
+    size_t targetCount = models.targetIDs.size();
+    size_t trackCount = currentTracks.size();
+    logResult << sequenceID << "," << sequenceNumber << "," << frameLabel << "," << trackCount << "," << targetCount;
+    for (size_t i = 0; i < trackCount; ++i)
+    {
+        cv::Point tl = currentTracks[i].bbox().tl();
+        cv::Point br = currentTracks[i].bbox().br();
+        size_t trackNum = currentTracks[i].getTrackNumber();
+        std::string targetsLabelScores;
+        std::string bestPosID;
+        int bestPosIndex = -1;
+        double bestPosScore = 0;
+        double bestRawScore = -1;
+        if (conf->useFaceRecognition) {
+            accScores.getMaxPositiveInfo(conf->roiAccumulationMode, trackNum, bestPosIndex, bestPosScore);
+            if (bestPosIndex >= 0) {
+                bestPosID = models.targetIDs[bestPosIndex];
+                bestRawScore = accScores.getRawScore(trackNum, bestPosIndex);
+            }
+            for (size_t j = 0; j < targetCount; ++j) {
+                targetsLabelScores += ("," + models.targetIDs[j] + "," + std::to_string(accScores.getRawScore(trackNum, j)) +
+                                       "," + std::to_string(accScores.getScore(conf->roiAccumulationMode, trackNum, j)));
+            }
+        }
+        logResult << "," << trackNum << "," << bestPosID << "," << bestRawScore << "," << bestPosScore;
+        logResult << "," << tl.x << "," << tl.y << "," << br.x << "," << br.y << targetsLabelScores;
+    }
+    logResult << std::endl;
+}
+
+void StreamProcessor::saveTrackROIs(const std::string& frameLabel, const std::string& roiDir, const std::string& localRoiDir)
+{
+    size_t nTracks = currentTracks.size();
+    if (conf->outputROI && !roiDir.empty()) {
+        std::vector<cv::Rect> rects(nTracks);
+        for (size_t i = 0; i < nTracks; ++i)
+            rects[i] = currentTracks[i].getROI().getOriginalRect();
+        roiExtractor.extract(frameGray, rects);
+        for (size_t i = 0; i < nTracks; ++i)
+            saveTrackROI(roiExtractor.getProbe(i), frameLabel, currentTracks[i].getTrackNumber(), roiDir);
+    }
+    if (conf->outputLocalROI && !localRoiDir.empty()) {
+        std::vector<cv::Rect> rects(nTracks);
+        for (size_t i = 0; i < nTracks; ++i)
+            rects[i] = currentTracks[i].bbox();
+        roiExtractor.extract(frameGray, rects);
+        for (size_t i = 0; i < nTracks; ++i)
+            saveTrackROI(roiExtractor.getProbe(i), frameLabel, currentTracks[i].getTrackNumber(), localRoiDir);
+    }
+}
+
+void StreamProcessor::saveTrackROI(const cv::Mat& roi, const std::string& frameLabel, int trackNumber, const std::string& dirPath)
+{
+    if (outputWriter)
+        outputWriter->writeTrackROI(roi, frameLabel, trackNumber, dirPath);
+    else
+        util::saveTrackROIImage(roi, frameLabel, trackNumber, dirPath);
+}
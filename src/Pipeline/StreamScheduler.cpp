@@ -0,0 +1,139 @@
+﻿#include "Pipeline/StreamScheduler.h"
+#include "FaceRecog.h"
+
+StreamScheduler::StreamScheduler(const ConfigFile* config, const SharedModels& sharedModels, const std::string& modelBasePath)
+    : conf(config)
+    , models(sharedModels)
+    , stopping(false)
+{
+    ASSERT_LOG(conf, "ConfigFile reference invalid");
+    pool.reset(new ThreadPool(conf->multiStreamWorkers, conf->multiStreamOmpThreads));
+
+    // detectors memorize assigned images and their cascades cannot run concurrently, one set per worker
+    for (size_t w = 0; w < pool->workerCount(); ++w)
+        detectorSets.push_back(buildDetectorSet(*conf, modelBasePath));
+}
+
+StreamScheduler::~StreamScheduler()
+{
+    // capture threads submit tasks until they are stopped
+    stop();
+    for (size_t s = 0; s < streams.size(); ++s)
+        if (streams[s]->captureThread.joinable())
+            streams[s]->captureThread.join();
+    pool.reset();
+}
+
+bool StreamScheduler::addStream(const std::string& source, const std::string& resultFilePath)
+{
+    std::unique_ptr<Stream> stream(new Stream);
+    stream->sourceID = source;
+    stream->source.reset(new StreamSource(*conf));
+
+    // plain integer is a camera index, anything else is a video file or image files sequence
+    bool isCamera = !source.empty() && std::all_of(source.begin(), source.end(), ::isdigit);
+    bool opened = isCamera ? stream->source->open(conf->cameraType, std::stoi(source)) : stream->source->open(source);
+    if (!opened) {
+        ASSERT_WARN(false, "Failed to open stream source [" + source + "]");
+        return false;
+    }
+
+    stream->processor.reset(new StreamProcessor(conf, models));
+    stream->logResult.reset(new logstream(resultFilePath, false, true));
+    StreamProcessor::writeResultsHeader(*stream->logResult, models.targetIDs.size());
+    streams.push_back(std::move(stream));
+    return true;
+}
+
+void StreamScheduler::run()
+{
+    // single task in flight per stream, submitted by the capture thread for live-feed streams
+    for (size_t s = 0; s < streams.size(); ++s) {
+        if (streams[s]->source->isLive())
+            streams[s]->captureThread = std::thread(&StreamScheduler::capture, this, s);
+        else
+            pool->submit([this, s] { processNext(s); });
+    }
+
+    // no more tasks are submitted by live-feed streams once their capture is over
+    for (size_t s = 0; s < streams.size(); ++s)
+        if (streams[s]->captureThread.joinable())
+            streams[s]->captureThread.join();
+    pool->wait();
+    stop();
+}
+
+void StreamScheduler::stop()
+{
+    stopping = true;
+}
+
+void StreamScheduler::capture(size_t streamIndex)
+{
+    Stream& stream = *streams[streamIndex];
+    FACE_RECOG_MAT frame;
+    while (!stopping && stream.source->read(frame))
+    {
+        bool submit;
+        {
+            std::lock_guard<std::mutex> lock(stream.frameMutex);
+            if (stream.hasFrame)
+                ++stream.droppedFrames;     // processing not fast enough, skip to most recent frame
+            frame.copyTo(stream.latestFrame);
+            stream.hasFrame = true;
+            submit = !stream.taskQueued;
+            stream.taskQueued = true;
+        }
+        if (submit)
+            pool->submit([this, streamIndex] { processNext(streamIndex); });
+    }
+}
+
+// false when the stream is exhausted, or for live-feed streams when no new frame was captured yet
+bool StreamScheduler::nextFrame(Stream& stream, FACE_RECOG_MAT& frame)
+{
+    if (!stream.source->isLive())
+        return stream.source->read(frame);
+
+    std::lock_guard<std::mutex> lock(stream.frameMutex);
+    if (!stream.hasFrame) {
+        stream.taskQueued = false;
+        return false;
+    }
+    std::swap(frame, stream.latestFrame);
+    stream.hasFrame = false;
+    return true;
+}
+
+void StreamScheduler::processNext(size_t streamIndex)
+{
+    if (stopping)
+        return;
+
+    Stream& stream = *streams[streamIndex];
+    FACE_RECOG_MAT frame;
+    if (!nextFrame(stream, frame))
+        return;
+
+    int worker = pool->currentWorkerIndex();
+    ASSERT_LOG(worker >= 0, "Stream processing must be executed by a pool worker");
+    try {
+        stream.processor->process(frame, detectorSets[worker]);
+        stream.processor->writeResults(*stream.logResult, stream.sourceID, streamIndex, std::to_string(stream.frameCounter));
+    }
+    catch (...) {
+        stop();     // capture threads would otherwise keep running without any task processing their frames
+        throw;
+    }
+    ++stream.frameCounter;
+
+    // requeue behind other streams' pending tasks, live-feed streams only if their next frame is already captured
+    if (stream.source->isLive()) {
+        std::lock_guard<std::mutex> lock(stream.frameMutex);
+        if (!stream.hasFrame) {
+            stream.taskQueued = false;
+            return;
+        }
+    }
+    pool->submit([this, streamIndex] { processNext(streamIndex); });
+}
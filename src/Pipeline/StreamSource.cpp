@@ -0,0 +1,150 @@
+﻿#include "Pipeline/StreamSource.h"
+#include "Camera/FlyCapture2Utilities.h"
+#include "FaceRecog.h"
+
+StreamSource::StreamSource(const ConfigFile& config)
+    : cameraType(CameraType::UNDEFINED)
+    , opened(false)
+{
+    useCameraTrigger = config.useCameraTrigger;
+    // mirror image for display only if using a camera video stream and if the option was set
+    flipFrames = config.displayFrames && config.flipFrames;
+    verbose = config.verboseDebug;
+    decodeThreads = (size_t)config.frameDecodeThreads;
+    readAhead = (size_t)config.frameReadAhead;
+    decodeReduction = config.frameDecodeReduction;
+    frameSize = cv::Size(config.displayWindowW, config.displayWindowH);
+    frameVideo = FACE_RECOG_MAT(frameSize, CV_8UC3);
+}
+
+StreamSource::~StreamSource()
+{
+    release();
+}
+
+bool StreamSource::open(const std::string& path)
+{
+    release();
+    cameraType = CameraType::FILE_STREAM;
+    sourcePath = path;
+    opened = capture.open(path);
+    return opened;
+}
+
+bool StreamSource::open(const std::string& path, const std::vector<std::string>& frameNames)
+{
+    if (decodeThreads == 0)
+        return open(path);
+
+    // names are file stems of the regex path directory, the regex path provides their extension
+    release();
+    cameraType = CameraType::FILE_STREAM;
+    sourcePath = path;
+    bfs::path regexPath(path);
+    std::string extension = regexPath.extension().string();
+    std::vector<std::string> filePaths(frameNames.size());
+    for (size_t f = 0; f < frameNames.size(); ++f)
+        filePaths[f] = (regexPath.parent_path() / bfs::path(frameNames[f] + extension)).string();
+    reader.reset(new FrameSequenceReader(decodeThreads, readAhead, decodeReduction));
+    reader->open(filePaths);
+    opened = !filePaths.empty();
+    return opened;
+}
+
+bool StreamSource::open(const CameraType& type, int cameraIndex)
+{
+    release();
+    cameraType = type;
+    sourcePath = std::to_string(cameraIndex);
+    if (cameraType == CameraType::CV_VIDEO_CAPTURE)
+    {
+        opened = capture.open(cameraIndex);
+        if (opened) {
+            capture.set(CV_CAP_PROP_FRAME_HEIGHT, frameSize.height);
+            capture.set(CV_CAP_PROP_FRAME_WIDTH, frameSize.width);
+        }
+    }
+    else if (cameraType == CameraType::PGR_FLYCAPTURE2)
+    {
+        #if FACE_RECOG_HAS_FLYCAPTURE2
+        camera.reset(new FlyCapture2::Camera);
+        opened = (ConnectCameraPGR(camera.get(), cameraIndex, useCameraTrigger) == FlyCapture2::PGRERROR_OK);
+        #else
+        ASSERT_WARN(false, "Point Grey Research FlyCaputre2 SDK not found, cannot employ camera type specified in 'config.txt'");
+        #endif/*FACE_RECOG_HAS_FLYCAPTURE2*/
+    }
+    return opened;
+}
+
+void StreamSource::release()
+{
+    if (capture.isOpened())
+        capture.release();
+    reader.reset();
+    #if FACE_RECOG_HAS_FLYCAPTURE2
+    if (camera) {
+        camera->StopCapture();
+        camera->Disconnect();
+        camera.reset();
+    }
+    #endif/*FACE_RECOG_HAS_FLYCAPTURE2*/
+    opened = false;
+}
+
+bool StreamSource::read(FACE_RECOG_MAT& frame)
+{
+    if (!opened) return false;
+
+    if (reader)
+    {
+        // next frame decoded ahead by the reader threads
+        if (!reader->read(frameDecoded))
+            return false;
+        frameDecoded.copyTo(frameVideo);
+    }
+    else if (cameraType == CameraType::CV_VIDEO_CAPTURE || cameraType == CameraType::FILE_STREAM)
+    {
+        // grab next VideoCapture frame
+        if (!capture.read(frameVideo))
+            return false;
+    }
+    else if (cameraType == CameraType::PGR_FLYCAPTURE2)
+    {
+        #if FACE_RECOG_HAS_FLYCAPTURE2
+        for (;;)
+        {
+            // Trigger next frame if trigger is employed
+            if (useCameraTrigger)
+                FireTriggerWhenReady(camera.get(), verbose);
+
+            // grab the next FlyCapture2 frame and check for error
+            // if image consistency error, drop the frame and retry, otherwise stop (general error)
+            FlyCapture2::Error cameraError = camera->RetrieveBuffer(&pgrRawImage);
+            if (!EvaluateAndPrintCameraError(cameraError, "PGR camera frame grabbing error"))
+                break;
+            if (cameraError != FlyCapture2::PGRERROR_IMAGE_CONSISTENCY_ERROR)
+                return false;
+        }
+
+        // convert to OpenCV image type and preprocessing resize as required
+        ConvertRGBImagePGR2CV(pgrRawImage, frameRaw);
+        if (frameRaw.size() != frameVideo.size())
+            FACE_RECOG_NAMESPACE::resize(frameRaw, frameVideo, frameVideo.size(), 0, 0, cv::INTER_AREA);
+        else
+            frameVideo = frameRaw;
+        #else
+        return false;
+        #endif/*FACE_RECOG_HAS_FLYCAPTURE2*/
+    }
+
+    if (flipFrames && isLive())
+        frameVideo = imFlip(frameVideo, FlipMode::HORIZONTAL);
+
+    // Upload to GPU for processing
+    #if FACE_RECOG_USE_CUDA
+    frame.upload(frameVideo);
+    #else
+    frame = frameVideo; // pass directly
+    #endif
+    return true;
+}
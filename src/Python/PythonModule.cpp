@@ -2,79 +2,384 @@
 
 #include "FaceRecog.h"
 
-//#define PY_ARRAY_UNIQUE_SYMBOL pbcvt_ARRAY_API
-
 #include <boost/python.hpp>
 #include <Python/PyCvBoostConverter.h>
 
-namespace pbcvt {
+/*
+    Python extension module 'facerecog' exposing the engine for offline analytics
 
-using namespace boost::python;
+        config = facerecog.Config("config.txt")
+        config.set("detectionFrameInterval", "3")
+        classifier = facerecog.Classifier(config, opencvDataPath)
+        processor = facerecog.StreamProcessor(config, modelBasePath, classifier)
+        results = processor.process_sequence(frames)    # [(tracks, scores)] per frame
+        tracker = facerecog.Tracker(config)             # single face tracker of the config type
+        tracker.init(frame, x, y, width, height)
+        bbox = tracker.update(next_frame)
 
-/**
-* Example function. Basic inner matrix product using explicit matrix conversion.
-* @param left left-hand matrix operand (NdArray required)
-* @param right right-hand matrix operand (NdArray required)
-* @return an NdArray representing the dot-product of the left and right operands
-*/
-PyObject *dot(PyObject *left, PyObject *right) {
-
-    cv::Mat leftMat, rightMat;
-    leftMat = pbcvt::fromNDArrayToMat(left);
-    rightMat = pbcvt::fromNDArrayToMat(right);
-    auto c1 = leftMat.cols, r2 = rightMat.rows;
-    // Check that the 2-D matrices can be legally multiplied.
-    if (c1 != r2) {
-        PyErr_SetString(PyExc_TypeError, "Incompatible sizes for matrix multiplication.");
-        throw_error_already_set();
-    }
-    cv::Mat result = leftMat * rightMat;
-    PyObject *ret = pbcvt::fromMatToNDArray(result);
-    return ret;
-}
+    Objects keep the configuration they were built with, 'Config.set' replaces it by a modified copy
+    (immutable snapshots) that only objects built afterward employ (ex: parameter sweeps).
 
-//This example uses Mat directly, but we won't need to worry about the conversion
-/**
-* Example function. Basic inner matrix product using implicit matrix conversion.
-* @param leftMat left-hand matrix operand
-* @param rightMat right-hand matrix operand
-* @return an NdArray representing the dot-product of the left and right operands
+    Frames are NumPy uint8 arrays (HxW grayscale or HxWx3 BGR) employed as views without copy and
+    models building and processing are applied with the GIL released (Python based models acquire it
+    from their own thread). Results are NumPy arrays sharing the memory of the
+    computed matrices:
+        detections  (N x 4) int32       [x, y, width, height]
+        tracks      (N x 7) float64     [track number, x, y, width, height, best target index, best score]
+        bbox        (1 x 4) int32       [x, y, width, height]
+        scores      (N x T) float64     accumulated score of each target (classifier order)
 */
-cv::Mat dot2(cv::Mat leftMat, cv::Mat rightMat) {
-    auto c1 = leftMat.cols, r2 = rightMat.rows;
-    if (c1 != r2) {
-        PyErr_SetString(PyExc_TypeError, "Incompatible sizes for matrix multiplication.");
-        throw_error_already_set();
-    }
-    cv::Mat result = leftMat * rightMat;
+namespace facerecog_py {
 
-    return result;
-}
+namespace bp = boost::python;
 
 #if (PY_VERSION_HEX >= 0x03000000)
-static void *init_ar() {
+static void* initNumpy() {
 #else
-static void init_ar() {
+static void initNumpy() {
 #endif
-    Py_Initialize();
-
     import_array();
     return NUMPY_IMPORT_ARRAY_RETVAL;
 }
 
-BOOST_PYTHON_MODULE(pbcvt) {
-    //using namespace XM;
-    init_ar();
+class ScopedReleaseGIL
+{
+public:
+    ScopedReleaseGIL() : state(PyEval_SaveThread()) {}
+    ~ScopedReleaseGIL() { PyEval_RestoreThread(state); }
+private:
+    PyThreadState* state;
+};
+
+// frame view over the array memory, valid as long as the array is referenced by the caller
+cv::Mat fromArray(const bp::object& object)
+{
+    ASSERT_LOG(PyArray_Check(object.ptr()), "Expected a NumPy array");
+    PyArrayObject* array = (PyArrayObject*)object.ptr();
+    int nDims = PyArray_NDIM(array);
+    int channels = nDims == 3 ? (int)PyArray_DIM(array, 2) : 1;
+    ASSERT_LOG(PyArray_TYPE(array) == NPY_UINT8 && (nDims == 2 || (nDims == 3 && channels == 3)),
+               "Expected uint8 grayscale (HxW) or BGR (HxWx3) NumPy array");
+    ASSERT_LOG(PyArray_STRIDE(array, 1) == channels && (nDims == 2 || PyArray_STRIDE(array, 2) == 1),
+               "Expected NumPy array with contiguous rows");
+    return cv::Mat((int)PyArray_DIM(array, 0), (int)PyArray_DIM(array, 1), CV_8UC(channels),
+                   PyArray_DATA(array), (size_t)PyArray_STRIDE(array, 0));
+}
+
+static void releaseMat(PyObject* capsule)
+{
+    delete (cv::Mat*)PyCapsule_GetPointer(capsule, NULL);
+}
+
+// array sharing the matrix memory, kept alive by a capsule owning the matrix header
+bp::object toArray(const cv::Mat& mat)
+{
+    ASSERT_LOG(mat.channels() == 1 && (mat.depth() == CV_32S || mat.depth() == CV_8U || mat.depth() == CV_64F),
+               "Unsupported matrix format for NumPy conversion");
+    cv::Mat* owner = new cv::Mat(mat.isContinuous() ? mat : mat.clone());
+    npy_intp dims[2] = { owner->rows, owner->cols };
+    int typenum = owner->depth() == CV_32S ? NPY_INT32 : owner->depth() == CV_8U ? NPY_UINT8 : NPY_FLOAT64;
+    PyObject* array = PyArray_SimpleNewFromData(2, dims, typenum, owner->data);
+    PyArray_SetBaseObject((PyArrayObject*)array, PyCapsule_New(owner, NULL, releaseMat));
+    return bp::object(bp::handle<>(array));
+}
+
+FACE_RECOG_MAT toColorFrame(const cv::Mat& image)
+{
+    if (image.channels() == 3)
+        return GET_UMAT(image, ACCESS_READ);
+    cv::Mat color;
+    cv::cvtColor(image, color, cv::COLOR_GRAY2BGR);
+    return GET_UMAT(color, ACCESS_READ);
+}
+
+class Config
+{
+public:
+    Config(const std::string& path) : config(std::make_shared<ConfigFile>(path)) {}
+    // copy on write, the snapshot held by already built objects is never modified
+    bool set(const std::string& name, const std::string& value)
+    {
+        std::shared_ptr<ConfigFile> modified = std::make_shared<ConfigFile>(*config);
+        if (!modified->setValue(name, value))
+            return false;
+        config = modified;
+        return true;
+    }
+    std::string display() const { return config->display(); }
+    ConfigSnapshot config;
+};
+
+class Detector
+{
+public:
+    Detector(const Config& config, const std::string& modelBasePath)
+        : config(config.config)
+    {
+        ScopedReleaseGIL release;
+        detector = buildSpecializedDetector(*this->config, modelBasePath, DetectorType::FACE_DETECTOR_GLOBAL);
+        ASSERT_LOG(detector, "Global face detector not properly initialized");
+    }
+
+    bp::object detect(const bp::object& frame)
+    {
+        cv::Mat image = fromArray(frame);
+        std::vector<cv::Rect> bboxes;
+        {
+            ScopedReleaseGIL release;
+            cv::Mat gray = image;
+            if (image.channels() == 3)
+                cv::cvtColor(image, gray, cv::COLOR_BGR2GRAY);
+            detector->assignImage(GET_UMAT(gray, ACCESS_READ));
+            detector->detectMerge(bboxes);
+        }
+        cv::Mat detections((int)bboxes.size(), 4, CV_32S);
+        for (int d = 0; d < detections.rows; ++d) {
+            detections.at<int>(d, 0) = bboxes[d].x;
+            detections.at<int>(d, 1) = bboxes[d].y;
+            detections.at<int>(d, 2) = bboxes[d].width;
+            detections.at<int>(d, 3) = bboxes[d].height;
+        }
+        return toArray(detections);
+    }
+
+private:
+    ConfigSnapshot config;
+    std::shared_ptr<IDetector> detector;
+};
+
+class Classifier
+{
+public:
+    // POI and negatives enrollment from the directories specified by the config
+    Classifier(const Config& config, const std::string& opencvDataPath)
+        : config(config.config)
+    {
+        ScopedReleaseGIL release;
+        logstream logger("facerecog_python.log", true, false);
+        std::vector<std::vector<FACE_RECOG_MAT> > POI_ROIs, NEG_ROIs;
+        ASSERT_LOG(util::prepareEnrollROIs(*this->config, opencvDataPath, POI_ROIs, targetIDs, NEG_ROIs, logger) == EXIT_SUCCESS,
+                   "Error on POI loading");
+        ASSERT_LOG(POI_ROIs.size() > 0, "Can't build a classifier without any Person of Interest (POI)");
+        classifier = buildSpecializedClassifier(*this->config, POI_ROIs, targetIDs, NEG_ROIs);
+        ASSERT_LOG(classifier, "Classifier not properly initialized");
+    }
+
+    bp::list targets() const
+    {
+        bp::list ids;
+        for (size_t t = 0; t < targetIDs.size(); ++t)
+            ids.append(targetIDs[t]);
+        return ids;
+    }
+
+    bp::object predict(const bp::object& roi)
+    {
+        bp::list rois;
+        rois.append(roi);
+        return predictBatch(rois);
+    }
+
+    // (N x T) scores of all ROIs predicted with a single batch call
+    bp::object predictBatch(const bp::list& rois)
+    {
+        size_t nRois = (size_t)bp::len(rois);
+        std::vector<cv::Mat> images(nRois);
+        for (size_t r = 0; r < nRois; ++r)
+            images[r] = fromArray(rois[r]);
+        cv::Mat scores((int)nRois, (int)targetIDs.size(), CV_64F, cv::Scalar(0));
+        {
+            ScopedReleaseGIL release;
+            std::vector<FACE_RECOG_MAT> probes(nRois);
+            for (size_t r = 0; r < nRois; ++r)
+                probes[r] = GET_UMAT(images[r], ACCESS_READ);
+            std::vector<std::vector<double> > predictions = classifier->predictBatch(probes);
+            for (size_t r = 0; r < nRois; ++r)
+                for (size_t t = 0; t < predictions[r].size() && t < targetIDs.size(); ++t)
+                    scores.at<double>((int)r, (int)t) = predictions[r][t];
+        }
+        return toArray(scores);
+    }
+
+    ConfigSnapshot config;
+    std::shared_ptr<IClassifier> classifier;
+    std::vector<std::string> targetIDs;
+};
+
+class Tracker : boost::noncopyable
+{
+public:
+    Tracker(const Config& config) : config(config.config) {}
+
+    // new track of the face bounding box, tracker type selected by the config
+    void init(const bp::object& frame, int x, int y, int width, int height)
+    {
+        cv::Mat image = fromArray(frame);
+        ScopedReleaseGIL release;
+        FrameContext context(toColorFrame(image));
+        ImageRep imageRep(context);
+        track.reset(new Track(config, cv::Rect(x, y, width, height)));
+        track->reInitTracking(imageRep);
+    }
+
+    bp::object update(const bp::object& frame)
+    {
+        ASSERT_LOG(track, "Tracker must be initialized before update");
+        cv::Mat image = fromArray(frame);
+        cv::Mat bbox(1, 4, CV_32S);
+        {
+            ScopedReleaseGIL release;
+            FrameContext context(toColorFrame(image));
+            ImageRep imageRep(context);
+            track->track(imageRep);
+            cv::Rect rect = track->bbox();
+            bbox.at<int>(0) = rect.x;
+            bbox.at<int>(1) = rect.y;
+            bbox.at<int>(2) = rect.width;
+            bbox.at<int>(3) = rect.height;
+        }
+        return toArray(bbox);
+    }
+
+private:
+    ConfigSnapshot config;
+    std::unique_ptr<Track> track;
+};
+
+class Processor : boost::noncopyable
+{
+public:
+    Processor(const Config& config, const std::string& modelBasePath)
+        : config(config.config)
+    {
+        initialize(modelBasePath, SharedModels());
+    }
+
+    Processor(const Config& config, const std::string& modelBasePath, const Classifier& classifier)
+        : config(config.config)
+    {
+        SharedModels models;
+        models.classifier = classifier.classifier;
+        models.targetIDs = classifier.targetIDs;
+        initialize(modelBasePath, models);
+    }
+
+    void reset() { processor->reset(); }
+
+    bp::tuple process(const bp::object& frame)
+    {
+        cv::Mat image = fromArray(frame);
+        cv::Mat tracks, scores;
+        {
+            ScopedReleaseGIL release;
+            processor->process(toColorFrame(image), detectors);
+            collectResults(tracks, scores);
+        }
+        return bp::make_tuple(toArray(tracks), toArray(scores));
+    }
+
+    // whole sequence processed without the GIL, frames as arrays or image file paths
+    bp::list processSequence(const bp::list& frames)
+    {
+        size_t nFrames = (size_t)bp::len(frames);
+        std::vector<cv::Mat> images(nFrames);
+        std::vector<std::string> paths(nFrames);
+        for (size_t f = 0; f < nFrames; ++f) {
+            bp::extract<std::string> path(frames[f]);
+            if (path.check())
+                paths[f] = path();
+            else
+                images[f] = fromArray(frames[f]);
+        }
+
+        std::vector<cv::Mat> tracks(nFrames), scores(nFrames);
+        {
+            ScopedReleaseGIL release;
+            for (size_t f = 0; f < nFrames; ++f) {
+                cv::Mat image = paths[f].empty() ? images[f] : cv::imread(paths[f], cv::IMREAD_COLOR);
+                ASSERT_LOG(!image.empty(), "Failed to read sequence frame [" + paths[f] + "]");
+                processor->process(toColorFrame(image), detectors);
+                collectResults(tracks[f], scores[f]);
+            }
+        }
+
+        bp::list results;
+        for (size_t f = 0; f < nFrames; ++f)
+            results.append(bp::make_tuple(toArray(tracks[f]), toArray(scores[f])));
+        return results;
+    }
+
+private:
+    void initialize(const std::string& modelBasePath, const SharedModels& models)
+    {
+        targetCount = models.targetIDs.size();
+        ASSERT_LOG(!config->useFaceRecognition || models.classifier, "Config 'useFaceRecognition' requires a classifier");
+        ScopedReleaseGIL release;
+        detectors = buildDetectorSet(*config, modelBasePath);
+        processor.reset(new StreamProcessor(config.get(), models));
+    }
+
+    void collectResults(cv::Mat& tracks, cv::Mat& scores)
+    {
+        std::vector<Track>& currentTracks = processor->getTracks();
+        CircularBuffer& accScores = processor->getScores();
+        tracks = cv::Mat((int)currentTracks.size(), 7, CV_64F, cv::Scalar(0));
+        scores = cv::Mat((int)currentTracks.size(), (int)targetCount, CV_64F, cv::Scalar(0));
+        for (int i = 0; i < tracks.rows; ++i)
+        {
+            int trackNum = currentTracks[i].getTrackNumber();
+            cv::Rect bbox = currentTracks[i].bbox();
+            int bestIndex = -1;
+            double bestScore = 0;
+            if (config->useFaceRecognition) {
+                accScores.getMaxPositiveInfo(config->roiAccumulationMode, trackNum, bestIndex, bestScore);
+                for (int t = 0; t < scores.cols; ++t)
+                    scores.at<double>(i, t) = accScores.getScore(config->roiAccumulationMode, trackNum, t);
+            }
+            double* row = tracks.ptr<double>(i);
+            row[0] = trackNum;
+            row[1] = bbox.x;
+            row[2] = bbox.y;
+            row[3] = bbox.width;
+            row[4] = bbox.height;
+            row[5] = bestIndex;
+            row[6] = bestScore;
+        }
+    }
+
+    ConfigSnapshot config;
+    std::unique_ptr<StreamProcessor> processor;
+    DetectorSet detectors;
+    size_t targetCount;
+};
+
+BOOST_PYTHON_MODULE(facerecog)
+{
+    initNumpy();
+
+    bp::class_<Config>("Config", bp::init<std::string>())
+        .def("set", &Config::set)
+        .def("__str__", &Config::display);
+
+    bp::class_<Detector>("Detector", bp::init<const Config&, std::string>())
+        .def("detect", &Detector::detect);
+
+    bp::class_<Classifier>("Classifier", bp::init<const Config&, std::string>())
+        .add_property("targets", &Classifier::targets)
+        .def("predict", &Classifier::predict)
+        .def("predict_batch", &Classifier::predictBatch);
 
-    //initialize converters
-    to_python_converter<cv::Mat, pbcvt::matToNDArrayBoostConverter>();
-    pbcvt::matFromNDArrayBoostConverter();
+    bp::class_<Tracker, boost::noncopyable>("Tracker", bp::init<const Config&>())
+        .def("init", &Tracker::init)
+        .def("update", &Tracker::update);
 
-    //expose module-level functions
-    def("dot", dot);
-    def("dot2", dot2);
+    bp::class_<Processor, boost::noncopyable>("StreamProcessor", bp::init<const Config&, std::string>())
+        .def(bp::init<const Config&, std::string, const Classifier&>())
+        .def("reset", &Processor::reset)
+        .def("process", &Processor::process)
+        .def("process_sequence", &Processor::processSequence);
 }
 
-} //end namespace pbcvt
+} // end namespace facerecog_py
 
 #endif/*FACE_RECOG_HAS_PYTHON*/
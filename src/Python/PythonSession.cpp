@@ -0,0 +1,204 @@
+﻿#ifdef FACE_RECOG_HAS_PYTHON
+
+#include "Python/PythonSession.h"
+#include "FaceRecog.h"
+
+std::unique_ptr<PythonSession> PythonSession::session;
+std::mutex PythonSession::sessionMutex;
+PyThreadState* PythonSession::mainThreadState = nullptr;
+
+void PythonSession::initialize()
+{
+    if (Py_IsInitialized())
+        return;
+    Py_Initialize();
+    PyEval_InitThreads();
+    mainThreadState = PyEval_SaveThread();
+}
+
+void PythonSession::finalize()
+{
+    std::lock_guard<std::mutex> lock(sessionMutex);
+    session.reset();
+    if (mainThreadState) {
+        PyEval_RestoreThread(mainThreadState);
+        mainThreadState = nullptr;
+        Py_Finalize();
+    }
+}
+
+PythonSession& PythonSession::instance()
+{
+    std::lock_guard<std::mutex> lock(sessionMutex);
+    if (!session) {
+        initialize();
+        session.reset(new PythonSession());
+    }
+    return *session;
+}
+
+PythonSession::PythonSession()
+{
+    stopping = false;
+    thread = std::thread(&PythonSession::run, this);
+}
+
+PythonSession::~PythonSession()
+{
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+    }
+    queueChanged.notify_all();
+    if (thread.joinable())
+        thread.join();
+}
+
+size_t PythonSession::loadFunction(const std::string& filePath, const std::string& funcName, const std::string& initFunc)
+{
+    ASSERT_LOG(bfs::is_regular_file(filePath), "Python script not found [" + filePath + "]");
+    size_t function = 0;
+    Task task;
+    task.job = [&]()
+    {
+        if (scripts.find(filePath) == scripts.end()) {
+            // script directory made importable for its own modules, executed once in a dedicated namespace
+            bp::import("sys").attr("path").attr("insert")(0, bfs::path(filePath).parent_path().string());
+            bp::dict globals;
+            globals["__builtins__"] = bp::import("__main__").attr("__dict__")["__builtins__"];
+            globals["__file__"] = filePath;
+            globals["__name__"] = bfs::path(filePath).stem().string();
+            bp::exec_file(filePath.c_str(), globals, globals);
+            if (!initFunc.empty())
+                globals[initFunc]();
+            scripts[filePath] = globals;
+        }
+        function = functions.size();
+        functions.push_back(scripts[filePath][funcName]);
+    };
+    submit(task);
+    ASSERT_LOG(task.error.empty(), "Load of Python function '" + funcName + "' failed [" + filePath + "]: " + task.error);
+    return function;
+}
+
+cv::Mat PythonSession::call(size_t function, const cv::Mat& input)
+{
+    Task task;
+    task.function = function;
+    task.input = &input;
+    submit(task);
+    ASSERT_LOG(task.error.empty(), "Python function call failed: " + task.error);
+    return task.output;
+}
+
+void PythonSession::submit(Task& task)
+{
+    std::unique_lock<std::mutex> lock(queueMutex);
+    ASSERT_LOG(!stopping, "Python session already stopped");
+    pending.push_back(&task);
+    queueChanged.notify_all();
+    queueChanged.wait(lock, [&task] { return task.done; });
+}
+
+void PythonSession::run()
+{
+    std::unique_lock<std::mutex> lock(queueMutex);
+    while (true)
+    {
+        queueChanged.wait(lock, [this] { return stopping || !pending.empty(); });
+        if (pending.empty())
+            break;
+
+        // GIL only held while executing the calls gathered meanwhile
+        std::vector<Task*> batch(pending.begin(), pending.end());
+        pending.clear();
+        lock.unlock();
+        PyGILState_STATE gil = PyGILState_Ensure();
+        execute(batch);
+        PyGILState_Release(gil);
+        lock.lock();
+        for (size_t t = 0; t < batch.size(); ++t)
+            batch[t]->done = true;
+        queueChanged.notify_all();
+    }
+
+    // python objects released with the GIL before interpreter finalization
+    lock.unlock();
+    PyGILState_STATE gil = PyGILState_Ensure();
+    functions.clear();
+    scripts.clear();
+    numpy = bp::object();
+    PyGILState_Release(gil);
+}
+
+void PythonSession::execute(const std::vector<Task*>& batch)
+{
+    if (numpy.is_none())
+        numpy = bp::import("numpy");
+
+    for (size_t t = 0; t < batch.size(); ++t)
+    {
+        Task* task = batch[t];
+        try {
+            if (task->job)
+                task->job();
+            else
+                task->output = toMat(functions[task->function](wrapMat(*task->input)));
+        }
+        catch (const bp::error_already_set&) {
+            task->error = fetchError();
+        }
+        catch (const std::exception& e) {
+            task->error = e.what();
+        }
+    }
+}
+
+bp::object PythonSession::wrapMat(const cv::Mat& mat)
+{
+    // read-only view over the matrix memory, strides preserve sub-matrix (ROI) layout without copy
+    static const char* dtypes[] = { "uint8", "int8", "uint16", "int16", "int32", "float32", "float64" };
+    ASSERT_LOG(mat.dims == 2 && mat.depth() < 7, "Unsupported matrix format for Python transfer");
+    size_t bytes = mat.rows > 0 ? mat.step[0] * (mat.rows - 1) + mat.cols * mat.elemSize() : 0;
+    #if PY_MAJOR_VERSION >= 3
+    PyObject* buffer = PyMemoryView_FromMemory((char*)mat.data, (Py_ssize_t)bytes, PyBUF_READ);
+    #else
+    PyObject* buffer = PyBuffer_FromMemory((void*)mat.data, (Py_ssize_t)bytes);
+    #endif
+    bp::object flat = numpy.attr("frombuffer")(bp::object(bp::handle<>(buffer)), dtypes[mat.depth()]);
+    bp::tuple shape = mat.channels() > 1 ? bp::make_tuple(mat.rows, mat.cols, mat.channels()) : bp::make_tuple(mat.rows, mat.cols);
+    bp::tuple strides = mat.channels() > 1 ? bp::make_tuple(mat.step[0], mat.elemSize(), mat.elemSize1())
+                                           : bp::make_tuple(mat.step[0], mat.elemSize());
+    return bp::import("numpy.lib.stride_tricks").attr("as_strided")(flat, shape, strides);
+}
+
+cv::Mat PythonSession::toMat(const bp::object& result)
+{
+    // any array-like result (array, list, scalar) as contiguous float64, copied out of python memory
+    bp::object array = numpy.attr("ascontiguousarray")(result, "float64");
+    Py_buffer view;
+    if (PyObject_GetBuffer(array.ptr(), &view, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) != 0)
+        bp::throw_error_already_set();
+    int count = (int)(view.len / sizeof(double));
+    int rows = view.ndim >= 2 ? (int)view.shape[0] : 1;
+    cv::Mat values = count > 0 ? cv::Mat(rows, count / rows, CV_64F, view.buf).clone() : cv::Mat();
+    PyBuffer_Release(&view);
+    return values;
+}
+
+std::string PythonSession::fetchError()
+{
+    PyObject *type, *value, *traceback;
+    PyErr_Fetch(&type, &value, &traceback);
+    std::string message = "unknown error";
+    if (value) {
+        bp::object text(bp::handle<>(PyObject_Str(value)));
+        message = bp::extract<std::string>(text);
+    }
+    Py_XDECREF(type);
+    Py_XDECREF(value);
+    Py_XDECREF(traceback);
+    return message;
+}
+
+#endif/*FACE_RECOG_HAS_PYTHON*/
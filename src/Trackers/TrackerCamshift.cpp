@@ -3,7 +3,7 @@
 #include "Trackers/TrackerCamshift.h"
 #include "FaceRecog.h"
 
-TrackerCamshift::TrackerCamshift(ConfigFile* configFile)
+TrackerCamshift::TrackerCamshift(const ConfigFile* configFile)
 {
     m_initialized = false;
     updateConfig(configFile);
@@ -56,13 +56,22 @@ void TrackerCamshift::initialize(const ImageRep& image, FloatRect bb)
 
 cv::Rect TrackerCamshift::track(const ImageRep& image)
 {
-    FACE_RECOG_MAT backProjFrame, hsvFrame;
-    FACE_RECOG_NAMESPACE::cvtColor(image.getColourImage(), hsvFrame, CV_BGR2HSV);
+    // HSV frame is shared by all tracks, only the search window around the track is back-projected
+    cv::Rect bbox = m_bb.toCvRect();
+    int padX = (int)(bbox.width * (searchWindowScale - 1) / 2);
+    int padY = (int)(bbox.height * (searchWindowScale - 1) / 2);
+    cv::Rect window(bbox.x - padX, bbox.y - padY, bbox.width + 2 * padX, bbox.height + 2 * padY);
+    window &= cv::Rect(0, 0, image.getColourImage().cols, image.getColourImage().rows);
+    image.backProject(window, channels, roi_hist, ranges, backProjWindow);
 
-    cv::calcBackProject(&GET_MAT(hsvFrame, ACCESS_READ), 1, channels, roi_hist, backProjFrame, ranges);
-    cv::RotatedRect rotRec = cv::CamShift(backProjFrame, m_bb.toCvRect(), term_crit);
+    cv::Rect localBox = (bbox - window.tl()) & cv::Rect(cv::Point(0, 0), window.size());
+    if (backProjWindow.empty() || localBox.area() == 0)
+        return rectInsideFrame(image.getColourImage(), bbox);
+    cv::RotatedRect rotRec = cv::CamShift(backProjWindow, localBox, term_crit);
 
-    return rectInsideFrame(image.getColourImage(), rotRec.boundingRect());
+    cv::Rect found = rectInsideFrame(image.getColourImage(), rotRec.boundingRect() + window.tl());
+    m_bb = FloatRect((float)found.x, (float)found.y, (float)found.width, (float)found.height);
+    return found;
 }
 
 cv::Rect TrackerCamshift::rectInsideFrame(const FACE_RECOG_MAT& frame, cv::Rect rect)
@@ -2,9 +2,10 @@
 
 #include "Trackers/TrackerCompressive.h"
 #include "FaceRecog.h"
+#include <opencv2/core/hal/intrin.hpp>
 
-TrackerCompressive::TrackerCompressive(ConfigFile* configFile) :
-    m_initialized(false)
+TrackerCompressive::TrackerCompressive(const ConfigFile* configFile) :
+    cornerStep(0)
 {
     updateConfig(configFile);
     featureMinNumRect = 2;
@@ -12,306 +13,329 @@ TrackerCompressive::TrackerCompressive(ConfigFile* configFile) :
     featureNum = 50;    // number of all weaker classifiers, i.e,feature pool
     rOuterPositive = 4; // radical scope of positive samples
     rSearchWindow = 25; // size of search window
-    muPositive = vector<float>(featureNum, 0.0f);
-    muNegative = vector<float>(featureNum, 0.0f);
-    sigmaPositive = vector<float>(featureNum, 1.0f);
-    sigmaNegative = vector<float>(featureNum, 1.0f);
     learnRate = 0.85f;  // Learning rate parameter
+
+    // detection in disk of search window, positives in small disk, negatives on a sparse grid of the surrounding annulus
+    buildDiskGrid((float)rSearchWindow, 0.0f, 1, detectGrid);
+    buildDiskGrid((float)rOuterPositive, 0.0f, 1, positiveGrid);
+    buildDiskGrid(rSearchWindow * 1.5f, rOuterPositive + 4.0f, 7, negativeGrid);
+    TrackerCompressive::reset();
 }
 
 TrackerCompressive::TrackerCompressive(const TrackerCompressive &obj)
 {
+    copyState(obj);
+}
+
+TrackerCompressive & TrackerCompressive::operator=(const TrackerCompressive &obj)
+{
+    // check for "self assignment" and do nothing in that case
+    if (this != &obj)
+        copyState(obj);
+    return *this;
+}
+
+TrackerCompressive::~TrackerCompressive() { }
+
+void TrackerCompressive::copyState(const TrackerCompressive& obj)
+{
+    this->m_config = obj.m_config;
     this->m_initialized = obj.m_initialized;
+    this->m_bb = obj.m_bb;
+    this->bbox = obj.bbox;
     this->featureMinNumRect = obj.featureMinNumRect;
     this->featureMaxNumRect = obj.featureMaxNumRect;
     this->featureNum = obj.featureNum;
     this->rOuterPositive = obj.rOuterPositive;
     this->rSearchWindow = obj.rSearchWindow;
+    this->learnRate = obj.learnRate;
+    this->rng = obj.rng;
+    this->featureRects = obj.featureRects;
+    this->featureRectWeights = obj.featureRectWeights;
+    this->featureRectStart = obj.featureRectStart;
+    this->cornerOffsets = obj.cornerOffsets;
+    this->cornerStep = obj.cornerStep;
+    this->detectGrid = obj.detectGrid;
+    this->positiveGrid = obj.positiveGrid;
+    this->negativeGrid = obj.negativeGrid;
     this->muPositive = obj.muPositive;
     this->muNegative = obj.muNegative;
     this->sigmaPositive = obj.sigmaPositive;
     this->sigmaNegative = obj.sigmaNegative;
-    this->learnRate = obj.learnRate;
 }
 
-TrackerCompressive & TrackerCompressive::operator=(const TrackerCompressive &obj)
+void TrackerCompressive::reset()
 {
-  // check for "self assignment" and do nothing in that case
-    if (this == &obj) return *this;
-    else
-    {
-        this->m_initialized = obj.m_initialized;
-        this->featureMinNumRect = obj.featureMinNumRect;
-        this->featureMaxNumRect = obj.featureMaxNumRect;
-        this->featureNum = obj.featureNum;
-        this->rOuterPositive = obj.rOuterPositive;
-        this->rSearchWindow = obj.rSearchWindow;
-        this->muPositive = obj.muPositive;
-        this->muNegative = obj.muNegative;
-        this->sigmaPositive = obj.sigmaPositive;
-        this->sigmaNegative = obj.sigmaNegative;
-        this->learnRate = obj.learnRate;
-        return *this;                   // return this IntList
-    }
+    m_initialized = false;
+    bbox = cv::Rect();
+    featureRects.clear();
+    featureRectWeights.clear();
+    featureRectStart.clear();
+    cornerOffsets.clear();
+    cornerStep = 0;
+    muPositive.assign(featureNum, 0.0f);
+    muNegative.assign(featureNum, 0.0f);
+    sigmaPositive.assign(featureNum, 1.0f);
+    sigmaNegative.assign(featureNum, 1.0f);
 }
 
-TrackerCompressive::~TrackerCompressive() { }
-
-void TrackerCompressive::reset() { } // TO-DO
-
 void TrackerCompressive::initialize(const ImageRep& image, FloatRect bb)
 {
+    if (m_initialized)
+        reset();
     bbox = bb.toCvRect();
-    float fROP = (float)rOuterPositive;
-    float fRSW = (float)rSearchWindow;
+    m_bb = bb;
 
     // compute feature template
     computeHaarFeature(bbox, featureNum);
 
-    // compute sample templates
-    cv::Mat img = image.getImage();
-    sampleRect(img, bbox, fROP, 0.0f, 1000000.0f, samplePositiveBox);
-    sampleRect(img, bbox, fRSW * 1.5f, fROP + 4.0f, 100.0f, sampleNegativeBox);
-
-    integral(image.getImage(), imageIntegral, CV_32F);
-
-    getFeatureValue(imageIntegral, samplePositiveBox, samplePositiveFeatureValue);
-    getFeatureValue(imageIntegral, sampleNegativeBox, sampleNegativeFeatureValue);
-    classifierUpdate(samplePositiveFeatureValue, muPositive, sigmaPositive, learnRate);
-    classifierUpdate(sampleNegativeFeatureValue, muNegative, sigmaNegative, learnRate);
-
+    updateClassifier(getIntegral(image), image.getImage().size());
     m_initialized = true;
 }
 
-
 cv::Rect TrackerCompressive::track(const ImageRep& image)
 {
+    assert(m_initialized);
+    const cv::Mat& integral = getIntegral(image);
+    cv::Size imageSize = image.getImage().size();
+
     // predict
-    cv::Mat img = image.getImage();
-    float fROP = (float)rOuterPositive;
-    float fRSW = (float)rSearchWindow;
-    sampleRect(img, bbox, fRSW, detectBox);
-    integral(img, imageIntegral, CV_32F);
-    getFeatureValue(imageIntegral, detectBox, detectFeatureValue);
-    int radioMaxIndex;
-    float radioMax;
-    radioClassifier(muPositive, sigmaPositive, muNegative, sigmaNegative, detectFeatureValue, radioMax, radioMaxIndex);
-    bbox = detectBox[radioMaxIndex];
+    int nDetect = sampleRect(bbox, imageSize, detectGrid, detectSegments);
+    if (nDetect > 0) {
+        getFeatureValue(integral, detectSegments, nDetect, detectFeatureValue);
+        cv::Point best = samplePosition(detectSegments, radioClassifier(detectFeatureValue));
+        bbox.x = best.x;
+        bbox.y = best.y;
+    }
 
     // update
-    sampleRect(img, bbox, fROP, 0.0f, 1000000.0f, samplePositiveBox);
-    sampleRect(img, bbox, fRSW * 1.5f, fROP + 4.0f, 100.0f, sampleNegativeBox);
-
-    getFeatureValue(imageIntegral, samplePositiveBox, samplePositiveFeatureValue);
-    getFeatureValue(imageIntegral, sampleNegativeBox, sampleNegativeFeatureValue);
-    classifierUpdate(samplePositiveFeatureValue, muPositive, sigmaPositive, learnRate);
-    classifierUpdate(sampleNegativeFeatureValue, muNegative, sigmaNegative, learnRate);
-
+    updateClassifier(integral, imageSize);
+    m_bb = FloatRect((float)bbox.x, (float)bbox.y, (float)bbox.width, (float)bbox.height);
     return bbox;
 }
 
 // ================== Private Functions =====================
 
-void TrackerCompressive::computeHaarFeature(Rect& _objectBox, int _numFeature)
+// integral image shared by all trackers of the frame when available, otherwise computed for this tracker
+const cv::Mat& TrackerCompressive::getIntegral(const ImageRep& image)
+{
+    if (image.hasIntegralImage())
+        return image.getIntegralImage();
+    cv::integral(image.getImage(), imageIntegral, CV_32S);
+    return imageIntegral;
+}
+
+void TrackerCompressive::updateClassifier(const cv::Mat& integral, const cv::Size& imageSize)
+{
+    int nPositive = sampleRect(bbox, imageSize, positiveGrid, positiveSegments);
+    int nNegative = sampleRect(bbox, imageSize, negativeGrid, negativeSegments);
+    if (nPositive > 0) {
+        getFeatureValue(integral, positiveSegments, nPositive, samplePositiveFeatureValue);
+        classifierUpdate(samplePositiveFeatureValue, muPositive, sigmaPositive, learnRate);
+    }
+    if (nNegative > 0) {
+        getFeatureValue(integral, negativeSegments, nNegative, sampleNegativeFeatureValue);
+        classifierUpdate(sampleNegativeFeatureValue, muNegative, sigmaNegative, learnRate);
+    }
+}
+
+void TrackerCompressive::computeHaarFeature(const cv::Rect& objectBox, int numFeature)
 /*Description: compute Haar features
   Arguments:
-  -_objectBox: [x y width height] object rectangle
-  -_numFeature: total number of features.The default is 50.
+  -objectBox: [x y width height] object rectangle
+  -numFeature: total number of features.The default is 50.
 */
 {
-    features = vector<vector<Rect>>(_numFeature, vector<Rect>());
-    featuresWeight = vector<vector<float>>(_numFeature, vector<float>());
-
-    int numRect;
-    Rect rectTemp;
-    float weightTemp;
+    featureRects.clear();
+    featureRectWeights.clear();
+    featureRectStart.assign(1, 0);
+    cornerStep = 0;
 
-    for (int i = 0; i < _numFeature; i++)
+    for (int i = 0; i < numFeature; i++)
     {
-        numRect = cvFloor(rng.uniform((double)featureMinNumRect, (double)featureMaxNumRect));
-
+        int numRect = cvFloor(rng.uniform((double)featureMinNumRect, (double)featureMaxNumRect));
         for (int j = 0; j < numRect; j++)
         {
-
-            rectTemp.x = cvFloor(rng.uniform(0.0, (double)(_objectBox.width - 3)));
-            rectTemp.y = cvFloor(rng.uniform(0.0, (double)(_objectBox.height - 3)));
-            rectTemp.width = cvCeil(rng.uniform(0.0, (double)(_objectBox.width - rectTemp.x - 2)));
-            rectTemp.height = cvCeil(rng.uniform(0.0, (double)(_objectBox.height - rectTemp.y - 2)));
-            features[i].push_back(rectTemp);
-
-            weightTemp = (float)pow(-1.0, cvFloor(rng.uniform(0.0, 2.0))) / sqrt(float(numRect));
-            featuresWeight[i].push_back(weightTemp);
-
+            cv::Rect rectTemp;
+            rectTemp.x = cvFloor(rng.uniform(0.0, (double)(objectBox.width - 3)));
+            rectTemp.y = cvFloor(rng.uniform(0.0, (double)(objectBox.height - 3)));
+            rectTemp.width = cvCeil(rng.uniform(0.0, (double)(objectBox.width - rectTemp.x - 2)));
+            rectTemp.height = cvCeil(rng.uniform(0.0, (double)(objectBox.height - rectTemp.y - 2)));
+            featureRects.push_back(rectTemp);
+            featureRectWeights.push_back((float)pow(-1.0, cvFloor(rng.uniform(0.0, 2.0))) / sqrt(float(numRect)));
         }
+        featureRectStart.push_back((int)featureRects.size());
     }
 }
 
-
-void TrackerCompressive::sampleRect(const Mat& _image, Rect& _objectBox, float _rInner, float _rOuter, int _maxSampleNum, vector<Rect>& _sampleBox)
-/* Description: compute the coordinate of positive and negative sample image templates
+void TrackerCompressive::buildDiskGrid(float rInner, float rOuter, int step, std::vector<SampleSpan>& grid)
+/* Description: offsets of samples at distance in [rOuter, rInner[ of the object position
    Arguments:
-   -_image:        processing frame
-   -_objectBox:    recent object position
-   -_rInner:       inner sampling radius
-   -_rOuter:       Outer sampling radius
-   -_maxSampleNum: maximal number of sampled images
-   -_sampleBox:    Storing the rectangle coordinates of the sampled images.
+   -rInner:     inner sampling radius (exclusive)
+   -rOuter:     outer sampling radius (inclusive), excluded center area
+   -step:       spacing of sampled offsets, spans of single offsets when greater than 1
+   -grid:       row spans of sampled offsets
 */
 {
-    int rowsz = _image.rows - _objectBox.height - 1;
-    int colsz = _image.cols - _objectBox.width - 1;
-    float inradsq = _rInner*_rInner;
-    float outradsq = _rOuter*_rOuter;
-    int minrow = max(0, (int)_objectBox.y - (int)_rInner);
-    int maxrow = min((int)rowsz - 1, (int)_objectBox.y + (int)_rInner);
-    int mincol = max(0, (int)_objectBox.x - (int)_rInner);
-    int maxcol = min((int)colsz - 1, (int)_objectBox.x + (int)_rInner);
-    int i = 0;
-    float prob = ((float)(_maxSampleNum)) / (maxrow - minrow + 1) / (maxcol - mincol + 1);
-    int r, c, dist;
-
-    _sampleBox.clear();//important
-    Rect rec(0, 0, 0, 0);
-
-    for (r = minrow; r <= (int)maxrow; r++) {
-        for (c = mincol; c <= (int)maxcol; c++) {
-            dist = (_objectBox.y - r)*(_objectBox.y - r) + (_objectBox.x - c)*(_objectBox.x - c);
-
-            if (rng.uniform(0., 1.) < prob && dist < inradsq && dist >= outradsq) {
-
-                rec.x = c;
-                rec.y = r;
-                rec.width = _objectBox.width;
-                rec.height = _objectBox.height;
-
-                _sampleBox.push_back(rec);
-
-                i++;
+    grid.clear();
+    float inradsq = rInner * rInner;
+    float outradsq = rOuter * rOuter;
+    int r = (int)rInner;
+    for (int dy = -r; dy <= r; dy += step)
+    {
+        SampleSpan span = { dy, 0, -1 };
+        for (int dx = -r; dx <= r; dx += step)
+        {
+            int dist = dy * dy + dx * dx;
+            bool inside = dist < inradsq && dist >= outradsq;
+            if (inside && step == 1 && span.dxMax >= span.dxMin && span.dxMax == dx - 1) {
+                span.dxMax = dx;
+                continue;
             }
+            if (span.dxMax >= span.dxMin)
+                grid.push_back(span);
+            span = inside ? SampleSpan{ dy, dx, dx } : SampleSpan{ dy, 0, -1 };
         }
+        if (span.dxMax >= span.dxMin)
+            grid.push_back(span);
     }
-    _sampleBox.resize(i);
 }
 
-void TrackerCompressive::sampleRect(const Mat& _image, Rect& _objectBox, float _srw, vector<Rect>& _sampleBox)
-/* Description: Compute the coordinate of samples when detecting the object.*/
+int TrackerCompressive::sampleRect(const cv::Rect& objectBox, const cv::Size& imageSize, const std::vector<SampleSpan>& grid,
+                                   std::vector<SampleSegment>& segments)
+/* Description: segments of grid samples with boxes completely inside the frame, returns the number of samples */
 {
-    int rowsz = _image.rows - _objectBox.height - 1;
-    int colsz = _image.cols - _objectBox.width - 1;
-    float inradsq = _srw*_srw;
-
-
-    int dist;
-
-    int minrow = max(0, (int)_objectBox.y - (int)_srw);
-    int maxrow = min((int)rowsz - 1, (int)_objectBox.y + (int)_srw);
-    int mincol = max(0, (int)_objectBox.x - (int)_srw);
-    int maxcol = min((int)colsz - 1, (int)_objectBox.x + (int)_srw);
-
-    int i = 0;
-
-    int r;
-    int c;
-
-    Rect rec(0, 0, 0, 0);
-    _sampleBox.clear();//important
-
-    for (r = minrow; r <= (int)maxrow; r++)
-        for (c = mincol; c <= (int)maxcol; c++) {
-            dist = (_objectBox.y - r)*(_objectBox.y - r) + (_objectBox.x - c)*(_objectBox.x - c);
-
-            if (dist < inradsq) {
-
-                rec.x = c;
-                rec.y = r;
-                rec.width = _objectBox.width;
-                rec.height = _objectBox.height;
-
-                _sampleBox.push_back(rec);
-
-                i++;
-            }
-        }
-
-    _sampleBox.resize(i);
+    int maxX = imageSize.width - objectBox.width - 1;
+    int maxY = imageSize.height - objectBox.height - 1;
+    int count = 0;
+    segments.clear();
+    for (size_t s = 0; s < grid.size(); ++s)
+    {
+        int y = objectBox.y + grid[s].dy;
+        if (y < 0 || y > maxY)
+            continue;
+        int xMin = std::max(objectBox.x + grid[s].dxMin, 0);
+        int xMax = std::min(objectBox.x + grid[s].dxMax, maxX);
+        if (xMax < xMin)
+            continue;
+        SampleSegment segment = { xMin, y, xMax - xMin + 1, count };
+        segments.push_back(segment);
+        count += segment.count;
+    }
+    return count;
+}
 
+cv::Point TrackerCompressive::samplePosition(const std::vector<SampleSegment>& segments, int index) const
+{
+    for (size_t s = 0; s < segments.size(); ++s)
+        if (index < segments[s].start + segments[s].count)
+            return cv::Point(segments[s].x + index - segments[s].start, segments[s].y);
+    return bbox.tl();
 }
-// Compute the features of samples
-void TrackerCompressive::getFeatureValue(Mat& _imageIntegral, vector<Rect>& _sampleBox, Mat& _sampleFeatureValue)
+
+// Compute the features of samples, responses of consecutive samples are accumulated together
+void TrackerCompressive::getFeatureValue(const cv::Mat& integral, const std::vector<SampleSegment>& segments, int sampleCount,
+                                         cv::Mat& sampleFeatureValue)
 {
-    int sampleBoxSize = (int)_sampleBox.size();
-    _sampleFeatureValue.create(featureNum, sampleBoxSize, CV_32F);
-    float tempValue;
-    int xMin;
-    int xMax;
-    int yMin;
-    int yMax;
+    // corner offsets only depend on the integral image row step
+    size_t step = integral.step1();
+    if (cornerStep != step) {
+        cornerOffsets.resize(featureRects.size() * 4);
+        for (size_t k = 0; k < featureRects.size(); ++k) {
+            const cv::Rect& r = featureRects[k];
+            cornerOffsets[4 * k + 0] = (int)(r.y * step + r.x);
+            cornerOffsets[4 * k + 1] = (int)(r.y * step + r.x + r.width);
+            cornerOffsets[4 * k + 2] = (int)((r.y + r.height) * step + r.x);
+            cornerOffsets[4 * k + 3] = (int)((r.y + r.height) * step + r.x + r.width);
+        }
+        cornerStep = step;
+    }
 
-    for (int i = 0; i < featureNum; i++)
+    sampleFeatureValue.create(featureNum, sampleCount, CV_32F);
+    sampleFeatureValue.setTo(0);
+    for (size_t s = 0; s < segments.size(); ++s)
     {
-        for (int j = 0; j < sampleBoxSize; j++)
+        const int* base = integral.ptr<int>(segments[s].y) + segments[s].x;
+        int count = segments[s].count;
+        for (int i = 0; i < featureNum; i++)
         {
-            tempValue = 0.0f;
-            for (size_t k = 0; k < features[i].size(); k++)
+            float* values = sampleFeatureValue.ptr<float>(i) + segments[s].start;
+            for (int k = featureRectStart[i]; k < featureRectStart[i + 1]; k++)
             {
-                xMin = _sampleBox[j].x + features[i][k].x;
-                xMax = _sampleBox[j].x + features[i][k].x + features[i][k].width;
-                yMin = _sampleBox[j].y + features[i][k].y;
-                yMax = _sampleBox[j].y + features[i][k].y + features[i][k].height;
-                tempValue += featuresWeight[i][k] *
-                    (_imageIntegral.at<float>(yMin, xMin) +
-                    _imageIntegral.at<float>(yMax, xMax) -
-                    _imageIntegral.at<float>(yMin, xMax) -
-                    _imageIntegral.at<float>(yMax, xMin));
+                const int* tl = base + cornerOffsets[4 * k + 0];
+                const int* tr = base + cornerOffsets[4 * k + 1];
+                const int* bl = base + cornerOffsets[4 * k + 2];
+                const int* br = base + cornerOffsets[4 * k + 3];
+                float weight = featureRectWeights[k];
+                int j = 0;
+                #if CV_SIMD128
+                cv::v_float32x4 vWeight = cv::v_setall_f32(weight);
+                for (; j <= count - 4; j += 4) {
+                    cv::v_int32x4 sum = cv::v_load(tl + j) + cv::v_load(br + j) - cv::v_load(tr + j) - cv::v_load(bl + j);
+                    cv::v_store(values + j, cv::v_load(values + j) + vWeight * cv::v_cvt_f32(sum));
+                }
+                #endif
+                for (; j < count; j++)
+                    values[j] += weight * (float)(tl[j] + br[j] - tr[j] - bl[j]);
             }
-            _sampleFeatureValue.at<float>(i, j) = tempValue;
         }
     }
 }
 
 // Update the mean and variance of the gaussian classifier
-void TrackerCompressive::classifierUpdate(Mat& _sampleFeatureValue, vector<float>& _mu, vector<float>& _sigma, float _learnRate)
+void TrackerCompressive::classifierUpdate(const cv::Mat& sampleFeatureValue, std::vector<float>& mu, std::vector<float>& sigma, float rate)
 {
-    Scalar muTemp;
-    Scalar sigmaTemp;
+    cv::Scalar muTemp;
+    cv::Scalar sigmaTemp;
 
     for (int i = 0; i < featureNum; i++)
     {
-        meanStdDev(_sampleFeatureValue.row(i), muTemp, sigmaTemp);
+        cv::meanStdDev(sampleFeatureValue.row(i), muTemp, sigmaTemp);
 
         // equation 6 in paper
-        _sigma[i] = (float)sqrt(_learnRate*_sigma[i] * _sigma[i] + (1.0f - _learnRate)*sigmaTemp.val[0] * sigmaTemp.val[0] +
-                                _learnRate*(1.0f - _learnRate)*(_mu[i] - muTemp.val[0])*(_mu[i] - muTemp.val[0]));
-        _mu[i] = _mu[i] * _learnRate + (1.0f - _learnRate)*muTemp.val[0];
+        sigma[i] = (float)sqrt(rate*sigma[i] * sigma[i] + (1.0f - rate)*sigmaTemp.val[0] * sigmaTemp.val[0] +
+                               rate*(1.0f - rate)*(mu[i] - muTemp.val[0])*(mu[i] - muTemp.val[0]));
+        mu[i] = (float)(mu[i] * rate + (1.0f - rate)*muTemp.val[0]);
     }
 }
 
-// Compute the ratio classifier
-void TrackerCompressive::radioClassifier(vector<float>& _muPos, vector<float>& _sigmaPos, vector<float>& _muNeg, vector<float>& _sigmaNeg,
-                                         Mat& _sampleFeatureValue, float& _radioMax, int& _radioMaxIndex)
+/*
+    Compute the ratio classifier (equation 4 in paper), returns the index of the best sample
+    Log-likelihoods of the gaussians are expanded to avoid exponentials and logarithms per sample:
+        log(pPos/pNeg) = (v-muNeg)^2 / (2*sigmaNeg^2) - (v-muPos)^2 / (2*sigmaPos^2) + log(sigmaNeg/sigmaPos)
+    The last term is the same for every sample and does not change the best one, it is not computed.
+*/
+int TrackerCompressive::radioClassifier(const cv::Mat& sampleFeatureValue)
 {
-    float sumRadio;
-    _radioMax = -FLT_MAX;
-    _radioMaxIndex = 0;
-    float pPos;
-    float pNeg;
-    int sampleBoxNum = _sampleFeatureValue.cols;
-
-    for (int j = 0; j < sampleBoxNum; j++)
+    int sampleCount = sampleFeatureValue.cols;
+    sampleScores.create(1, sampleCount, CV_32F);
+    sampleScores.setTo(0);
+    float* scores = sampleScores.ptr<float>();
+    for (int i = 0; i < featureNum; i++)
     {
-        sumRadio = 0.0f;
-        for (int i = 0; i < featureNum; i++)
-        {
-            pPos = exp((_sampleFeatureValue.at<float>(i, j) - _muPos[i])*(_sampleFeatureValue.at<float>(i, j) - _muPos[i]) / -(2.0f*_sigmaPos[i] * _sigmaPos[i] + 1e-30)) / (_sigmaPos[i] + 1e-30);
-            pNeg = exp((_sampleFeatureValue.at<float>(i, j) - _muNeg[i])*(_sampleFeatureValue.at<float>(i, j) - _muNeg[i]) / -(2.0f*_sigmaNeg[i] * _sigmaNeg[i] + 1e-30)) / (_sigmaNeg[i] + 1e-30);
-            sumRadio += log(pPos + 1e-30) - log(pNeg + 1e-30);  // equation 4
+        float muPos = muPositive[i], muNeg = muNegative[i];
+        float weightPos = -1.0f / (2.0f * sigmaPositive[i] * sigmaPositive[i] + 1e-30f);
+        float weightNeg = 1.0f / (2.0f * sigmaNegative[i] * sigmaNegative[i] + 1e-30f);
+        const float* values = sampleFeatureValue.ptr<float>(i);
+        int j = 0;
+        #if CV_SIMD128
+        cv::v_float32x4 vMuPos = cv::v_setall_f32(muPos), vMuNeg = cv::v_setall_f32(muNeg);
+        cv::v_float32x4 vWeightPos = cv::v_setall_f32(weightPos), vWeightNeg = cv::v_setall_f32(weightNeg);
+        for (; j <= sampleCount - 4; j += 4) {
+            cv::v_float32x4 v = cv::v_load(values + j);
+            cv::v_float32x4 dPos = v - vMuPos, dNeg = v - vMuNeg;
+            cv::v_store(scores + j, cv::v_load(scores + j) + vWeightPos * dPos * dPos + vWeightNeg * dNeg * dNeg);
         }
-        if (_radioMax < sumRadio)
-        {
-            _radioMax = sumRadio;
-            _radioMaxIndex = j;
+        #endif
+        for (; j < sampleCount; j++) {
+            float dPos = values[j] - muPos, dNeg = values[j] - muNeg;
+            scores[j] += weightPos * dPos * dPos + weightNeg * dNeg * dNeg;
         }
     }
+
+    cv::Point maxLoc;
+    cv::minMaxLoc(sampleScores, NULL, NULL, NULL, &maxLoc);
+    return maxLoc.x;
 }
 
 #endif/*FACE_RECOG_HAS_COMPRESSIVE*/
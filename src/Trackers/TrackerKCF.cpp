@@ -2,27 +2,65 @@
 
 #include "Trackers/TrackerKCF.h"
 #include "FaceRecog.h"
+#include <mutex>
+#include <tuple>
 
-TrackerKCF::TrackerKCF(ConfigFile* configFile) :
-    isInitialized(false)
+static const int kHogBins = 9;
+static const double kScaleWeight = 0.95;    // favours the current scale over the other evaluated ones
+
+// complex division (out = num / (den + lambda)) of full complex spectra
+static void divideSpectrums(const cv::Mat& num, const cv::Mat& den, double lambda, cv::Mat& out)
 {
+    out.create(num.size(), CV_32FC2);
+    for (int y = 0; y < num.rows; ++y)
+    {
+        const cv::Vec2f* n = num.ptr<cv::Vec2f>(y);
+        const cv::Vec2f* d = den.ptr<cv::Vec2f>(y);
+        cv::Vec2f* o = out.ptr<cv::Vec2f>(y);
+        for (int x = 0; x < num.cols; ++x)
+        {
+            float re = d[x][0] + (float)lambda, im = d[x][1];
+            float inv = 1.0f / (re * re + im * im);
+            o[x][0] = (n[x][0] * re + n[x][1] * im) * inv;
+            o[x][1] = (n[x][1] * re - n[x][0] * im) * inv;
+        }
+    }
+}
+
+// parabolic interpolation of the peak position between its neighbours
+static float subPixelPeak(float left, float center, float right)
+{
+    float divisor = 2 * center - right - left;
+    return divisor == 0 ? 0 : 0.5f * (right - left) / divisor;
+}
+
+TrackerKCF::TrackerKCF(const ConfigFile* configFile)
+{
+    m_initialized = false;
     updateConfig(configFile);
+    useHOG = m_config->kcfUseHOG;
+    templateSize = m_config->kcfTemplateSize;
+    padding = m_config->kcfPadding;
+    scaleStep = m_config->kcfScaleStep;
+    cellSize = useHOG ? 4 : 1;
+    interpFactor = useHOG ? 0.012 : 0.075;
+    sigma = useHOG ? 0.6 : 0.2;
+    lambda = 0.0001;
+    outputSigmaFactor = useHOG ? 0.1 : 0.125;
     TrackerKCF::reset();
 }
 
-TrackerKCF::TrackerKCF(const TrackerKCF &obj) :
-    isInitialized(false)
+TrackerKCF::TrackerKCF(const TrackerKCF &obj)
 {
-
+    copyModel(obj);
 }
 
 TrackerKCF & TrackerKCF::operator=(const TrackerKCF &obj)
 {
     // check for "self assignment" and do nothing in that case
-    if (this == &obj)
-        return *this;
-    else
-        return *this;   // return this IntList
+    if (this != &obj)
+        copyModel(obj);
+    return *this;
 }
 
 TrackerKCF::~TrackerKCF()
@@ -30,32 +68,273 @@ TrackerKCF::~TrackerKCF()
 
 }
 
+// copy of parameters, target state and learned model, working buffers are not shared
+void TrackerKCF::copyModel(const TrackerKCF& obj)
+{
+    m_config = obj.m_config;
+    m_initialized = obj.m_initialized;
+    m_bb = obj.m_bb;
+    useHOG = obj.useHOG;
+    cellSize = obj.cellSize;
+    templateSize = obj.templateSize;
+    padding = obj.padding;
+    scaleStep = obj.scaleStep;
+    interpFactor = obj.interpFactor;
+    sigma = obj.sigma;
+    lambda = obj.lambda;
+    outputSigmaFactor = obj.outputSigmaFactor;
+    center = obj.center;
+    targetSize = obj.targetSize;
+    currentScale = obj.currentScale;
+    templateScale = obj.templateScale;
+    templateSz = obj.templateSz;
+    plan = obj.plan;
+    modelNorm = obj.modelNorm;
+    alphaf = obj.alphaf.clone();
+    modelFeatures.resize(obj.modelFeatures.size());
+    modelSpectra.resize(obj.modelSpectra.size());
+    for (size_t c = 0; c < obj.modelFeatures.size(); ++c)
+        modelFeatures[c] = obj.modelFeatures[c].clone();
+    for (size_t c = 0; c < obj.modelSpectra.size(); ++c)
+        modelSpectra[c] = obj.modelSpectra[c].clone();
+}
+
 void TrackerKCF::reset()
 {
+    m_initialized = false;
+    currentScale = 1;
+    modelNorm = 0;
+    modelFeatures.clear();
+    modelSpectra.clear();
+    alphaf.release();
+    plan.reset();
+}
+
+// window plans are created once for every feature size and label sigma, shared by all tracks
+std::shared_ptr<const KCFWindowPlan> TrackerKCF::getPlan(const cv::Size& size, double outputSigma)
+{
+    static std::mutex plansMutex;
+    static std::map<std::tuple<int, int, double>, std::shared_ptr<const KCFWindowPlan> > plans;
+    std::lock_guard<std::mutex> lock(plansMutex);
+    std::shared_ptr<const KCFWindowPlan>& plan = plans[std::make_tuple(size.width, size.height, outputSigma)];
+    if (plan)
+        return plan;
 
+    std::shared_ptr<KCFWindowPlan> newPlan = std::make_shared<KCFWindowPlan>();
+    newPlan->size = size;
+    cv::createHanningWindow(newPlan->hann, size, CV_32F);
+    cv::Mat label(size, CV_32F);
+    float mult = (float)(-0.5 / (outputSigma * outputSigma));
+    int cy = size.height / 2, cx = size.width / 2;
+    for (int y = 0; y < size.height; ++y)
+    {
+        float* row = label.ptr<float>(y);
+        for (int x = 0; x < size.width; ++x)
+            row[x] = std::exp(mult * (float)((y - cy) * (y - cy) + (x - cx) * (x - cx)));
+    }
+    cv::dft(label, newPlan->labelSpectrum, cv::DFT_COMPLEX_OUTPUT);
+    plan = newPlan;
+    return plan;
 }
 
 void TrackerKCF::initialize(const ImageRep& image, FloatRect bb)
 {
-    if (isInitialized)
+    if (m_initialized)
         reset();
 
-    isInitialized = true;
-}
+    center = cv::Point2f(bb.xmin() + bb.width() / 2, bb.ymin() + bb.height() / 2);
+    targetSize = cv::Size2f(bb.width(), bb.height());
+    currentScale = 1;
+
+    // padded window scaled to the template size, feature size rounded up to an efficient DFT size
+    double paddedW = bb.width() * padding, paddedH = bb.height() * padding;
+    templateScale = std::max(paddedW, paddedH) / (double)templateSize;
+    int featW = std::max((int)(paddedW / templateScale) / cellSize, 4);
+    int featH = std::max((int)(paddedH / templateScale) / cellSize, 4);
+    cv::Size featureSize(cv::getOptimalDFTSize(featW), cv::getOptimalDFTSize(featH));
+    templateSz = cv::Size(featureSize.width * cellSize, featureSize.height * cellSize);
+    double outputSigma = std::sqrt((double)featureSize.area()) / padding * outputSigmaFactor;
+    plan = getPlan(featureSize, outputSigma);
 
+    updateLearner(image, 1.0);
+    m_bb = bb;
+    m_initialized = true;
+}
 
 cv::Rect TrackerKCF::track(const ImageRep& image)
 {
-    assert(isInitialized);
+    assert(m_initialized);
+
+    cv::Point2f displacement;
+    double bestScale = currentScale;
+    double bestPeak = detect(image, currentScale, displacement);
+    if (scaleStep > 1)
+    {
+        double scales[2] = { currentScale / scaleStep, currentScale * scaleStep };
+        for (int s = 0; s < 2; ++s) {
+            cv::Point2f scaleDisplacement;
+            double peak = kScaleWeight * detect(image, scales[s], scaleDisplacement);
+            if (peak > bestPeak) {
+                bestPeak = peak;
+                bestScale = scales[s];
+                displacement = scaleDisplacement;
+            }
+        }
+    }
+
+    const IntRect& frameRect = image.getRect();
+    center += displacement;
+    center.x = std::min(std::max(center.x, (float)frameRect.xmin()), (float)frameRect.xmax() - 1);
+    center.y = std::min(std::max(center.y, (float)frameRect.ymin()), (float)frameRect.ymax() - 1);
+    currentScale = bestScale;
+    updateLearner(image, interpFactor);
+
+    float w = (float)(targetSize.width * currentScale), h = (float)(targetSize.height * currentScale);
+    m_bb = FloatRect(center.x - w / 2, center.y - h / 2, w, h);
+    return cv::Rect((int)m_bb.xmin(), (int)m_bb.ymin(), (int)m_bb.width(), (int)m_bb.height());
+}
+
+// peak response of the model correlated with the window at the given scale, displacement of the peak in frame pixels
+double TrackerKCF::detect(const ImageRep& image, double scale, cv::Point2f& displacement)
+{
+    double norm;
+    extractFeatures(image.getImage(), scale, features);
+    computeSpectra(features, spectra, norm);
+    gaussianCorrelation(spectra, norm, modelSpectra, modelNorm, kernelSpectrum);
+    cv::mulSpectrums(alphaf, kernelSpectrum, responseSpectrum, 0, false);
+    cv::dft(responseSpectrum, response, cv::DFT_INVERSE | cv::DFT_SCALE | cv::DFT_REAL_OUTPUT);
+
+    double peakValue;
+    cv::Point peakLoc;
+    cv::minMaxLoc(response, NULL, &peakValue, NULL, &peakLoc);
+    cv::Point2f peak((float)peakLoc.x, (float)peakLoc.y);
+    if (peakLoc.x > 0 && peakLoc.x < response.cols - 1)
+        peak.x += subPixelPeak(response.at<float>(peakLoc.y, peakLoc.x - 1), (float)peakValue, response.at<float>(peakLoc.y, peakLoc.x + 1));
+    if (peakLoc.y > 0 && peakLoc.y < response.rows - 1)
+        peak.y += subPixelPeak(response.at<float>(peakLoc.y - 1, peakLoc.x), (float)peakValue, response.at<float>(peakLoc.y + 1, peakLoc.x));
+
+    float pixelsPerCell = (float)(cellSize * templateScale * scale);
+    displacement.x = (peak.x - response.cols / 2) * pixelsPerCell;
+    displacement.y = (peak.y - response.rows / 2) * pixelsPerCell;
+    return peakValue;
+}
+
+void TrackerKCF::updateLearner(const ImageRep& image, double rate)
+{
+    double norm;
+    extractFeatures(image.getImage(), currentScale, features);
+    computeSpectra(features, spectra, norm);
+    gaussianCorrelation(spectra, norm, spectra, norm, kernelSpectrum);
+    divideSpectrums(plan->labelSpectrum, kernelSpectrum, lambda, responseSpectrum);
+
+    if (modelFeatures.empty() || rate >= 1) {
+        modelFeatures.resize(features.size());
+        for (size_t c = 0; c < features.size(); ++c)
+            features[c].copyTo(modelFeatures[c]);
+        responseSpectrum.copyTo(alphaf);
+    }
+    else {
+        for (size_t c = 0; c < features.size(); ++c)
+            cv::addWeighted(modelFeatures[c], 1 - rate, features[c], rate, 0, modelFeatures[c]);
+        cv::addWeighted(alphaf, 1 - rate, responseSpectrum, rate, 0, alphaf);
+    }
+    computeSpectra(modelFeatures, modelSpectra, modelNorm);
+}
+
+/*
+    Window centered on the target at the given scale resized to the template size, then either:
+        gray:   normalized intensities
+        HOG:    unsigned gradient orientation histograms (9 bins) of cells, L2 normalized per cell
+    Channels are weighted by the cosine window of the plan.
+*/
+void TrackerKCF::extractFeatures(const cv::Mat& image, double scale, std::vector<cv::Mat>& features)
+{
+    cv::Size windowSize((int)std::round(templateSz.width * templateScale * scale), (int)std::round(templateSz.height * templateScale * scale));
+    windowSize.width = std::max(windowSize.width, 1);
+    windowSize.height = std::max(windowSize.height, 1);
+    cv::getRectSubPix(image, windowSize, center, patch);    // replicated borders outside the frame
+    cv::resize(patch, resizedPatch, templateSz, 0, 0, cv::INTER_LINEAR);
+    const cv::Size& size = plan->size;
 
+    if (!useHOG)
+    {
+        features.resize(1);
+        resizedPatch.convertTo(features[0], CV_32F, 1.0 / 255.0, -0.5);
+        cv::multiply(features[0], plan->hann, features[0]);
+        return;
+    }
 
-    cv::Rect bbox;
-    return bbox;
+    resizedPatch.convertTo(floatPatch, CV_32F, 1.0 / 255.0);
+    cv::Sobel(floatPatch, gradX, CV_32F, 1, 0, 1);
+    cv::Sobel(floatPatch, gradY, CV_32F, 0, 1, 1);
+    cv::cartToPolar(gradX, gradY, magnitude, angle, true);
+
+    features.resize(kHogBins);
+    for (int b = 0; b < kHogBins; ++b) {
+        features[b].create(size, CV_32F);
+        features[b].setTo(0);
+    }
+    float binWidth = 180.0f / kHogBins;
+    for (int y = 0; y < templateSz.height; ++y)
+    {
+        const float* mag = magnitude.ptr<float>(y);
+        const float* ang = angle.ptr<float>(y);
+        int cy = y / cellSize;
+        for (int x = 0; x < templateSz.width; ++x)
+        {
+            float a = ang[x] >= 180.0f ? ang[x] - 180.0f : ang[x];
+            int bin = std::min((int)(a / binWidth), kHogBins - 1);
+            features[bin].ptr<float>(cy)[x / cellSize] += mag[x];
+        }
+    }
+    for (int cy = 0; cy < size.height; ++cy)
+    {
+        for (int cx = 0; cx < size.width; ++cx)
+        {
+            float sumSq = 0;
+            for (int b = 0; b < kHogBins; ++b) {
+                float v = features[b].ptr<float>(cy)[cx];
+                sumSq += v * v;
+            }
+            float inv = 1.0f / (std::sqrt(sumSq) + 1e-4f);
+            const float hann = plan->hann.ptr<float>(cy)[cx];
+            for (int b = 0; b < kHogBins; ++b)
+                features[b].ptr<float>(cy)[cx] *= inv * hann;
+        }
+    }
+}
+
+void TrackerKCF::computeSpectra(const std::vector<cv::Mat>& features, std::vector<cv::Mat>& spectra, double& norm)
+{
+    spectra.resize(features.size());
+    norm = 0;
+    for (size_t c = 0; c < features.size(); ++c) {
+        cv::dft(features[c], spectra[c], cv::DFT_COMPLEX_OUTPUT);
+        norm += cv::norm(features[c], cv::NORM_L2SQR);
+    }
 }
 
-void TrackerKCF::updateLearner(const ImageRep& image)
+/*
+    Gaussian kernel correlation of all circular shifts evaluated in the Fourier domain:
+        k = exp(-max(0, |x|^2 + |z|^2 - 2 * F^-1(sum_c X_c . conj(Z_c))) / (N * sigma^2))
+*/
+void TrackerKCF::gaussianCorrelation(const std::vector<cv::Mat>& spectraX, double normX,
+                                     const std::vector<cv::Mat>& spectraZ, double normZ, cv::Mat& kernelSpectrum)
 {
+    crossSpectrum.create(plan->size, CV_32FC2);
+    crossSpectrum.setTo(0);
+    for (size_t c = 0; c < spectraX.size(); ++c) {
+        cv::mulSpectrums(spectraX[c], spectraZ[c], productSpectrum, 0, true);
+        crossSpectrum += productSpectrum;
+    }
+    cv::dft(crossSpectrum, correlation, cv::DFT_INVERSE | cv::DFT_SCALE | cv::DFT_REAL_OUTPUT);
 
+    double count = (double)plan->size.area() * (double)spectraX.size();
+    correlation.convertTo(kernel, CV_32F, -2.0 / count, (normX + normZ) / count);
+    cv::max(kernel, 0, kernel);
+    kernel.convertTo(kernel, CV_32F, -1.0 / (sigma * sigma));
+    cv::exp(kernel, kernel);
+    cv::dft(kernel, kernelSpectrum, cv::DFT_COMPLEX_OUTPUT);
 }
 
 #endif/*FACE_RECOG_HAS_KCF*/
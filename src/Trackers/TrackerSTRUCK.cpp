@@ -22,7 +22,7 @@
 #include "Trackers/TrackerSTRUCK.h"
 #include "FaceRecog.h"
 
-TrackerSTRUCK::TrackerSTRUCK(ConfigFile* configFile) :
+TrackerSTRUCK::TrackerSTRUCK(const ConfigFile* configFile) :
     m_pLearner(0),
     m_needsIntegralImage(false)
 {
@@ -46,6 +46,7 @@ TrackerSTRUCK::TrackerSTRUCK(const TrackerSTRUCK &obj)
     m_kernels.clear();
     this->m_needsIntegralHist = obj.m_needsIntegralHist;
     this->m_needsIntegralImage = obj.m_needsIntegralImage;
+    this->m_motion = obj.m_motion;
     m_features.resize(obj.m_features.size());
     for (size_t i = 0; i < obj.m_features.size(); i++)
     {
@@ -73,6 +74,7 @@ TrackerSTRUCK & TrackerSTRUCK::operator=(const TrackerSTRUCK &obj)
         this->m_bb = obj.m_bb;
         this->m_needsIntegralHist = obj.m_needsIntegralHist;
         this->m_needsIntegralImage = obj.m_needsIntegralImage;
+        this->m_motion = obj.m_motion;
         for (size_t i = 0; i < m_features.size(); ++i)  // free the storage pointed to by m_features
         {
             if (m_features[i] != NULL)
@@ -129,6 +131,7 @@ void TrackerSTRUCK::reset()
 
     m_needsIntegralImage = false;
     m_needsIntegralHist = false;
+    m_motion.reset();
 
     size_t numFeatures = m_config->features.size();
 
@@ -161,6 +164,7 @@ void TrackerSTRUCK::initialize(const ImageRep& image, FloatRect bb)
     m_bb = IntRect(bb);
     for (int i = 0; i < 1; ++i)
         updateLearner(image);
+    m_motion.initialize(cv::Point2f(m_bb.xmin(), m_bb.ymin()));
     m_initialized = true;
 }
 
@@ -169,32 +173,44 @@ cv::Rect TrackerSTRUCK::track(const ImageRep& image)
 {
     assert(m_initialized);
     assert(m_config);
-    vector<FloatRect> rects = Sampler::PixelSamples(m_bb, m_config->searchRadius);
-    vector<FloatRect> keptRects;
-    keptRects.reserve(rects.size());
-    for (size_t i = 0; i < rects.size(); ++i)
+
+    // search around the predicted position, with reduced radius while the motion remains predictable
+    FloatRect centre = m_bb;
+    int radius = m_config->searchRadius;
+    if (m_config->struckMotionPrediction && m_motion.isInitialized())
     {
-        if (!rects[i].isInside(image.getRect())) continue;
-        keptRects.push_back(rects[i]);
+        cv::Point2f predicted = m_motion.predict();
+        centre.xmin(predicted.x);
+        centre.ymin(predicted.y);
+        radius = m_motion.getSearchRadius(m_config->struckMinSearchRadius, m_config->searchRadius);
     }
-    MultiSample sample(image, keptRects);
-    vector<double> scores;
-    m_pLearner->eval(sample, scores);
-    double bestScore = -DBL_MAX;
-    size_t bestInd = -1;
-    for (size_t i = 0; i < keptRects.size(); ++i)
+
+    FloatRect best;
+    bool found;
+    if (m_config->struckCoarseToFine)
     {
-        if (scores[i] > bestScore)
-        {
-            bestScore = scores[i];
-            bestInd = i;
+        // every other offset first, then the neighbours skipped around the best coarse position
+        Sampler::PixelSamples(centre, radius, true, image.getRect(), m_searchRects);
+        found = searchBest(image, m_searchRects, best);
+        if (found) {
+            Sampler::PixelSamples(best, 2, false, image.getRect(), m_searchRects);
+            searchBest(image, m_searchRects, best);
         }
     }
-    if (bestInd != -1)
+    else
+    {
+        Sampler::PixelSamples(centre, radius, false, image.getRect(), m_searchRects);
+        found = searchBest(image, m_searchRects, best);
+    }
+
+    if (found)
     {
-        m_bb = keptRects[bestInd];
+        m_bb = best;
         updateLearner(image);
     }
+    if (m_config->struckMotionPrediction)
+        m_motion.update(cv::Point2f(m_bb.xmin(), m_bb.ymin()));
+
     cv::Rect bbox;
     bbox.x = (int)m_bb.xmin();
     bbox.y = (int)m_bb.ymin();
@@ -203,18 +219,33 @@ cv::Rect TrackerSTRUCK::track(const ImageRep& image)
     return bbox;
 }
 
-void TrackerSTRUCK::updateLearner(const ImageRep& image)
+// Evaluate samples (already within the image), false if there are none
+bool TrackerSTRUCK::searchBest(const ImageRep& image, const vector<FloatRect>& rects, FloatRect& best)
 {
-    // note these returns the centre sample (m_bb) at index 0
-    vector<FloatRect> rects = Sampler::RadialSamples(m_bb, 2 * m_config->searchRadius, 5, 16);
-    vector<FloatRect> keptRects;
-    keptRects.push_back(rects[0]); // the true sample
-    for (size_t i = 1; i < rects.size(); ++i)
+    if (rects.empty())
+        return false;
+    MultiSample sample(image, rects);
+    vector<double> scores;
+    m_pLearner->eval(sample, scores);
+    double bestScore = -DBL_MAX;
+    size_t bestInd = 0;
+    for (size_t i = 0; i < rects.size(); ++i)
     {
-        if (!rects[i].isInside(image.getRect())) continue;
-        keptRects.push_back(rects[i]);
+        if (scores[i] > bestScore)
+        {
+            bestScore = scores[i];
+            bestInd = i;
+        }
     }
-    MultiSample sample(image, keptRects);
+    best = rects[bestInd];
+    return true;
+}
+
+void TrackerSTRUCK::updateLearner(const ImageRep& image)
+{
+    // note these returns the centre sample (m_bb) at index 0
+    Sampler::RadialSamples(m_bb, 2 * m_config->searchRadius, 5, 16, image.getRect(), m_updateRects);
+    MultiSample sample(image, m_updateRects);
     m_pLearner->update(sample, 0);
 }
 
@@ -50,17 +50,21 @@ void Association::clear()
     costMatrix = NULL;
 }
 
-Association::Association(ConfigFile* config)
+Association::Association(const ConfigSnapshot& config)
 {
-    assert(config);
-    _config = config;
-
+    configure(config);
     costMatrix = NULL;
-    detTrackThresh = _config->associationTrackThreshold;
     m = 0;
     n = 0;
 }
 
+void Association::configure(const ConfigSnapshot& config)
+{
+    assert(config);
+    _config = config;
+    detTrackThresh = _config->associationTrackThreshold;
+}
+
 Association::~Association()
 {
     clear();
@@ -57,7 +57,8 @@ static const int kNumBins = 16;
 
 ImageRep::ImageRep(const Mat& image, bool computeIntegral, bool computeIntegralHist, bool colour) :
     m_channels(colour ? 3 : 1),
-    m_rect(0, 0, image.cols, image.rows)
+    m_rect(0, 0, image.cols, image.rows),
+    m_context(nullptr)
 {
     m_images.clear();
     m_integralImages.clear();
@@ -128,6 +129,16 @@ ImageRep::ImageRep(const Mat& image, bool computeIntegral, bool computeIntegralH
     }
 }
 
+ImageRep::ImageRep(const FrameContext& context) :
+    m_channels(1),
+    m_rect(0, 0, context.getSize().width, context.getSize().height),
+    m_context(&context)
+{
+    m_images.push_back(context.getTrackerGray());
+    m_integralImages.push_back(context.getTrackerIntegral());
+    colour_image = GET_MAT(context.getFrame(), ACCESS_READ);
+}
+
 int ImageRep::Sum(const IntRect& rRect, int channel) const
 {
     assert(rRect.xmin() >= 0 && rRect.ymin() >= 0 && rRect.xmax() <= m_images[0].cols && rRect.ymax() <= m_images[0].rows);
@@ -150,3 +161,29 @@ void ImageRep::Hist(const IntRect& rRect, Eigen::VectorXd& h) const
         h[i] = (float)sum / norm;
     }
 }
+
+const Mat& ImageRep::getHSVImage() const
+{
+    if (m_context)
+        return m_context->getHSV();
+    std::call_once(m_hsvOnce, [this]() {
+        if (colour_image.channels() == 3)
+            FACE_RECOG_NAMESPACE::cvtColor(colour_image, m_hsvImage, CV_BGR2HSV);
+        else
+            m_hsvImage = Mat(colour_image.size(), CV_8UC3, Scalar::all(0));
+    });
+    return m_hsvImage;
+}
+
+// back-projection of the histogram limited to the window (clipped to the frame)
+void ImageRep::backProject(const Rect& window, const int* channels, const Mat& hist, const float** ranges, Mat& backProj) const
+{
+    const Mat& hsv = getHSVImage();
+    Rect roi = window & Rect(0, 0, hsv.cols, hsv.rows);
+    if (roi.area() == 0) {
+        backProj.release();
+        return;
+    }
+    Mat hsvWindow = hsv(roi);
+    calcBackProject(&hsvWindow, 1, channels, hist, backProj, ranges);
+}
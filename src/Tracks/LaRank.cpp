@@ -56,7 +56,7 @@
 static const int kMaxSVs = 2000; // TODO (only used when no budget)
 
 
-LaRank::LaRank(ConfigFile *conf, HaarFeatures features, Kernel kernel)
+LaRank::LaRank(const ConfigFile* conf, HaarFeatures features, Kernel kernel)
 {
     assert(conf);
     m_config = conf;
@@ -0,0 +1,58 @@
+﻿#include "Tracks/MotionPredictor.h"
+#include "FaceRecog.h"
+
+// minimal updates before predictions are considered reliable enough to reduce the search radius
+static const int kWarmupUpdates = 3;
+// smoothing of prediction errors
+static const float kErrorRate = 0.3f;
+
+MotionPredictor::MotionPredictor(float alpha, float beta) :
+    alpha(alpha),
+    beta(beta)
+{
+    reset();
+}
+
+void MotionPredictor::reset()
+{
+    position = cv::Point2f(0, 0);
+    velocity = cv::Point2f(0, 0);
+    meanError = 0;
+    updates = 0;
+}
+
+void MotionPredictor::initialize(const cv::Point2f& initPosition)
+{
+    reset();
+    position = initPosition;
+    updates = 1;
+}
+
+cv::Point2f MotionPredictor::predict() const
+{
+    return position + velocity;
+}
+
+void MotionPredictor::update(const cv::Point2f& measured)
+{
+    if (updates == 0) {
+        initialize(measured);
+        return;
+    }
+    cv::Point2f predicted = predict();
+    cv::Point2f residual = measured - predicted;
+    float error = (float)cv::norm(residual);
+    meanError = (updates == 1) ? error : (1 - kErrorRate) * meanError + kErrorRate * error;
+    position = predicted + alpha * residual;
+    velocity = velocity + beta * residual;
+    ++updates;
+}
+
+int MotionPredictor::getSearchRadius(int minRadius, int maxRadius) const
+{
+    if (updates < kWarmupUpdates)
+        return maxRadius;
+    // cover a few times the usual miss distance, any larger miss immediately widens the next search
+    int radius = (int)std::ceil(3 * meanError) + 2;
+    return std::max(minRadius, std::min(radius, maxRadius));
+}
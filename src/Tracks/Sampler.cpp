@@ -56,55 +56,153 @@
 #include "Tracks/Sampler.h"
 #include "FaceRecog.h"
 
+#include <map>
+#include <mutex>
+#include <tuple>
+
+typedef std::tuple<bool, int, int, int> OffsetTableKey;    // (pixel, radius, nr/halfSample, nt)
+
+static std::map<OffsetTableKey, Sampler::OffsetTable> offsetTables;
+static std::mutex offsetTablesMutex;
+
+// Tables are never released, so each thread keeps their addresses and only locks on its first lookup of a table
+template<typename BuildFunc>
+static const Sampler::OffsetTable& findOffsetTable(const OffsetTableKey& key, BuildFunc build)
+{
+    thread_local std::map<OffsetTableKey, const Sampler::OffsetTable*> threadTables;
+    auto local = threadTables.find(key);
+    if (local != threadTables.end())
+        return *local->second;
+
+    std::lock_guard<std::mutex> lock(offsetTablesMutex);
+    auto it = offsetTables.find(key);
+    if (it == offsetTables.end()) {
+        it = offsetTables.insert(std::make_pair(key, Sampler::OffsetTable())).first;
+        build(it->second);
+    }
+    threadTables[key] = &it->second;
+    return it->second;
+}
+
+const Sampler::OffsetTable& Sampler::RadialOffsets(int radius, int nr, int nt)
+{
+    return findOffsetTable(OffsetTableKey(false, radius, nr, nt), [=](OffsetTable& table)
+    {
+        float rstep = (float)radius / nr;
+        float tstep = 2 * (float)M_PI / nt;
+        table.offsets.reserve(nr * nt);
+        for (int ir = 1; ir <= nr; ++ir)
+        {
+            float phase = (ir % 2)*tstep / 2;
+            for (int it = 0; it < nt; ++it)
+                table.offsets.push_back(cv::Point2f(ir*rstep*cosf(it*tstep + phase), ir*rstep*sinf(it*tstep + phase)));
+        }
+    });
+}
+
+const Sampler::OffsetTable& Sampler::PixelOffsets(int radius, bool halfSample)
+{
+    return findOffsetTable(OffsetTableKey(true, radius, halfSample, 0), [=](OffsetTable& table)
+    {
+        int r2 = radius*radius;
+        for (int iy = -radius; iy <= radius; ++iy)
+        {
+            OffsetTable::Row row = { (float)iy, (int)table.offsets.size(), 0 };
+            for (int ix = -radius; ix <= radius; ++ix)
+            {
+                if (ix*ix + iy*iy > r2) continue;
+                if (iy == 0 && ix == 0) continue; // centre sample is put at the start
+                if (halfSample && (ix % 2 != 0 || iy % 2 != 0)) continue;
+                table.offsets.push_back(cv::Point2f((float)ix, (float)iy));
+            }
+            row.end = (int)table.offsets.size();
+            if (row.end > row.begin)
+                table.rows.push_back(row);
+        }
+    });
+}
+
 vector<FloatRect> Sampler::RadialSamples(FloatRect centre, int radius, int nr, int nt)
 {
+    const OffsetTable& table = RadialOffsets(radius, nr, nt);
     vector<FloatRect> samples;
-    FloatRect s(centre);
-    float rstep = (float)radius / nr;
-    float tstep = 2 * (float)M_PI / nt;
+    samples.reserve(table.offsets.size() + 1);
     samples.push_back(centre);
 
     // note here that all the samples (bboxes) have the same width and height
-    for (int ir = 1; ir <= nr; ++ir)
+    FloatRect s(centre);
+    for (size_t i = 0; i < table.offsets.size(); ++i)
     {
-        float phase = (ir % 2)*tstep / 2;
-        for (int it = 0; it < nt; ++it)
-        {
-            float dx = ir*rstep*cosf(it*tstep + phase);
-            float dy = ir*rstep*sinf(it*tstep + phase);
-            s.xmin(centre.xmin() + dx);
-            s.ymin(centre.ymin() + dy);
-            samples.push_back(s);
-        }
+        s.xmin(centre.xmin() + table.offsets[i].x);
+        s.ymin(centre.ymin() + table.offsets[i].y);
+        samples.push_back(s);
     }
-
     return samples;
 }
 
 vector<FloatRect> Sampler::PixelSamples(FloatRect centre, int radius, bool halfSample)
 {
+    const OffsetTable& table = PixelOffsets(radius, halfSample);
     vector<FloatRect> samples;
+    samples.reserve(table.offsets.size() + 1);
 
     IntRect s(centre);
     samples.push_back(s);
+    for (size_t i = 0; i < table.offsets.size(); ++i)
+    {
+        s.xmin((int)centre.xmin() + (int)table.offsets[i].x);
+        s.ymin((int)centre.ymin() + (int)table.offsets[i].y);
+        samples.push_back(s);
+    }
+    return samples;
+}
+
+void Sampler::RadialSamples(FloatRect centre, int radius, int nr, int nt, const IntRect& bounds, std::vector<FloatRect>& samples)
+{
+    const OffsetTable& table = RadialOffsets(radius, nr, nt);
+    samples.clear();
+    samples.push_back(centre);  // the true sample
 
-    int r2 = radius*radius;
-    for (int iy = -radius; iy <= radius; ++iy)
+    // offsets allowed by the bounds for the sample size
+    float dxMin = bounds.xmin() - centre.xmin(), dxMax = bounds.xmax() - centre.xmax();
+    float dyMin = bounds.ymin() - centre.ymin(), dyMax = bounds.ymax() - centre.ymax();
+    FloatRect s(centre);
+    for (size_t i = 0; i < table.offsets.size(); ++i)
     {
-        for (int ix = -radius; ix <= radius; ++ix)
-        {
-            if (ix*ix + iy*iy > r2) continue;
-            if (iy == 0 && ix == 0) continue; // already put this one at the start
+        const cv::Point2f& d = table.offsets[i];
+        if (d.x < dxMin || d.x > dxMax || d.y < dyMin || d.y > dyMax) continue;
+        s.xmin(centre.xmin() + d.x);
+        s.ymin(centre.ymin() + d.y);
+        samples.push_back(s);
+    }
+}
+
+void Sampler::PixelSamples(FloatRect centre, int radius, bool halfSample, const IntRect& bounds, std::vector<FloatRect>& samples)
+{
+    const OffsetTable& table = PixelOffsets(radius, halfSample);
+    samples.clear();
 
-            int x = (int)centre.xmin() + ix;
-            int y = (int)centre.ymin() + iy;
-            if (halfSample && (ix % 2 != 0 || iy % 2 != 0)) continue;
+    IntRect s(centre);
+    if (s.isInside(bounds))
+        samples.push_back(s);
 
-            s.xmin(x);
-            s.ymin(y);
+    // rows within vertical bounds, each clipped to the span of offsets within horizontal bounds
+    int x = s.xmin(), y = s.ymin();
+    float dxMin = (float)(bounds.xmin() - x), dxMax = (float)(bounds.xmax() - s.xmax());
+    float dyMin = (float)(bounds.ymin() - y), dyMax = (float)(bounds.ymax() - s.ymax());
+    auto lessX = [](const cv::Point2f& p, float v) { return p.x < v; };
+    auto greaterX = [](float v, const cv::Point2f& p) { return v < p.x; };
+    for (size_t r = 0; r < table.rows.size(); ++r)
+    {
+        const OffsetTable::Row& row = table.rows[r];
+        if (row.dy < dyMin) continue;
+        if (row.dy > dyMax) break;
+        auto first = std::lower_bound(table.offsets.begin() + row.begin, table.offsets.begin() + row.end, dxMin, lessX);
+        auto last = std::upper_bound(first, table.offsets.begin() + row.end, dxMax, greaterX);
+        s.ymin(y + (int)row.dy);
+        for (; first != last; ++first) {
+            s.xmin(x + (int)first->x);
             samples.push_back(s);
         }
     }
-
-    return samples;
 }
@@ -39,11 +39,12 @@
 #include "Tracks/Track.h"
 #include "FaceRecog.h"
 
-Track::Track(ConfigFile* configFile)
+Track::Track(const ConfigSnapshot& configFile)
     : _createCount(0)
     , _removeCount(0)
     , _isMatched(false)
     , _isValidatedWithEyeDetection(false)
+    , _isFrontalDetection(true)
 {
     configCheckAndSet(configFile);
     resetTracker();
@@ -53,11 +54,12 @@ Track::Track(ConfigFile* configFile)
     _recognizedPOIName = "";
 }
 
-Track::Track(ConfigFile* configFile, const cv::Rect& rect, int targetNumber)
+Track::Track(const ConfigSnapshot& configFile, const cv::Rect& rect, int targetNumber)
     : _createCount(0)
     , _removeCount(0)
     , _isMatched(false)
     , _isValidatedWithEyeDetection(false)
+    , _isFrontalDetection(true)
 {
     configCheckAndSet(configFile);
     setTrackSize(_config->roiAccumulationSize);
@@ -69,10 +71,12 @@ Track::Track(ConfigFile* configFile, const cv::Rect& rect, int targetNumber)
 }
 
 Track::Track(const Track& track)
-    : _createCount(track._createCount)
+    : _config(track._config)
+    , _createCount(track._createCount)
     , _removeCount(track._removeCount)
     , _isMatched(track._isMatched)
     , _isValidatedWithEyeDetection(false)
+    , _isFrontalDetection(track._isFrontalDetection)
 {
     insertROI(track.bbox());
     _tracker = track._tracker;
@@ -85,6 +89,7 @@ Track::Track(const Track& track)
 Track& Track::operator= (const Track& track)
 {
     // do the copy
+    _config = track._config;
     _createCount = track._createCount;
     _removeCount = track._removeCount;
     _recognizedState = track._recognizedState;
@@ -93,6 +98,7 @@ Track& Track::operator= (const Track& track)
     _trackNumber = track._trackNumber;
     _isMatched = track._isMatched;
     _isValidatedWithEyeDetection = track._isValidatedWithEyeDetection;
+    _isFrontalDetection = track._isFrontalDetection;
     _tracker = track._tracker;
     return *this;
 }
@@ -106,23 +112,23 @@ void Track::resetTracker()
 {
     #ifdef FACE_RECOG_HAS_CAMSHIFT
     if (_config->Camshift)
-        _tracker.reset(new TrackerCamshift(_config));
+        _tracker.reset(new TrackerCamshift(_config.get()));
     #endif/*FACE_RECOG_HAS_CAMSHIFT*/
     #ifdef FACE_RECOG_HAS_COMPRESSIVE
     if (_config->Compressive)
-        _tracker.reset(new TrackerCompressive(_config));
+        _tracker.reset(new TrackerCompressive(_config.get()));
     #endif/*FACE_RECOG_HAS_COMPRESSIVE*/
     #ifdef FACE_RECOG_HAS_KCF
     if (_config->KCF)
-        _tracker.reset(new TrackerKCF(_config));
+        _tracker.reset(new TrackerKCF(_config.get()));
     #endif/*FACE_RECOG_HAS_KCF*/
     #ifdef FACE_RECOG_HAS_STRUCK
     if (_config->STRUCK)
-        _tracker.reset(new TrackerSTRUCK(_config));
+        _tracker.reset(new TrackerSTRUCK(_config.get()));
     #endif/*FACE_RECOG_HAS_STRUCK*/
 }
 
-void Track::configCheckAndSet(ConfigFile* configFile)
+void Track::configCheckAndSet(const ConfigSnapshot& configFile)
 {
     ASSERT_LOG(configFile, "Configuration file not specified for track");
     _config = configFile;
@@ -139,19 +145,3 @@ void Track::reInitTracking(const ImageRep& frame)
     FloatRect fbbox(b.x, b.y, b.width, b.height);
     _tracker->initialize(frame, fbbox);
 }
-
-void Track::track(const ImageRep& frame)
-{
-    cv::Rect b = bbox();
-    if ((b.width == 0) && (b.height == 0))
-    {
-        cout << "Error in track, the track has no bbox assigned" << endl;
-        return;
-    }
-    if (!_tracker->isInitialized())
-    {
-        cout << "Error in track, the track has no initialized tracker" << endl;
-        return;
-    }
-    insertROI(_tracker->track(frame));
-}
@@ -1,9 +1,9 @@
 ﻿#include "Tracks/TrackROI.h"
 #include "FaceRecog.h"
 
-cv::Rect ROI::getSubRect(size_t pos) const
+const cv::Rect& ROI::getSubRect(size_t pos) const
 {
-    if (pos < _subRoi.size())
+    if (pos < _subCount)
         return _subRoi[pos];
 
     throw std::out_of_range("Index out of sub-ROI range");
@@ -11,23 +11,24 @@ cv::Rect ROI::getSubRect(size_t pos) const
 
 void ROI::addSubRect(cv::Rect roi, size_t pos)
 {
-    _subRoi.insert(_subRoi.begin() + pos, roi);
-}
-
-size_t ROI::countSubROI() const
-{
-    return _subRoi.size();
+    if (pos >= maxSubROI) return;
+    pos = std::min(pos, _subCount);
+    if (_subCount < maxSubROI)
+        ++_subCount;
+    for (size_t i = _subCount - 1; i > pos; --i)
+        _subRoi[i] = _subRoi[i - 1];
+    _subRoi[pos] = roi;
 }
 
 void ROI::setAllSubRect(std::vector<cv::Rect> vRect)
 {
-    _subRoi.clear();
-    _subRoi.assign(vRect.begin(), vRect.end());
+    _subCount = std::min(vRect.size(), maxSubROI);
+    std::copy(vRect.begin(), vRect.begin() + _subCount, _subRoi.begin());
 }
 
 std::vector<cv::Rect> ROI::getAllSubRect() const
 {
-    std::vector<cv::Rect> rects(_subRoi.begin(), _subRoi.end());
+    std::vector<cv::Rect> rects(_subRoi.begin(), _subRoi.begin() + _subCount);
     return rects;
 }
 
@@ -48,15 +49,27 @@ TrackROI::TrackROI(size_t trackSize, ROI roi)
     addROI(roi);
 }
 
+void TrackROI::init(size_t trackSize)
+{
+    _trackSize = std::max(trackSize, (size_t)1);
+    _roiCumul.assign(_trackSize, ROI());
+    _head = 0;
+    _count = 0;
+}
+
 void TrackROI::setTrackSize(size_t trackSize)
 {
-    if (trackSize < 1) return;
-    if (trackSize < _trackSize)
-    {
-        while (trackSize < _roiCumul.size())
-            _roiCumul.pop_back();
-    }
+    if (trackSize < 1 || trackSize == _trackSize) return;
+
+    // storage only reallocated when capacity changes, most recent ROIs are kept
+    std::vector<ROI> roiCumul(trackSize);
+    size_t count = std::min(_count, trackSize);
+    for (size_t i = 0; i < count; ++i)
+        roiCumul[i] = at(i);
+    _roiCumul.swap(roiCumul);
     _trackSize = trackSize;
+    _head = 0;
+    _count = count;
 }
 
 void TrackROI::addROI(cv::Rect roi, size_t pos)
@@ -64,14 +77,18 @@ void TrackROI::addROI(cv::Rect roi, size_t pos)
     addROI(ROI(roi), pos);
 }
 
-void TrackROI::addROI(ROI roi, size_t pos)
+void TrackROI::addROI(const ROI& roi, size_t pos)
 {
     if (pos >= _trackSize) return;
+    pos = std::min(pos, _count);
 
-    _roiCumul.insert(_roiCumul.begin() + pos, roi);
-
-    if (_roiCumul.size() > _trackSize)
-        _roiCumul.pop_back();
+    // new front slot replaces the oldest ROI when full, preceding ROIs are shifted to insert at position
+    _head = (_head + _trackSize - 1) % _trackSize;
+    if (_count < _trackSize)
+        ++_count;
+    for (size_t i = 0; i < pos; ++i)
+        at(i) = at(i + 1);
+    at(pos) = roi;
 }
 
 void TrackROI::setROI(cv::Rect roi, size_t pos)
@@ -79,29 +96,25 @@ void TrackROI::setROI(cv::Rect roi, size_t pos)
     setROI(ROI(roi), pos);
 }
 
-void TrackROI::setROI(ROI roi, size_t pos)
+void TrackROI::setROI(const ROI& roi, size_t pos)
 {
     if (pos >= _trackSize) return;
-    if (pos < _roiCumul.size())
-        _roiCumul[pos] = roi;
+    if (pos < _count)
+        at(pos) = roi;
     else
         addROI(roi, pos);
 }
 
-ROI TrackROI::getROI(size_t pos) const
+const ROI& TrackROI::getROI(size_t pos) const
 {
-    if (pos < _roiCumul.size())
-        return _roiCumul[pos];
+    if (pos < _count)
+        return at(pos);
 
     throw std::out_of_range("Index out of accumulated ROI range");
 }
 
-cv::Rect TrackROI::getRect(size_t pos) const
-{
-    return getROI(pos).getRect();
-}
-
-size_t TrackROI::countROI() const
+const cv::Rect& TrackROI::getRect(size_t pos) const
 {
-    return _roiCumul.size();
+    static const cv::Rect emptyRect;
+    return pos < _count ? at(pos).getRect() : emptyRect;
 }
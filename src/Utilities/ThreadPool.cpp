@@ -0,0 +1,131 @@
+﻿#include "Utilities/ThreadPool.h"
+#include "FaceRecog.h"
+
+// owner pool and worker index of the calling thread
+static thread_local const ThreadPool* currentPool = nullptr;
+static thread_local int currentIndex = -1;
+
+ThreadPool::ThreadPool(size_t workerCount, int ompThreadsPerWorker)
+    : nextQueue(0)
+    , queuedTasks(0)
+    , pendingTasks(0)
+    , stopping(false)
+    , ompThreads(ompThreadsPerWorker)
+{
+    if (workerCount == 0)
+        workerCount = std::max<size_t>(1, std::thread::hardware_concurrency());
+    for (size_t w = 0; w < workerCount; ++w)
+        queues.push_back(std::unique_ptr<WorkerQueue>(new WorkerQueue));
+    for (size_t w = 0; w < workerCount; ++w)
+        workers.push_back(std::thread(&ThreadPool::run, this, w));
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        stopping = true;
+    }
+    taskAvailable.notify_all();
+    for (size_t w = 0; w < workers.size(); ++w)
+        if (workers[w].joinable())
+            workers[w].join();
+}
+
+int ThreadPool::currentWorkerIndex() const
+{
+    return currentPool == this ? currentIndex : -1;
+}
+
+void ThreadPool::submit(Task task)
+{
+    int worker = currentWorkerIndex();
+    size_t q = worker >= 0 ? (size_t)worker : nextQueue++ % queues.size();
+    {
+        std::lock_guard<std::mutex> lock(queues[q]->mutex);
+        queues[q]->tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        ++queuedTasks;
+        ++pendingTasks;
+    }
+    taskAvailable.notify_one();
+}
+
+void ThreadPool::wait()
+{
+    std::unique_lock<std::mutex> lock(stateMutex);
+    tasksCompleted.wait(lock, [this] { return pendingTasks == 0; });
+    if (taskError) {
+        std::exception_ptr error = taskError;
+        taskError = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+bool ThreadPool::popTask(size_t workerIndex, Task& task)
+{
+    // own queue first (oldest task), then steal from others (newest task)
+    size_t nQueues = queues.size();
+    for (size_t i = 0; i < nQueues; ++i)
+    {
+        size_t q = (workerIndex + i) % nQueues;
+        std::lock_guard<std::mutex> lock(queues[q]->mutex);
+        if (queues[q]->tasks.empty())
+            continue;
+        if (i == 0) {
+            task = std::move(queues[q]->tasks.front());
+            queues[q]->tasks.pop_front();
+        }
+        else {
+            task = std::move(queues[q]->tasks.back());
+            queues[q]->tasks.pop_back();
+        }
+        return true;
+    }
+    return false;
+}
+
+void ThreadPool::run(size_t workerIndex)
+{
+    currentPool = this;
+    currentIndex = (int)workerIndex;
+
+    // limit nested OpenMP regions of tasks to avoid competing with other workers
+    if (ompThreads > 0)
+        omp_set_num_threads(ompThreads);
+
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(stateMutex);
+            taskAvailable.wait(lock, [this] { return stopping || queuedTasks > 0; });
+            if (queuedTasks == 0)
+                return;
+        }
+
+        Task task;
+        if (!popTask(workerIndex, task)) {
+            std::this_thread::yield();  // another worker took it meanwhile
+            continue;
+        }
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            --queuedTasks;
+        }
+
+        try {
+            task();
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            if (!taskError)
+                taskError = std::current_exception();
+        }
+
+        std::lock_guard<std::mutex> lock(stateMutex);
+        if (--pendingTasks == 0)
+            tasksCompleted.notify_all();
+    }
+}
@@ -241,21 +241,24 @@ Rect getBiggestSquare(const Rect& r1, const Size& imageSize)
 void saveTrackROIToDisk(const Rect& roi, const FACE_RECOG_MAT& image, const string& label,
                         int trackNumber, int desiredSize, const string& dirPath)
 {
-    stringstream fileLocation, folderName;
-
     // roi = getBiggestSquare(roi, image.size());
 
+    FACE_RECOG_MAT resizedMat = image(roi);
+    Size size(desiredSize, desiredSize);
+    FACE_RECOG_NAMESPACE::resize(resizedMat, resizedMat, size, 0, 0, cv::INTER_AREA);
+    saveTrackROIImage(GET_MAT(resizedMat, ACCESS_READ), label, trackNumber, dirPath);
+}
+
+void saveTrackROIImage(const Mat& roiImage, const string& label, int trackNumber, const string& dirPath)
+{
+    stringstream fileLocation, folderName;
     folderName << dirPath;
     createDirIfNotExist(folderName.str());
     folderName << "/person_" << trackNumber;
     createDirIfNotExist(folderName.str());
 
-    FACE_RECOG_MAT resizedMat = image(roi);
-    Size size(desiredSize, desiredSize);
-    FACE_RECOG_NAMESPACE::resize(resizedMat, resizedMat, size, 0, 0, cv::INTER_AREA);
-
     fileLocation << folderName.str() << "/" << label << ".png";
-    imwrite(fileLocation.str().c_str(), resizedMat);
+    imwrite(fileLocation.str().c_str(), roiImage);
 }
 
 Rect getConstSizedRect(const Rect& r1, int sideLength, const Size& imageSize)
@@ -38,8 +38,8 @@ int main(int argc, char *argv[])
     std::string outDir = "./output";
     std::string imgDir = "./images";
     std::string resultFilePath = "./results.txt";
-    std::string framesPath, testFilePath;
-    bool optArgI = false, optArgO = false, optArgP = false, optArgR = false, optArgT = false, optArgV = false;
+    std::string framesPath, testFilePath, streamsFilePath;
+    bool optArgI = false, optArgM = false, optArgO = false, optArgP = false, optArgR = false, optArgT = false, optArgV = false;
     int argmin = 2, argmax = 12;
 
     #if FACE_RECOG_USE_PSEUDO_INPUT_ARGS
@@ -66,7 +66,7 @@ int main(int argc, char *argv[])
     std::string usageMsg = "usage:\n"
         + tab + app + " <opencv_root>\n"
         + align + " [-o <output_frames_directory>] [-i <images_directory>] [-c <config_file_path>]\n"
-        + align + " [-p <frames_path_regex>|-t <test_file_path>|-v <video_path>] [-r <result_file_path]\n";
+        + align + " [-p <frames_path_regex>|-t <test_file_path>|-v <video_path>|-m <streams_file_path>] [-r <result_file_path]\n";
     if (argc < argmin || argc > argmax)
     {
         std::cout << usageMsg;
@@ -90,6 +90,11 @@ int main(int argc, char *argv[])
                 imgDir = std::string(argv[argi + 1]);
                 optArgI = true;
             }
+            else if (opt == "-m")
+            {
+                optArgM = true;
+                streamsFilePath = std::string(argv[argi + 1]);
+            }
             else if (opt == "-o")
             {
                 outDir = std::string(argv[argi + 1]);
@@ -127,13 +132,19 @@ int main(int argc, char *argv[])
             }
         }
     }
+    if (optArgM && (optArgP || optArgT || optArgV)) {
+        ASSERT_WARN(false, "Ignoring '-m' option since (-p|-t|-v) option was detected");
+        optArgM = false;                        // single stream processing has priority
+    }
     if (optArgR && !(optArgP || optArgT || optArgV)) {
         ASSERT_WARN(false, "Ignoring '-r' option since (-p|-t|-v) option was detected");
         optArgR = false;                        // disable '-r' if not in a possible testing case (not live-feed)
     }
 
-    // provide here configuration file
-    static ConfigFile *conf = new ConfigFile(configPath);
+    // provide here configuration file, published as immutable snapshots reloaded between frames when enabled
+    static ConfigStore configStore(configPath);
+    ConfigSnapshot conf = configStore.current();
+    const ConfigSnapshot startupConf = conf;    // models, detectors and tracks created before any reload employ it
     ASSERT_LOG(conf, "ConfigFile reference invalid");
 
     if (conf->outputDirsClearOnStart && bfs::is_directory(outDir))
@@ -208,14 +219,8 @@ int main(int argc, char *argv[])
     }
     const size_t targetCount = POI_IDs.size();
 
-    FACE_RECOG_DEBUG(
-        std::vector<double> minScores(targetCount,  DBL_MAX);
-        std::vector<double> maxScores(targetCount, -DBL_MAX);
-    );
-
     // apply classifier according to config
     std::shared_ptr<IClassifier> classifier;
-    CircularBuffer accScores(conf->roiAccumulationSize);
     if (conf->useFaceRecognition) {
         logOutput << "Training face recognition classifiers..." << std::endl;
         classifier = buildSpecializedClassifier(*conf, POI_ROIs, POI_IDs, NEG_ROIs);
@@ -227,10 +232,43 @@ int main(int argc, char *argv[])
             FINALIZE(EXIT_FAILURE);
         }
         logOutput << "Face recognition classifiers training complete" << std::endl;
+
+        #ifdef FACE_RECOG_HAS_TM
+        // compare quantized against full precision template scores using enrolled stills as probes
+        if (conf->getClassifierType() == ClassifierType::ENSEMBLE_TM && conf->templateQuantization && conf->templateQuantizationCheck) {
+            std::shared_ptr<ClassifierEnsembleTM> tm = std::static_pointer_cast<ClassifierEnsembleTM>(classifier);
+            std::vector<FACE_RECOG_MAT> probes;
+            for (size_t pos = 0; pos < POI_ROIs.size(); ++pos)
+                probes.insert(probes.end(), POI_ROIs[pos].begin(), POI_ROIs[pos].end());
+            TemplateQuantizationReport report = tm->evaluateQuantization(probes);
+            tm->releaseExactTemplates();
+            logOutput << "Template quantization check (" << report.probeCount << " probes):" << std::endl << setprecision(6)
+                      << "    max score error:  " << report.maxAbsError << std::endl
+                      << "    mean score error: " << report.meanAbsError << std::endl
+                      << "    best POI agreement: " << report.rankAgreement * 100.0 << "%" << std::endl
+                      << "    templates memory: " << report.quantizedBytes << " / " << report.exactBytes << " bytes" << std::endl;
+        }
+        // batch scoring of stream processing checked against per probe scoring using enrolled stills as probes
+        else if (conf->getClassifierType() == ClassifierType::ENSEMBLE_TM && !conf->templateQuantization) {
+            std::shared_ptr<ClassifierEnsembleTM> tm = std::static_pointer_cast<ClassifierEnsembleTM>(classifier);
+            std::vector<FACE_RECOG_MAT> probes;
+            for (size_t pos = 0; pos < POI_ROIs.size(); ++pos)
+                probes.insert(probes.end(), POI_ROIs[pos].begin(), POI_ROIs[pos].end());
+            double batchError = tm->evaluateBatchScoring(probes);
+            logOutput << "Template batch scoring check (" << probes.size() << " probes): max score difference "
+                      << setprecision(6) << batchError << std::endl;
+            ASSERT_WARN(batchError < 1e-6, "Batch template scores differ from per probe scores");
+        }
+        #endif/*FACE_RECOG_HAS_TM*/
     }
     POI_ROIs.clear();
     NEG_ROIs.clear();
 
+    // models shared by every processed stream
+    SharedModels models;
+    models.classifier = classifier;
+    models.targetIDs = POI_IDs;
+
     /********************************************************************************************************************************************/
     /* OUTPUT AND TIMERS                                                                                                                        */
     /********************************************************************************************************************************************/
@@ -241,6 +279,40 @@ int main(int argc, char *argv[])
         util::setAndDisplayDevices(conf->deviceIndex, logOutput.ofss);
     #endif
 
+    /********************************************************************************************************************************************/
+    /* MULTIPLE STREAMS PROCESSING                                                                                                              */
+    /********************************************************************************************************************************************/
+
+    // each line of streams specification file is either a camera index or a video/frames path, results are written per stream
+    if (optArgM)
+    {
+        std::ifstream streamsFile(streamsFilePath);
+        ASSERT_LOG_FINALIZE(streamsFile.is_open(), "Failed to open streams specification file", logOutput, EXIT_FAILURE);
+        bfs::path resultPath(resultFilePath);
+        StreamScheduler scheduler(conf.get(), models, opencvSourceDataPathStr);
+        std::string line;
+        while (std::getline(streamsFile, line)) {
+            if (line.empty()) continue;
+            std::string streamResultPath = (resultPath.parent_path() / bfs::path(resultPath.stem().string() + "_" +
+                                            std::to_string(scheduler.streamCount()) + resultPath.extension().string())).string();
+            if (scheduler.addStream(line, streamResultPath))
+                logOutput << "Input stream [" << line << "] ready for capture, results: '" << streamResultPath << "'" << std::endl;
+        }
+        ASSERT_LOG_FINALIZE(scheduler.streamCount() > 0, "No valid input stream to process", logOutput, EXIT_FAILURE);
+
+        TP startTime = getTimeNowPrecise();
+        scheduler.run();
+        double totalTime = getDeltaTimePrecise(startTime, MILLISECONDS);
+        for (size_t s = 0; s < scheduler.streamCount(); ++s) {
+            double frames = (double)scheduler.getFrameCount(s);
+            logOutput << "Stream [" << scheduler.getSourceID(s) << "] processed frames: " << scheduler.getFrameCount(s)
+                      << ", dropped frames: " << scheduler.getDroppedFrames(s)
+                      << ", FPS: " << std::setprecision(3) << (totalTime > 0 ? frames * 1000.0 / totalTime : 0) << std::endl;
+        }
+        logOutput << "All input streams processed." << std::endl;
+        FINALIZE(EXIT_SUCCESS);
+    }
+
     // Handle for colored console text in Windows
     #if defined(CONSOLE_COLOR_ENABLED) && !FACE_RECOG_DISABLE_COLOR_CONSOLE
     HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
@@ -248,10 +320,10 @@ int main(int argc, char *argv[])
 
     // processing time and counters
     TP frameTime = getTimeNowPrecise(), frameTimePrev = frameTime;
-    double deltaTime = 0, sumTimeDetect = 0, sumTimeTrack = 0, sumTimeDetectLocal = 0;
-    int totalFramesDetect = 0, totalFramesDetectLocal = 0;
+    double deltaTime = 0;
     int frameCounter = 0;
     int sequenceCounter = 0;
+    int loadSheddingLevel = LoadSheddingScheduler::NONE;
     std::string currentFrameLabel;
 
     // create a window for display
@@ -261,9 +333,6 @@ int main(int argc, char *argv[])
 
     // output bbox colors
     MultiColorType bboxColors = MultiColorType(conf->roiColorMode);
-    ColorCode bboxColorNotMatched = bboxColors.getColorCode(0);
-    ColorCode bboxColorConsidered = bboxColors.getColorCode(1);
-    ColorCode bboxColorRecognized = bboxColors.getColorCode(2);
 
     // create a window for plotting scores
     std::string plotFigureName = "FaceRecog - Track Average Scores";
@@ -354,107 +423,84 @@ int main(int argc, char *argv[])
         );
     }
 
-    // Header of results file
-    logResult << "SEQUENCE_TRACK_ID,SEQUENCE_NUMBER,FRAME_NUMBER,TRACK_COUNT,TARGET_COUNT,TRACK_NUMBER,"
-              << "BEST_LABEL,BEST_SCORE_RAW,BEST_SCORE_ACC,ROI_TL_X,ROI_TL_Y,ROI_BR_X,ROI_BR_Y";
-    for (size_t poi = 0; poi < targetCount; ++poi) {
-        std::string spoi = std::to_string(poi);
-        logResult << ",TARGET_LABEL_" + spoi + ",TARGET_SCORE_RAW_" + spoi + ",TARGET_SCORE_ACC_" + spoi;
+    // concurrent test sequences evaluation, each sequence results file is merged in test file order once all are processed
+    if (optArgT && conf->testSequenceWorkers != 1)
+    {
+        bfs::path resultPath(resultFilePath);
+        SequenceEvaluator evaluator(conf.get(), models, opencvSourceDataPathStr);
+        for (size_t s = 0; s < testSequenceRegexPaths.size(); ++s) {
+            std::string sequenceResultPath = (resultPath.parent_path() / bfs::path(resultPath.stem().string() + "_" +
+                                              std::to_string(s) + resultPath.extension().string())).string();
+            evaluator.addSequence(testSequenceRegexPaths[s], testSequenceFileNames[s], sequenceResultPath);
+        }
+
+        logOutput << "Processing " << evaluator.sequenceCount() << " test sequences concurrently..." << std::endl;
+        TP startTime = getTimeNowPrecise();
+        evaluator.run(logResult);
+        double totalTime = getDeltaTimePrecise(startTime, MILLISECONDS);
+        size_t totalFrames = 0;
+        for (size_t s = 0; s < evaluator.sequenceCount(); ++s) {
+            totalFrames += evaluator.getFrameCount(s);
+            logOutput << "Test sequence [" << evaluator.getSequenceID(s) << "] processed frames: " << evaluator.getFrameCount(s)
+                      << ", results: '" << evaluator.getResultPath(s) << "'" << std::endl;
+        }
+        logOutput << "All test sequences processed (" << totalFrames << " frames, " << std::setprecision(3)
+                  << (totalTime > 0 ? (double)totalFrames * 1000.0 / totalTime : 0) << " FPS)." << std::endl;
+        FINALIZE(EXIT_SUCCESS);
     }
-    logResult << std::endl;
 
     /********************************************************************************************************************************************/
     /* LOAD FACE DETECTORS                                                                                                                      */
     /********************************************************************************************************************************************/
-    Association association(conf);
-
-    // main face detector
-    std::shared_ptr<IDetector> faceDetector = buildSpecializedDetector(*conf, opencvSourceDataPathStr, DetectorType::FACE_DETECTOR_GLOBAL);
-    ASSERT_LOG_FINALIZE(faceDetector, "Global face detector not properly initialized", logOutput, EXIT_FAILURE);
-    size_t nFaceModels = faceDetector->modelCount();
-
-    // localized search face detector
-    std::shared_ptr<IDetector> localFaceDetector = buildSpecializedDetector(*conf, opencvSourceDataPathStr, DetectorType::FACE_DETECTOR_LOCAL);
-    size_t nLocalFaceModels = localFaceDetector ? localFaceDetector->modelCount() : 0;
-
-    // left-right eye detectors
-    std::shared_ptr<IDetector> eyesDetector = buildSpecializedDetector(*conf, opencvSourceDataPathStr, DetectorType::EYE_DETECTOR);
-    size_t nEyeModels = eyesDetector ? eyesDetector->modelCount() : 0;
+    DetectorSet detectors = buildDetectorSet(*conf, opencvSourceDataPathStr);
+    size_t nFaceModels = detectors.face->modelCount();
+    size_t nLocalFaceModels = detectors.localFace ? detectors.localFace->modelCount() : 0;
+    size_t nEyeModels = detectors.eyes ? detectors.eyes->modelCount() : 0;
 
     FACE_RECOG_DEBUG(
         for (size_t d = 0; d < nFaceModels; ++d)
-            logOutput << "Loaded global face detector model " << d << ": '" << faceDetector->getModelName(d) << "'" << std::endl;
+            logOutput << "Loaded global face detector model " << d << ": '" << detectors.face->getModelName(d) << "'" << std::endl;
         for (size_t d = 0; d < nLocalFaceModels; ++d)
-            logOutput << "Loaded local face detector model " << d << ": '" << localFaceDetector->getModelName(d) << "'" << std::endl;
+            logOutput << "Loaded local face detector model " << d << ": '" << detectors.localFace->getModelName(d) << "'" << std::endl;
         for (size_t d = 0; d < nEyeModels; ++d)
-            logOutput << "Loaded eye detector model " << d << ": '" << eyesDetector->getModelName(d) << "'" << std::endl;
+            logOutput << "Loaded eye detector model " << d << ": '" << detectors.eyes->getModelName(d) << "'" << std::endl;
     );
 
-    /*TRAKING VECTORS*/
-    int trackNumber = 0;
-    vector<Track> currentTracks, initCandidates, newCandidates;
-    currentTracks.reserve(25);
-    /*DETECTION VECTORS*/
-    vector<cv::Rect> mergedDet, NotMatchedDets, newROIs;
-    vector<size_t> usedDetectorIndexes;
+    // detection, tracking and recognition state of the input stream
+    StreamProcessor processor(conf.get(), models);
+    if (conf->configHotReload)
+        ConfigStore::installReloadSignal();
+    FACE_RECOG_DEBUG(processor.setDebugLog(&logDebug));
+    StreamProcessor::writeResultsHeader(logResult, targetCount);
+
+    // output frames and ROIs written by background threads, dropped rather than delaying processing when overloaded
+    OutputWriter outputWriter(*conf);
+    processor.setOutputWriter(&outputWriter);
 
     /********************************************************************************************************************************************/
     /* IMAGE BUFFERS                                                                                                                            */
     /********************************************************************************************************************************************/
-    // each classifier needs a copy of the input frame
-    FACE_RECOG_MAT frame, frameGray, frameROI;
-
-    // images for writing output (rectangle must be added to drawImg)
-    cv::Mat drawImg(conf->displayWindowH, conf->displayWindowW, CV_8UC3);              // Buffer for display
-    FACE_RECOG_MAT frameVideo(conf->displayWindowH, conf->displayWindowW, CV_8UC3);    // Buffer for reading
-
-    #if FACE_RECOG_HAS_FLYCAPTURE2
-    FlyCapture2::Image pgrRawImage;     // Buffer for reading the raw PGR Image
-    FACE_RECOG_MAT frameRaw;            // Buffer for the non-resized converted image
-    #endif
+    FACE_RECOG_MAT frame;
+    cv::Mat drawImg(conf->displayWindowH, conf->displayWindowW, CV_8UC3);  // Buffer for display
 
     /********************************************************************************************************************************************/
     /* CAPTURE DEVICE (CAMERA/FILES)                                                                                                            */
     /********************************************************************************************************************************************/
     /*Default VideoCapture object used, otherwise try with Point Grey Research FlyCapture2 SDK*/
-    void* videoStream;
+    StreamSource source(*conf);
     bool isVideoOpen = false;
     FACE_RECOG_DEBUG(logDebug << "Camera Type: " << conf->cameraType << std::endl);
 
     /* Index of the camera to use, otherwise the frame sequence is used */
     if (conf->cameraType == CameraType::FILE_STREAM || conf->cameraIndex < 0)               // image files sequence or video file
-    {
-        videoStream = new VideoCapture;
-        isVideoOpen = ((VideoCapture*)videoStream)->open(framesPath);
-        if (isVideoOpen)
-            logOutput << "CV file sequence ready for input..." << std::endl;
-    }
-    else if (conf->cameraType == CameraType::CV_VIDEO_CAPTURE && conf->cameraIndex >= 0)    // camera live-feed
-    {
-        videoStream = new VideoCapture;
+        isVideoOpen = (optArgP || optArgT) ? source.open(framesPath, testSequenceFileNames[0]) : source.open(framesPath);
+    else if (conf->cameraType == CameraType::CV_VIDEO_CAPTURE)                              // camera live-feed
         // ignore config camera index parameters if '-v' enforced via command line
-        if (optArgV)
-            isVideoOpen = ((VideoCapture*)videoStream)->open(framesPath);
-        else
-            isVideoOpen = ((VideoCapture*)videoStream)->open(conf->cameraIndex);
-        if (isVideoOpen) {
-            logOutput << "CV camera ready for capture..." << std::endl;
-            ((VideoCapture*)videoStream)->set(CV_CAP_PROP_FRAME_HEIGHT, conf->displayWindowH);
-            ((VideoCapture*)videoStream)->set(CV_CAP_PROP_FRAME_WIDTH, conf->displayWindowW);
-        }
-    }
-    /*Frame files or auto detect with CV VideoCapture failed, try PG*/
-    else if (conf->cameraType == CameraType::PGR_FLYCAPTURE2 && conf->cameraIndex >= 0)     // PGR camera live-feed
-    {
-        #if !FACE_RECOG_HAS_FLYCAPTURE2
-        logOutput << "Point Grey Research FlyCaputre2 SDK not found, cannot employ camera type specified in 'config.txt'";
-        #else
-        videoStream = new FlyCapture2::Camera;
-        isVideoOpen = (ConnectCameraPGR((FlyCapture2::Camera*)videoStream, conf->cameraIndex, conf->useCameraTrigger) == FlyCapture2::PGRERROR_OK);
-        if (isVideoOpen)
-            logOutput << "PGR camera ready for capture..." << std::endl;
-        #endif /*FACE_RECOG_HAS_FLYCAPTURE2*/
-    }
+        isVideoOpen = optArgV ? source.open(framesPath) : source.open(conf->cameraType, conf->cameraIndex);
+    else if (conf->cameraType == CameraType::PGR_FLYCAPTURE2)                               // PGR camera live-feed
+        isVideoOpen = source.open(conf->cameraType, conf->cameraIndex);
+    if (isVideoOpen)
+        logOutput << "Input stream [" << source.getPath() << "] ready for capture..." << std::endl;
 
     ASSERT_LOG_FINALIZE(conf->cameraType.isDefined(), "Could not identify which camera/files to use as input", logOutput, EXIT_FAILURE);
     ASSERT_LOG_FINALIZE(isVideoOpen, "Failed to open specified video type in config [" + conf->cameraType.name() + "]", logOutput, EXIT_FAILURE);
@@ -474,8 +520,8 @@ int main(int argc, char *argv[])
                 break;
             }
             sequenceTrackID = bfs::path(testSequenceRegexPaths[sequenceCounter]).remove_filename().filename().string();
-            ((VideoCapture*)videoStream)->open(testSequenceRegexPaths[sequenceCounter]);
-            currentTracks.clear();  // reset tracks for starting new sequence
+            source.open(testSequenceRegexPaths[sequenceCounter], testSequenceFileNames[sequenceCounter]);
+            processor.reset();      // reset tracks for starting new sequence
         }
 
         // update frame label or end loop when end reached with input files
@@ -485,698 +531,99 @@ int main(int argc, char *argv[])
         }
         currentFrameLabel = (optArgP || optArgT) ? testSequenceFileNames[sequenceCounter][frameCounter] : std::to_string(frameCounter);
 
-        FACE_RECOG_DEBUG(logDebug << "Delta: " << getDeltaTimePrecise(frameTimePrev, MILLISECONDS) << "ms" << std::endl);
-        frameTimePrev = getTimeNowPrecise();
-
-        if (conf->cameraType == CameraType::CV_VIDEO_CAPTURE || conf->cameraType == CameraType::FILE_STREAM)
-        {
-            // grab next VideoCapture frame
-            if (!((VideoCapture*)videoStream)->read(frameVideo)) {
-                logOutput << "CV camera frame grabbing error: 'VideoCapture::read'" << std::endl;
-                break;
-            }
-        }
-        else if (conf->cameraType == CameraType::PGR_FLYCAPTURE2)
-        {
-            #if FACE_RECOG_HAS_FLYCAPTURE2
-            // Trigger next frame if trigger is employed
-            if (conf->useCameraTrigger)
-                FireTriggerWhenReady((FlyCapture2::Camera*)videoStream, conf->verboseDebug);
-
-            // grab the next FlyCapture2 frame and check for error
-            FlyCapture2::Error cameraError = ((FlyCapture2::Camera*)videoStream)->RetrieveBuffer(&pgrRawImage);
-            if (EvaluateAndPrintCameraError(cameraError, "PGR camera frame grabbing error"))
-            {
-                // if image consistency error, drop the frame and retry, otherwise quit main loop (general error)
-                if (cameraError == FlyCapture2::PGRERROR_IMAGE_CONSISTENCY_ERROR)
-                    continue;
-                else
-                    break;
-            }
-
-            // convert to OpenCV image type
-            ConvertRGBImagePGR2CV(pgrRawImage, frameRaw);
-
-            // preprocessing resize as required
-            if (frameRaw.size() != frameVideo.size())
-                FACE_RECOG_NAMESPACE::resize(frameRaw, frameVideo, frameVideo.size(), 0, 0, cv::INTER_AREA);
-            else
-                frameVideo = frameRaw;
-            #endif /*FACE_RECOG_HAS_FLYCAPTURE2*/
-        }
-
-        // Mirror image for display if using a camera video stream and if the option was set
-        if (conf->displayFrames && conf->flipFrames && conf->cameraType != CameraType::FILE_STREAM)
-            frameVideo = imFlip(frameVideo, FlipMode::HORIZONTAL);
-
-        // Upload to GPU for processing
-        #if FACE_RECOG_USE_CUDA
-        frame.upload(frameVideo);
-        #else
-        frame = frameVideo; // pass directly
-        #endif
-
-        // grayscale
-        FACE_RECOG_NAMESPACE::cvtColor(frame, frameGray, CV_BGR2GRAY);
-
-        bool isNewDetection = frameCounter == 0 || frameCounter % conf->detectionFrameInterval == 0;
-
-        //========================================================================================================================================
-        // FACE DETECTION
-        //========================================================================================================================================
-        if (isNewDetection)
-        {
-            FACE_RECOG_DEBUG(frameTime = getTimeNowPrecise());
-
-            faceDetector->assignImage(frameGray);
-            faceDetector->detectMerge(mergedDet);
-
-            FACE_RECOG_DEBUG(
-                deltaTime = getDeltaTimePrecise(frameTime, MILLISECONDS);
-                sumTimeDetect += deltaTime;
-                logDebug << setprecision(3) << "detection time: " << deltaTime << " ms" << std::endl;
-            );
-
-            // reinit candidates
-            for (size_t i = 0; i < initCandidates.size(); ++i)
-                initCandidates[i].markNotMatched();
-
-            for (size_t i = 0; i < mergedDet.size(); ++i)
-            {
-                int initX = mergedDet[i].x;
-                int initY = mergedDet[i].y;
-
-                mergedDet[i].x = (mergedDet[i].x - conf->detectionAugmentationOffset >= 0)
-                    ? mergedDet[i].x - conf->detectionAugmentationOffset
-                    : 0;
-                mergedDet[i].y = (mergedDet[i].y - conf->detectionAugmentationOffset >= 0)
-                    ? mergedDet[i].y - conf->detectionAugmentationOffset
-                    : 0;
-                mergedDet[i].width = (mergedDet[i].x + mergedDet[i].width + conf->detectionAugmentationOffset * 2 <= frame.cols)
-                    ? mergedDet[i].width + conf->detectionAugmentationOffset * 2
-                    : frame.cols - initX;
-                mergedDet[i].height = (mergedDet[i].y + mergedDet[i].height + conf->detectionAugmentationOffset * 2 <= frame.rows)
-                    ? mergedDet[i].height + conf->detectionAugmentationOffset * 2
-                    : frame.rows - initY;
-
-                FACE_RECOG_DEBUG(logDebug << "END -- mergedDet " << i << ": " << mergedDet[i] << std::endl);
-            }
-
-            // for performance evaluation
-            ++totalFramesDetect;
-        }
-
-        //========================================================================================================================================
-        // TRACKING
-        //========================================================================================================================================
-        // internal image representation for trackers
-        // ImageRep image(frameGray, 1, 0);
-        ImageRep image(GET_MAT(frame, ACCESS_READ), 1, 0);
-
-        if (frameCounter == 0)
-        {
-            for (size_t i = 0; i < mergedDet.size(); ++i) {
-                Track track(conf, mergedDet[i], trackNumber++);
-                track.reInitTracking(image);
-                currentTracks.push_back(track);
-            }
+        // apply reloaded runtime parameters between frames (previous snapshot remains valid for existing tracks)
+        if (conf->configHotReload && configStore.poll(logOutput)) {
+            conf = configStore.current();
+            processor.updateConfig(conf);
         }
-        else
-        {
-            //------------------------------------------------------------------------------------------------------------------------------------
-            // TRACKING CURRENT TRACKS
-            //------------------------------------------------------------------------------------------------------------------------------------
-            FACE_RECOG_DEBUG(frameTime = getTimeNowPrecise());
-            #pragma omp parallel for
-            for (long i = 0; i < currentTracks.size(); ++i) {
-                currentTracks[i].track(image);
-                currentTracks[i].markNotMatched();   // no match with detection
-            }
-            FACE_RECOG_DEBUG(sumTimeTrack += getDeltaTimePrecise(frameTime, MILLISECONDS));
-        }
-
-        //----------------------------------------------------------------------------------------------------------------------------------------
-        // RECENTER TRACKERS
-        //----------------------------------------------------------------------------------------------------------------------------------------
-        usedDetectorIndexes.clear();
-        if (isNewDetection)
-        {
-            // MATCH DETECTOR WITH TRACKER IF IoU > thresh
-            FACE_RECOG_DEBUG(logDebug << "Number of detections = " << mergedDet.size() << std::endl);
-            cv::Rect currentResizedTrackBbox;
-            cv::Rect currentResizedMergedDetBbox;
-            //////////////////////////////////////////////// #pragma omp parallel for // Problem caused by concurent removal of tracks
-            for (size_t i = 0; i < currentTracks.size(); ++i)
-            {
-                for (size_t j = 0; j < mergedDet.size(); ++j)
-                {
-                    int maxSize = std::max(currentTracks[i].bbox().width, mergedDet[j].width);
-                    currentResizedTrackBbox = util::getConstSizedRect(currentTracks[i].bbox(), maxSize, frame.size());
-                    currentResizedMergedDetBbox = util::getConstSizedRect(mergedDet[j], maxSize, frame.size());
-                    FACE_RECOG_DEBUG(
-                        logDebug << "Track #" << i << std::endl;
-                        logDebug << "Overlap Resized: " << util::overlap(currentResizedTrackBbox, currentResizedMergedDetBbox) << std::endl;
-                        logDebug << "Overlap Original: " << util::overlap(currentTracks[i].bbox(), mergedDet[j]) << std::endl;
-                        logDebug << "InitTrack: " << currentTracks[i].bbox() << std::endl;
-                        logDebug << "Init Merged Det: " << mergedDet[j] << std::endl;
-                        logDebug << "Resized Track Det: " << currentResizedTrackBbox << std::endl;
-                        logDebug << "Resized Merged Det: " << currentResizedMergedDetBbox << std::endl;
-                    );
-                    if (util::intersect(currentResizedTrackBbox, currentResizedMergedDetBbox, conf->face.overlapThreshold)) {
-                        currentTracks[i].insertROI(mergedDet[j]);
-                        currentTracks[i].reInitTracking(image);
-                        currentTracks[i].markMatched();
-                        usedDetectorIndexes.push_back(j);
-                        FACE_RECOG_DEBUG(
-                            logDebug << "Over " << conf->face.overlapThreshold << " overlap" << std::endl;
-                            logDebug << "using Detector: " << j << std::endl;
-                        );
-                    }
-                }
-            }
 
-            for (size_t i = 0; i < currentTracks.size(); ++i)
-            {
-                FACE_RECOG_DEBUG(
-                    logDebug << "Number of tracks: " << i << "/" << currentTracks.size() << std::endl;
-                    logDebug << "Current track " << i << " is matched: " << currentTracks[i].isMatched() << std::endl;
-                );
-                if (!currentTracks[i].isMatched())
-                {
-                    double maxConfidence = faceDetector->evaluateConfidence(currentTracks[i], frameGray);
-                    bool onImageEdge = (currentTracks[i].bbox().x == 0 || currentTracks[i].bbox().y == 0 ||
-                                        currentTracks[i].bbox().x + currentTracks[i].bbox().width == frame.cols ||
-                                        currentTracks[i].bbox().y + currentTracks[i].bbox().height == frame.rows);
-                    FACE_RECOG_DEBUG(
-                        logDebug << "Max confidence for track " << currentTracks[i].getTrackNumber() << " = " << maxConfidence << std::endl;
-                        if (onImageEdge)
-                            logDebug << "BBOX " << i << " is on edge of image" << std::endl;
-                    );
-                    if ((maxConfidence <= conf->removeTrackConfidenceOutBounds && onImageEdge) ||
-                        (maxConfidence <= conf->removeTrackConfidenceInBounds)) {
-                        currentTracks[i].increaseRemoveCount();
-                        FACE_RECOG_DEBUG(logDebug << "Remove count = " << currentTracks[i].getRemoveCount() << std::endl);
-                    }
-                    else {
-                        FACE_RECOG_DEBUG(logDebug << "Remove count to zero" << std::endl);
-                        currentTracks[i].setRemoveCount(0);
-                    }
-                }
-            }
-
-            for (size_t i = 0; i < currentTracks.size(); ++i)
-            {
-                //--------------------------------------------------------------------------------------------------------------------------------
-                // CHECK FOR TRACK REMOVAL
-                //--------------------------------------------------------------------------------------------------------------------------------
-                for (std::vector<Track>::iterator iter = currentTracks.begin(); iter != currentTracks.end();)
-                {
-                    FACE_RECOG_DEBUG(
-                        logDebug << "RemoveCount: " << (*iter).getRemoveCount() << std::endl;
-                        logDebug << "RemoveThresh: " << conf->removeTrackCountThresholdOutBounds << std::endl;
-                    );
-                    if ((*iter).getRemoveCount() >= conf->removeTrackCountThresholdOutBounds) {
-                        if (conf->useFaceRecognition)
-                            accScores.removeTrackScores(iter->getTrackNumber());
-                        iter = currentTracks.erase(iter);
-                        FACE_RECOG_DEBUG(logDebug << "Removing track" << std::endl);
-                    }
-                    else
-                        ++iter;
-                }
-            }
-        }
-
-        //----------------------------------------------------------------------------------------------------------------------------------------
-        // ADD NEW CANDIDATES
-        //----------------------------------------------------------------------------------------------------------------------------------------
-        if (isNewDetection)
-        {
-            // Create unmatched detections
-            for (size_t i = 0; i < mergedDet.size(); ++i)
-            {
-                if (find(usedDetectorIndexes.begin(), usedDetectorIndexes.end(), i) == usedDetectorIndexes.end()) {
-                    NotMatchedDets.push_back(mergedDet[i]);
-                    FACE_RECOG_DEBUG(logDebug << "Not Matched with Detector: " << i << std::endl);
-                }
-            }
-            for (size_t i = 0; i < initCandidates.size(); ++i)
-                initCandidates[i].markNotMatched();
-
-            if ((initCandidates.size() >= 1) || (NotMatchedDets.size() >= 1))
-            {
-                //--------------------------------------------------------------------------------------------------------------------------------
-                // HUNGARIAN MATCHING
-                //--------------------------------------------------------------------------------------------------------------------------------
-                frameTime = getTimeNowPrecise();
-                if (conf->useHungarianMatching)
-                {
-                    association.extendSet(initCandidates, NotMatchedDets);
-                    association.computeCost(initCandidates, NotMatchedDets);
-                    association.matchCandidates(initCandidates, NotMatchedDets, newCandidates);
-                    /*REMOVE FAKE TRACKS*/
-                    association.reduceSet(initCandidates);
-                }
-                else
-                {
-                    for (size_t i = 0; i < NotMatchedDets.size(); ++i)
-                    {
-                        Track newTrack(conf, NotMatchedDets[i]);
-                        newCandidates.push_back(newTrack);
-                    }
-                }
-                FACE_RECOG_DEBUG(
-                    deltaTime = getDeltaTimePrecise(frameTime, MICROSECONDS);
-                    logDebug << setprecision(3) << "matching time: " << deltaTime << " ms" << std::endl;
-                    logDebug << "Number of new candidates: " << newCandidates.size() << std::endl;
-                );
-
-                //--------------------------------------------------------------------------------------------------------------------------------
-                // ADD NEW CANDIDATES (from this frame)
-                //--------------------------------------------------------------------------------------------------------------------------------
-                for (size_t i = 0; i < newCandidates.size(); ++i)
-                    initCandidates.push_back(newCandidates[i]);
-                newCandidates.clear();  // clear the set of candidates from current frame
-                NotMatchedDets.clear(); // clear unmatched detections from current frame
-
-                //--------------------------------------------------------------------------------------------------------------------------------
-                // EVALUATE CONFIDENCE OF INIT CANDIDATES
-                //--------------------------------------------------------------------------------------------------------------------------------
-                for (size_t i = 0; i < initCandidates.size(); ++i)
-                {
-                    double maxConfidence = faceDetector->evaluateConfidence(initCandidates[i], frameGray);
-                    FACE_RECOG_DEBUG(
-                        logDebug << "Max confidence for candidate " << i << " = " << maxConfidence << std::endl;
-                        logDebug << "initCandidates: " << initCandidates[i].bbox() << std::endl;
-                    );
-                    if (maxConfidence > conf->createTrackConfidenceThreshold) {
-                        initCandidates[i].increaseCreateCount();
-                        FACE_RECOG_DEBUG(logDebug << "Create count = " << initCandidates[i].getCreateCount() << std::endl);
-                    }
-                    else
-                        initCandidates[i].setCreateCount(-1);
-                }
-            }
-
-            // loop over candidates for track creation
-            for (std::vector<Track>::iterator iter = initCandidates.begin(); iter != initCandidates.end();)
-            {
-                if ((*iter).getCreateCount() >= conf->createTrackCountThreshold)
-                {
-                    // reset creation counter
-                    (*iter).setCreateCount(0);
-                    (*iter).reInitTracking(image);
-                    // add to current tracks
-                    (*iter).setTrackNumber(trackNumber++);
-                    (*iter).setTrackSize(conf->roiAccumulationSize);
-                    currentTracks.push_back((*iter));
-                    // remove from candidates
-                    iter = initCandidates.erase(iter);
-                    FACE_RECOG_DEBUG(logDebug << "Created track" << std::endl);
-                }
-                else if ((*iter).getCreateCount() == -1)
-                    iter = initCandidates.erase(iter);
-                else
-                    ++iter; // otherwise, just keep among the candidates
-            }
-        }
-        util::mergeOverlappingTracks(currentTracks, conf->trackerOverlapThreshold, frameGray);
-
-        //========================================================================================================================================
-        // LOCAL FACE DETECTION
-        //========================================================================================================================================
+        FACE_RECOG_DEBUG(logDebug << "Delta: " << getDeltaTimePrecise(frameTimePrev, MILLISECONDS) << "ms" << std::endl);
+        frameTimePrev = getTimeNowPrecise();
 
-        // update track matched with detection if using local search and validated
-        if (conf->useLocalSearchROI)
-        {
-            FACE_RECOG_DEBUG(frameTime = getTimeNowPrecise());
-            for (size_t i = 0; i < currentTracks.size(); ++i)
-            {
-                //--------------------------------------------------------------------------------------------------------------------------------
-                // LOCALIZED ROI SEARCH
-                //--------------------------------------------------------------------------------------------------------------------------------
-
-                FACE_RECOG_DEBUG(
-                    logDebug << "NEW LOCAL SEARCH ROI ==================================================" << std::endl;
-                    TP frameTimeLocal = getTimeNowPrecise();
-                );
-
-                // expand ROI by a config factor to give more slack for local search detection
-                // access contained VJ face detector to update parameters for local search (mostly for maxSize)
-                int expandedMaxSize = (int)(currentTracks[i].bbox().width * conf->bboxSizeMultiplyer);
-                std::shared_ptr<FaceDetectorVJ> vj(std::static_pointer_cast<FaceDetectorVJ>(localFaceDetector));
-                cv::Size expandedMaxSizeROI = cv::Size(expandedMaxSize, expandedMaxSize);
-                vj->initializeParameters(conf->face.scaleFactor, conf->face.nmsThreshold, conf->face.minSize, expandedMaxSizeROI,
-                                         conf->face.confidenceSize, conf->face.minNeighbours, conf->face.overlapThreshold);
-
-                // update max size with enlarged bbox for localized search
-                cv::Rect localSearchBBox = util::getConstSizedRect(currentTracks[i].bbox(), expandedMaxSize, frame.size());
-                frameROI = FACE_RECOG_MAT(frameGray, localSearchBBox);
-
-                // execute localize search to find faces ROI
-                std::vector<std::vector<cv::Rect> > localComboFaces(nLocalFaceModels);
-                localFaceDetector->assignImage(frameROI);
-                localFaceDetector->detect(localComboFaces);
-                newROIs = localFaceDetector->mergeDetections(localComboFaces);
-
-                FACE_RECOG_DEBUG(
-                    logDebug << "current bbox: " << currentTracks[i].bbox() << std::endl;
-                    logDebug << "local bbox: " << localSearchBBox << std::endl;
-                    logDebug << "NB CC Local: " << nLocalFaceModels << std::endl;
-                    logDebug << "combo size: " << localComboFaces.size() << std::endl;
-                    logDebug << "localComboFaces: " << std::endl;
-                    for (size_t ci = 0; ci < localComboFaces.size(); ++ci)
-                        for (size_t cj = 0; cj < localComboFaces[ci].size(); ++cj)
-                            logDebug << "(ci=" << ci << ",cj=" << cj << "): " << localComboFaces[ci][cj] << std::endl;
-                    logDebug << "newROIs: " << std::endl;
-                    for (size_t ci = 0; ci < newROIs.size(); ++ci)
-                        logDebug << "(ci=" << ci << "): " << newROIs[ci] << std::endl;
-                    if (newROIs.size() > 0) {
-                        for (size_t c = 0; c < nLocalFaceModels; ++c) {
-                            if (newROIs[c].area() > 0) {
-                                logDebug << "combo bbox[" << c << "]: " << localComboFaces[c] << std::endl;
-                                logDebug << "newROI[" << c << "]: " << newROIs[c] << std::endl;
-                                std::string roiName = currentFrameLabel + "_c=" + std::to_string(c);
-                                cv::Rect roiAbsPos = newROIs[c];
-                                roiAbsPos.x += localSearchBBox.x;
-                                roiAbsPos.y += localSearchBBox.y;
-                            }
-                            else
-                                logDebug << "combo bbox[" << c << "]: [empty (area !> 0)]" << std::endl;
-                        }
-                    }
-                    logDebug << "old roi: " << currentTracks[i].bbox() << std::endl;
-                    logDebug << "expandedMaxSize: " << expandedMaxSize << std::endl;
-                    logDebug << "new roi: " << localSearchBBox << std::endl;
-                    logDebug << newROIs.size() << " detections in bbox region" << std::endl;
-                );
-
-                //--------------------------------------------------------------------------------------------------------------------------------
-                // MERGE ORIGINAL AND LOCALIZED ROI
-                //--------------------------------------------------------------------------------------------------------------------------------
-
-                // Go through detection and find the closest one from the original detection (best match IoU)
-                cv::Rect currentResizedTrackBbox, currentResizedROI;
-                int bestJ = -1;
-                double bestIoU = -1, tempIoU;
-                for (size_t j = 0; j < newROIs.size(); ++j)
-                {
-                    // get absolute position on frame
-                    newROIs[j].x += localSearchBBox.x;
-                    newROIs[j].y += localSearchBBox.y;
-
-                    int maxSize = std::max(currentTracks[i].bbox().width, newROIs[j].width);
-                    currentResizedTrackBbox = util::getConstSizedRect(currentTracks[i].bbox(), maxSize, frame.size());
-                    currentResizedROI = util::getConstSizedRect(newROIs[j], maxSize, frame.size());
-
-                    tempIoU = util::overlap(currentResizedROI, currentResizedTrackBbox);
-                    if (tempIoU > bestIoU) {
-                        bestIoU = tempIoU;
-                        bestJ = (int)j;
-                    }
-                    FACE_RECOG_DEBUG(
-                        logDebug << "Match j=" << j << ": " << newROIs[j] << std::endl;
-                        logDebug << "Current Track: " << currentTracks[i].bbox() << std::endl;
-                        logDebug << "RESIZED - Match: " << currentResizedTrackBbox << std::endl;
-                        logDebug << "RESIZED - Current Track: " << currentResizedROI << std::endl;
-                        logDebug << "TEMP IOU: " << tempIoU << std::endl;
-                    );
-                }
-                FACE_RECOG_DEBUG(logDebug << "Best IOU: " << bestIoU << std::endl);
-
-                if (bestIoU > 0) {
-                    // update latest ROI with adjusted local search bbox
-                    ROI roi = currentTracks[i].getROI();
-                    roi.updateROI(newROIs[bestJ]);
-                    currentTracks[i].updateROI(roi);
-                    currentTracks[i].reInitTracking(image);
-                    currentTracks[i].markMatched();
-                    FACE_RECOG_DEBUG(
-                        logDebug << "Match: " << newROIs[bestJ] << std::endl;
-                        logDebug << "CHANGED BBOX LOCALIZED SEARCH" << std::endl;
-                    );
-                }
-                FACE_RECOG_DEBUG(
-                    deltaTime = getDeltaTimePrecise(frameTimeLocal, MICROSECONDS);
-                    logDebug << "Delta-Time localized ROI search: " << deltaTime << " ms" << std::endl;
-                );
-                ++totalFramesDetectLocal;
-            }
-            FACE_RECOG_DEBUG(
-                deltaTime = getDeltaTimePrecise(frameTime, MILLISECONDS);
-                sumTimeDetectLocal += deltaTime;
-            );
+        // grab next frame (camera errors are retried by the source when recoverable)
+        if (!source.read(frame)) {
+            logOutput << "Frame grabbing error from input stream [" << source.getPath() << "]" << std::endl;
+            break;
         }
 
         //========================================================================================================================================
-        // EYE DETECTION
+        // FACE DETECTION, TRACKING AND RECOGNITION
         //========================================================================================================================================
-        if (conf->useEyesDetection && currentTracks.size() > 0)
-        {
-            FACE_RECOG_DEBUG(logDebug << "Eye detection: " << currentTracks.size() << " tracks" << std::endl);
-
-            for (size_t i = 0; i < currentTracks.size(); ++i)
-            {
-                ROI roi = currentTracks[i].getROI(); // Get most recent ROI without eyes
-                #pragma omp parallel for
-                for (long iDet = 0; iDet < nEyeModels; ++iDet)
-                {
-                    // Get the search area, either the full face ROI or localized position if specified
-                    cv::Rect searchArea = roi.getRect();
-                    if (conf->useEyeLocalizedPosition) {
-                        std::shared_ptr<EyeDetector> eyesDetSpec = std::static_pointer_cast<EyeDetector>(eyesDetector);
-                        // Top-Left 1/4 of face ROI (or Right if frame is flipped)
-                        if ((iDet == eyesDetSpec->leftEyeIndex && !conf->flipFrames) || (iDet == eyesDetSpec->rightEyeIndex && conf->flipFrames))
-                            searchArea = cv::Rect(searchArea.x, searchArea.y, searchArea.width / 2, searchArea.height / 2);
-                        // Top-Right 1/4 of face ROI (or Left if frame is flipped)
-                        if ((iDet == eyesDetSpec->rightEyeIndex && !conf->flipFrames) || (iDet == eyesDetSpec->leftEyeIndex && conf->flipFrames))
-                            searchArea = cv::Rect(searchArea.x + searchArea.width / 2, searchArea.y, searchArea.width / 2, searchArea.height / 2);
-                    }
-                    eyesDetector->assignImage(FACE_RECOG_MAT(frameGray, searchArea));
-                }
-                // Find eyes with each eye detector and add them to the current ROI
-                vector<vector<cv::Rect> > eyes;
-                eyesDetector->detect(eyes);
-                for (size_t iEye = 0; iEye < eyes.size(); ++iEye) {
-                    for (size_t jEye = 0; jEye < eyes[iEye].size(); ++jEye) {
-                        roi.addSubRect(eyes[iEye][jEye]);
-                        currentTracks[i].setValidateEyeDetection();
-                    }
-                }
-                currentTracks[i].updateROI(roi); // update current ROI with eyes added
-            }
+        processor.process(frame, detectors);
+        std::vector<Track>& currentTracks = processor.getTracks();
+        CircularBuffer& accScores = processor.getScores();
+
+        // outputs time is added to the load of the next frame, non-essential outputs are skipped under load
+        TP outputStartTime = getTimeNowPrecise();
+        const LoadSheddingScheduler& loadShedding = processor.getLoadShedding();
+        bool skipOutputs = loadShedding.isShedding(LoadSheddingScheduler::SKIP_OUTPUTS);
+        if (loadShedding.getLevel() != loadSheddingLevel) {
+            loadSheddingLevel = loadShedding.getLevel();
+            logOutput << "Load shedding level changed to " << LoadSheddingScheduler::levelName(loadSheddingLevel)
+                      << " at frame " << currentFrameLabel << " (average frame time: " << loadShedding.getAverageTime() << "ms)" << std::endl;
         }
 
-        //========================================================================================================================================
-        // FACE RECOGNITION
-        //========================================================================================================================================
-        if (conf->useFaceRecognition)
-        {
-            for (size_t i = 0; i < currentTracks.size(); ++i)
-            {
-                // skip probe if not validated with requested methods
-                if (conf->useLocalSearchROI && !currentTracks[i].getROI().isUpdatedROI() && !currentTracks[i].isUnknown()) {
-                    currentTracks[i].markUnknown();
-                    continue;
-                }
-                if (conf->useEyesDetection && !currentTracks[i].isValidatedEyeDetection() && !currentTracks[i].isUnknown()) {
-                    currentTracks[i].markUnknown();
-                    continue;
-                }
-
-                //--------------------------------------------------------------------------------------------------------------------------------
-                // PREDICT RECOGNITION SCORES
-                //--------------------------------------------------------------------------------------------------------------------------------
-
-                int currentTrackNum = currentTracks[i].getTrackNumber();
-                FACE_RECOG_MAT probeROI = frame(currentTracks[i].bbox());
-                std::vector<double> predictions(classifier->predict(probeROI));
-                predictions = classifier->predict(probeROI);
-                accScores.addPredictions(currentTrackNum, predictions);
-
-                FACE_RECOG_DEBUG(
-                    for (size_t pos = 0; pos < predictions.size(); ++pos) {
-                        double acc = accScores.getScore(conf->roiAccumulationMode, currentTrackNum, pos);
-                        if (minScores[pos] > predictions[pos])
-                            minScores[pos] = predictions[pos];
-                        if (maxScores[pos] < predictions[pos])
-                            maxScores[pos] = predictions[pos];
-
-                        logDebug << "TRACK #" << currentTrackNum << " i: " << pos << " fileName: " << POI_IDs[pos];
-                        logDebug << setprecision(6) << " accPred: " << acc << " lastPred: " << predictions[pos];
-                        logDebug << setprecision(6) << setprecision(6) << " min: " << minScores[pos] << " max: " << maxScores[pos] << std::endl;
-                    }
-                );
-
-                //--------------------------------------------------------------------------------------------------------------------------------
-                // UPDATE TARGET RECOGNITIONS
-                //--------------------------------------------------------------------------------------------------------------------------------
-
-                double bestGuestTargetScore; int bestGuestTargetIndex;
-                accScores.getMaxPositiveInfo(conf->roiAccumulationMode, currentTrackNum, bestGuestTargetIndex, bestGuestTargetScore);
-                if (bestGuestTargetIndex >= 0) {
-                    if (bestGuestTargetScore >= conf->thresholdFaceRecognized) {
-                        FACE_RECOG_DEBUG(logDebug << "bestGuestPos (recognized): " << bestGuestTargetIndex << std::endl);
-                        currentTracks[i].markRecognized();
-                        currentTracks[i].setName(POI_IDs[bestGuestTargetIndex]);
-                    }
-                    else if (bestGuestTargetScore >= conf->thresholdFaceConsidered) {
-                        FACE_RECOG_DEBUG(logDebug << "bestGuestPos (considered): " << bestGuestTargetIndex << std::endl);
-                        currentTracks[i].markConsidered();
-                        currentTracks[i].setName(POI_IDs[bestGuestTargetIndex]);
-                    }
-                    else {
-                        currentTracks[i].markUnknown();
-                        currentTracks[i].setName("");
-                    }
-                }
-            }
-
-            FACE_RECOG_DEBUG(
-                if (currentTracks.size() == 0)
-                    logOutBBox << currentFrameLabel << getDeltaTimePrecise(frameTimePrev, MILLISECONDS) << "-1 0 0 0 0" << std::endl;
-            );
-        }
+        FACE_RECOG_DEBUG(
+            if (conf->useFaceRecognition && currentTracks.size() == 0)
+                logOutBBox << currentFrameLabel << getDeltaTimePrecise(frameTimePrev, MILLISECONDS) << "-1 0 0 0 0" << std::endl;
+        );
 
         //========================================================================================================================================
         // DISPLAY & OUTPUT
         //========================================================================================================================================
 
+        // output recognition results to CSV file
+        processor.writeResults(logResult, sequenceTrackID, sequenceCounter, currentFrameLabel);
+
         // Must transfer back from GPU to draw on image
-        if (conf->displayFrames || conf->outputFrames) {
+        if (conf->displayFrames || (conf->outputFrames && !skipOutputs))
+        {
             #if FACE_RECOG_USE_CUDA
             frame.download(drawImg);
             #else
             frame.copyTo(drawImg);
             #endif
-        }
-
-        // output recognition results 'start of line' to CSV file (generic information)
-        //      SEQUENCE_TRACK_ID,SEQUENCE_NUMBER,FRAME_NUMBER,TRACK_COUNT,TARGET_COUNT
-        size_t trackCount = currentTracks.size();
-        logResult << sequenceTrackID << "," << sequenceCounter << "," << currentFrameLabel << "," << trackCount << "," << targetCount;
 
-        for (size_t i = 0; i < trackCount; ++i)
-        {
-            //------------------------------------------------------------------------------------------------------------------------------------
-            // UPDATE DISPLAY OF TARGET ROI & RECOGNITION INFO
-            //------------------------------------------------------------------------------------------------------------------------------------
-
-            if (conf->displayFrames || conf->outputFrames)
-            {
-                // either unused eye detection or required eyes are validated
-                bool eyeOK = !conf->useEyesDetection || currentTracks[i].isValidatedEyeDetection();
-                // display original ROI before update if available and requested
-                bool showUpdate = conf->useLocalSearchROI && conf->displayOldROI && currentTracks[i].getROI().isUpdatedROI();
-
-                ColorCode color = (eyeOK && currentTracks[i].isRecognized()) ? bboxColorRecognized  // Recognized
-                                : (eyeOK && currentTracks[i].isConsidered()) ? bboxColorConsidered  // Considered
-                                : bboxColorNotMatched;                                              // NotMatched | no eyes
-
-                // draw old face ROI (original detection)
-                if (showUpdate)
-                    cv::rectangle(drawImg, currentTracks[i].getROI().getOriginalRect(), color, conf->roiThicknessOld);
-                // draw updated face ROI and text index
-                cv::rectangle(drawImg, currentTracks[i].bbox(), color, conf->roiThickness);
-
-                // display recognition score and target ID
-                int bestPosIndex = -1; double bestPosScore = 0;
-                if (conf->useFaceRecognition) {
-                    accScores.getMaxPositiveInfo(conf->roiAccumulationMode, currentTracks[i].getTrackNumber(), bestPosIndex, bestPosScore);
-                    if ((currentTracks[i].isRecognized() || currentTracks[i].isConsidered()) && bestPosIndex >= 0) {
-                        std::string strTargetTagAndScore = POI_IDs[bestPosIndex] + " | " + std::to_string(bestPosScore);
-                        Point point = Point(currentTracks[i].bbox().x, currentTracks[i].bbox().y + currentTracks[i].bbox().height + 15);
-                        cv::putText(drawImg, strTargetTagAndScore, point, FONT_HERSHEY_PLAIN, 1.0, color, 2);
-                    }
-                }
+            // target ROI & recognition info
+            processor.drawTracks(drawImg, bboxColors);
 
-                /*  output rest of recognition results as CSV:
-                        {<results>(i)}     for i=TRACK_COUNT
-                    where each <results>(i):
-                        ,TRACK_NUMBER,BEST_LABEL,BEST_SCORE_RAW,BEST_SCORE_ACC,
-                        ROI_TL_X,ROI_TL_Y,ROI_BR_X,ROI_BR_Y{<result_target>(j)}     for j=TARGET_COUNT
-                    where each <result_target>(j):
-                        ,TARGET_LABEL,TARGET_SCORE_RAW,TARGET_SCORE_ACC
-                */
-                if (optArgR) {
-                    cv::Point tl = currentTracks[i].bbox().tl();
-                    cv::Point br = currentTracks[i].bbox().br();
-                    size_t trackNumer = currentTracks[i].getTrackNumber();
-                    std::string targetsLabelScores;
-                    std::string bestPosID;
-                    double bestRawScore = -1;
-                    if (conf->useFaceRecognition) {
-                        bestPosID = POI_IDs[bestPosIndex];
-                        bestRawScore = accScores.getRawScore(trackNumer, bestPosIndex);
-                        for (size_t j = 0; j < targetCount; ++j) {
-                            targetsLabelScores += ("," + POI_IDs[j] + "," + std::to_string(accScores.getRawScore(trackNumer, j)) +
-                                                   "," + std::to_string(accScores.getScore(conf->roiAccumulationMode, trackNumer, j)));
-                        }
-                    }
-                    logResult << "," << trackNumer << "," << bestPosID << "," << bestRawScore << "," << bestPosScore;
-                    logResult << "," << tl.x << "," << tl.y << "," << br.x << "," << br.y << targetsLabelScores;
-                }
-
-                // display sequence track ID, frame number and FPS where applicable and as requested
-                int offset = 16;
-                if (optArgT && conf->displaySequenceTrackID) {
-                    cv::putText(drawImg, sequenceTrackID, Point(8, offset), FONT_HERSHEY_PLAIN, 1.0, rgbColorCode(ColorType::LIGHT_GREEN), 2);
-                    offset += 16;
-                }
-                if (conf->displayFrameNumber) {
-                    cv::putText(drawImg, currentFrameLabel, Point(8, offset), FONT_HERSHEY_PLAIN, 1.0, rgbColorCode(ColorType::LIGHT_GREEN), 2);
+            // display sequence track ID, frame number and FPS where applicable and as requested
+            int offset = 16;
+            if (optArgT && conf->displaySequenceTrackID) {
+                cv::putText(drawImg, sequenceTrackID, Point(8, offset), FONT_HERSHEY_PLAIN, 1.0, rgbColorCode(ColorType::LIGHT_GREEN), 2);
+                offset += 16;
+            }
+            if (conf->displayFrameNumber) {
+                cv::putText(drawImg, currentFrameLabel, Point(8, offset), FONT_HERSHEY_PLAIN, 1.0, rgbColorCode(ColorType::LIGHT_GREEN), 2);
+                offset += 16;
+            }
+            if (conf->displayFrameRate) {
+                deltaTime = getDeltaTimePrecise(frameTimePrev, MICROSECONDS);
+                if (deltaTime > 0.0) {
+                    std::ostringstream fps;
+                    fps << "FPS " << std::fixed << std::showpoint << std::setprecision(2) << (1000000.0 / deltaTime);
+                    cv::putText(drawImg, fps.str(), Point(8, offset), FONT_HERSHEY_PLAIN, 1.0, rgbColorCode(ColorType::LIGHT_GREEN), 2);
                     offset += 16;
                 }
-                if (conf->displayFrameRate) {
-                    deltaTime = getDeltaTimePrecise(frameTimePrev, MICROSECONDS);
-                    if (deltaTime > 0.0) {
-                        std::ostringstream fps;
-                        fps << "FPS " << std::fixed << std::showpoint << std::setprecision(2) << (1000000.0 / deltaTime);
-                        cv::putText(drawImg, fps.str(), Point(8, offset), FONT_HERSHEY_PLAIN, 1.0, rgbColorCode(ColorType::LIGHT_GREEN), 2);
-                        offset += 16;
-                    }
-                }
-
-                // display track number
-                FACE_RECOG_DEBUG(logDebug << "TRACK NUMBER test " << currentTracks[i].getTrackNumber() << std::endl);
-                std::string strTrackerNumber = format("#%u", currentTracks[i].getTrackNumber());
-                Point point = Point(currentTracks[i].bbox().x, currentTracks[i].bbox().y - 10);
-                cv::putText(drawImg, strTrackerNumber, point, FONT_HERSHEY_PLAIN, 1.0, color, 2);
-
-                // draw eyes ROI
-                if (conf->useEyesDetection) {
-                    ROI roi = currentTracks[i].getROI();
-                    ColorCode darkColor = color / 2;
-                    size_t nEyes = roi.countSubROI();
-                    FACE_RECOG_DEBUG(logDebug << "Number of eyes found: " << nEyes << std::endl);
-                    for (size_t iEye = 0; iEye < nEyes; ++iEye)
-                        cv::rectangle(drawImg, roi.getSubRect(iEye), darkColor, 2);
-                }
             }
+        }
 
-            //------------------------------------------------------------------------------------------------------------------------------------
-            // OUTPUT REQUESTED TARGET ROI
-            //------------------------------------------------------------------------------------------------------------------------------------
-
-            if (conf->outputROI)
-                util::saveTrackROIToDisk(currentTracks[i].getROI().getOriginalRect(), frameGray, currentFrameLabel,
-                                         currentTracks[i].getTrackNumber(), conf->roiOutputSize, imgDir);
-
-            if (conf->outputLocalROI)
-                util::saveTrackROIToDisk(currentTracks[i].bbox(), frameGray, currentFrameLabel,
-                                         currentTracks[i].getTrackNumber(), conf->roiOutputSize, imgDirLocal);
+        //----------------------------------------------------------------------------------------------------------------------------------------
+        // OUTPUT REQUESTED TARGET ROI
+        //----------------------------------------------------------------------------------------------------------------------------------------
+        if (!skipOutputs)
+            processor.saveTrackROIs(currentFrameLabel, imgDir, imgDirLocal);
 
-            FACE_RECOG_DEBUG(
+        FACE_RECOG_DEBUG(
+            for (size_t i = 0; i < currentTracks.size(); ++i)
                 if (currentTracks[i].isValidatedEyeDetection() || !conf->useEyesDetection)
                     logOutBBox << currentFrameLabel << " " << util::rectPointCoordinates(currentTracks[i].bbox(), " ") << std::endl;
-            );
-        }
-        logResult << std::endl; // move to next line for future results to output (next frame)
+        );
 
         //----------------------------------------------------------------------------------------------------------------------------------------
         // PLOT DISPLAY
         //----------------------------------------------------------------------------------------------------------------------------------------
-        if (conf->displayPlots && conf->useFaceRecognition)
+        if (conf->displayPlots && conf->useFaceRecognition && !skipOutputs)
         {
             size_t nTracks = MIN(currentTracks.size(), (size_t)conf->plotMaxTracks);
             for (size_t idx = 0; idx < nTracks; ++idx) {
@@ -1212,9 +659,11 @@ int main(int argc, char *argv[])
         //----------------------------------------------------------------------------------------------------------------------------------------
         // WRITE OUTPUT FRAMES
         //----------------------------------------------------------------------------------------------------------------------------------------
-        if (optArgI && conf->outputFrames) {
-            string imagePath = imgDir + "/" + currentFrameLabel + ".png";
-            cv::imwrite(imagePath, drawImg);
+        if (optArgI && conf->outputFrames && !skipOutputs) {
+            if (conf->outputFramesVideo)
+                outputWriter.writeVideoFrame(imgDir + "/frames.avi", drawImg);
+            else
+                outputWriter.writeImage(imgDir + "/" + currentFrameLabel + ".png", drawImg);
         }
 
         //----------------------------------------------------------------------------------------------------------------------------------------
@@ -1225,6 +674,7 @@ int main(int argc, char *argv[])
             cv::waitKey(1);     // Delay for frame rendering in window
         }
 
+        processor.addOutputTime(getDeltaTimePrecise(outputStartTime, MILLISECONDS));
         ++frameCounter;
     }   // end of main loop over frames
 
@@ -1232,18 +682,34 @@ int main(int argc, char *argv[])
     /* STATISTICS                                                                                                                               */
     /********************************************************************************************************************************************/
 
+    outputWriter.flush();
+    if (outputWriter.getDroppedCount() > 0)
+        logOutput << "Output images dropped: " << outputWriter.getDroppedCount() << " (written: " << outputWriter.getWrittenCount() << ")" << std::endl;
+
+    const LoadSheddingScheduler& loadShedding = processor.getLoadShedding();
+    if (loadShedding.isEnabled()) {
+        logOutput << "Load shedding escalations: " << loadShedding.getEscalations()
+                  << " (recoveries: " << loadShedding.getRecoveries() << ")" << std::endl;
+        for (int lvl = LoadSheddingScheduler::NONE; lvl < LoadSheddingScheduler::LEVEL_COUNT; ++lvl)
+            logOutput << "  frames at level " << LoadSheddingScheduler::levelName(lvl) << ": " << loadShedding.getLevelFrames(lvl) << std::endl;
+    }
+
     FACE_RECOG_DEBUG(
-        double dblTotalFrames = (double)frameCounter;
-        double avgTimeDetect = sumTimeDetect / (double)totalFramesDetect;
-        double avgTimeTrack = sumTimeTrack / dblTotalFrames;
-        double avgTimeDetectLocal = sumTimeDetectLocal / (double)totalFramesDetectLocal;
-        double avgTimeDetectPerFrame = sumTimeDetect / dblTotalFrames;
-        double avgTimeTrackPerFrame = sumTimeTrack / dblTotalFrames;
-
-        logTiming << "Number of frames in video: " << frameCounter << std::endl << setprecision(6);
+        const StreamStatistics& stats = processor.getStatistics();
+        double dblTotalFrames = (double)stats.totalFrames;
+        double avgTimeDetect = stats.sumTimeDetect / (double)stats.totalFramesDetect;
+        double avgTimeTrack = stats.sumTimeTrack / dblTotalFrames;
+        double avgTimeDetectLocal = stats.sumTimeDetectLocal / (double)stats.totalFramesDetectLocal;
+        double avgTimeDetectPerFrame = stats.sumTimeDetect / dblTotalFrames;
+        double avgTimeTrackPerFrame = stats.sumTimeTrack / dblTotalFrames;
+
+        logTiming << "Number of frames in video: " << stats.totalFrames << std::endl << setprecision(6);
         logTiming << "Average time per detection: " << avgTimeDetect << "ms" << std::endl;
+        logTiming << "Detections limited to moving regions: " << stats.totalFramesDetectRegions << "/" << stats.totalFramesDetect << std::endl;
         logTiming << "Average time per tracking: " << avgTimeTrack << "ms" << std::endl;
         logTiming << "Average time per local detection: " << avgTimeDetectLocal << "ms" << std::endl;
+        logTiming << "Recognition probes predicted: " << stats.totalProbes << " (skipped: " << stats.totalProbesSkipped << ")" << std::endl;
+        logTiming << "Frames processed with load shedding: " << stats.totalFramesShed << "/" << stats.totalFrames << std::endl;
         logTiming << "Average time per detection with respect to original video: " << avgTimeDetectPerFrame << "ms" << std::endl;
         logTiming << "Average time per tracking with respect to original video: " << avgTimeTrackPerFrame << "ms" << std::endl;
     );